@@ -1,17 +1,110 @@
 #include "pch.h"
 #include "AssetLoader.h"
-#include <filesystem>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
-void AssetLoader::LoadFBX(const string& File) noexcept
+#include <atomic>
+#include <thread>
+
+bool AssetLoader::LoadMesh(const string& FileName, Mesh& Result) noexcept
 {
+  // The post-processing steps are bit flags, so they have to be OR'd together
+  constexpr unsigned ImportFlags =
+    aiProcess_Triangulate |           // Polygons become triangles
+    aiProcess_JoinIdenticalVertices | // Index shared vertices instead of one per corner
+    aiProcess_GenSmoothNormals |      // Only generated where the file has none
+    aiProcess_PreTransformVertices |  // Bake the node transforms so the submeshes line up
+    aiProcess_SortByPType;            // Move points and lines into meshes of their own
+
   Assimp::Importer importer;
+  const aiScene* scene = importer.ReadFile(Paths::MODEL_PATH + FileName, ImportFlags);
+  if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || !scene->HasMeshes())
+  {
+    Log::Error("[AssetLoader] Could not import " + FileName + ": " + importer.GetErrorString());
+    return false;
+  }
+
+  // Only the triangle meshes are drawn. Texcoords are kept only if every one
+  // has them, otherwise they are generated for the whole mesh like for OBJ.
+  vector<const aiMesh*> meshes;
+  meshes.reserve(scene->mNumMeshes);
+  bool hasTexcoords = true;
+  for (unsigned i = 0u; i < scene->mNumMeshes; ++i)
+  {
+    const aiMesh* mesh = scene->mMeshes[i];
+    if (mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE)
+      continue;
+    meshes.push_back(mesh);
+    hasTexcoords = hasTexcoords && mesh->HasTextureCoords(0u);
+  }
+  if (meshes.empty())
+  {
+    Log::Error("[AssetLoader] No triangle meshes in " + FileName);
+    return false;
+  }
+
+  // Prefix-sum the element counts to find where each submesh lands
+  vector<size_t> vertexOffsets(meshes.size() + 1u, 0u);
+  vector<size_t> triangleOffsets(meshes.size() + 1u, 0u);
+  for (size_t i = 0u; i < meshes.size(); ++i)
+  {
+    vertexOffsets[i + 1u] = vertexOffsets[i] + meshes[i]->mNumVertices;
+    triangleOffsets[i + 1u] = triangleOffsets[i] + meshes[i]->mNumFaces;
+  }
+
+  Result.m_PositionArray.resize(vertexOffsets.back());
+  Result.m_VertexNormalArray.resize(vertexOffsets.back());
+  if (hasTexcoords)
+    Result.m_TexcoordArray.resize(vertexOffsets.back());
+  Result.m_TriangleArray.resize(triangleOffsets.back());
+
+  static_assert(sizeof(aiVector3D) == sizeof(vec3), "Positions and normals are copied as raw floats");
+
+  // Submeshes are independent, so each worker claims whole ones until none are
+  // left and copies them straight into their range of the arrays
+  std::atomic<size_t> nextMesh{ 0u };
+  const auto convert = [&]
+  {
+    for (size_t i = nextMesh++; i < meshes.size(); i = nextMesh++)
+    {
+      const aiMesh& mesh = *meshes[i];
+      const size_t vertexOffset = vertexOffsets[i];
+
+      memcpy(Result.m_PositionArray.data() + vertexOffset, mesh.mVertices, mesh.mNumVertices * sizeof(vec3));
+      memcpy(Result.m_VertexNormalArray.data() + vertexOffset, mesh.mNormals, mesh.mNumVertices * sizeof(vec3));
+
+      if (hasTexcoords)
+      {
+        vec2* texcoords = Result.m_TexcoordArray.data() + vertexOffset;
+        for (unsigned v = 0u; v < mesh.mNumVertices; ++v)
+          texcoords[v] = vec2(mesh.mTextureCoords[0][v].x, mesh.mTextureCoords[0][v].y);
+      }
+
+      // Submesh indices are local, shift them to where its vertices landed
+      const auto baseVertex = static_cast<unsigned>(vertexOffset);
+      Mesh::Triangle* triangles = Result.m_TriangleArray.data() + triangleOffsets[i];
+      for (unsigned f = 0u; f < mesh.mNumFaces; ++f)
+      {
+        const unsigned* indices = mesh.mFaces[f].mIndices;
+        triangles[f] = Mesh::Triangle(baseVertex + indices[0], baseVertex + indices[1], baseVertex + indices[2]);
+      }
+    }
+  };
+
+  const size_t workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), meshes.size());
+  vector<std::thread> workers;
+  workers.reserve(workerCount - 1u);
+  for (size_t i = 1u; i < workerCount; ++i)
+    workers.emplace_back(convert);
+  convert();
+  for (std::thread& worker : workers)
+    worker.join();
 
-  struct stat buffer{};
+  Result.SetNormalsAreCalculated(true);
+  Result.SetTexcoordsAreImported(hasTexcoords);
 
-  const aiScene* scene = importer.ReadFile(File.c_str(),
-    aiProcess_Triangulate &
-    aiProcess_GenNormals);
+  Log::Trace("[AssetLoader] " + FileName + ": " + std::to_string(meshes.size()) + " submeshes, " +
+    std::to_string(Result.GetVertexCount()) + " vertices, " + std::to_string(Result.GetTriangleCount()) + " triangles");
+  return true;
 }
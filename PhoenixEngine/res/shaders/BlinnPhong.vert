@@ -11,6 +11,8 @@ uniform mat4 vp_matrix;
 
 // Per Object
 uniform mat4 model_matrix;
+uniform vec3 position_offset; // Dequantization of packed positions, 0 and 1 for float meshes
+uniform vec3 position_scale;
 
 in layout(location = 0) vec3 position;  // Vertex position
 in layout(location = 1) vec3 normal;    // Vertex normal
@@ -23,7 +25,7 @@ out vec2 uv;              // Interpolated uv texture coordinate
 void main(void)
 {
   // Calculate the world position of the vertex
-  world_position = model_matrix * vec4(position, 1.f);
+  world_position = model_matrix * vec4(position_offset + position * position_scale, 1.f);
 
   // Calculate the world position of the normal
   world_normal = normalize(transpose(inverse(model_matrix)) * vec4(normal, 0));
@@ -1,4 +1,5 @@
 #pragma once
+#include "Mesh.h"
 
 class AssetLoader
 {
@@ -11,5 +12,12 @@ public:
   AssetLoader(AssetLoader&&) = delete;
   AssetLoader& operator=(AssetLoader&&) = delete;
 
-  static void LoadFBX(const string& File) noexcept;
+  /// <summary>
+  /// Imports a model through Assimp (FBX, glTF, ...) and packs every one of its
+  /// meshes into a single Mesh. Blocking, call it from a loader thread.
+  /// </summary>
+  /// <param name="FileName">File name of the model, relative to the model directory</param>
+  /// <param name="Result">[Out] Mesh to fill, expected to be empty</param>
+  /// <returns>[T/F] The file was imported and contained at least one triangle</returns>
+  static bool LoadMesh(const string& FileName, Mesh& Result) noexcept;
 };
@@ -0,0 +1,502 @@
+//------------------------------------------------------------------------------
+// File:    OBJBenchmark.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Headless benchmark of every OBJ read method and the mesh
+//          post-processing, on a synthetic corpus and the models in res/models,
+//          and of the UV projection kernels
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "OBJReader.h"
+#include "MeshPostProcess.h"
+#include "MemoryStats.h"
+#include "MeshKernels.h"
+#include "SyntheticOBJ.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace
+{
+  // Synthetic corpus sizes, each written in every face format
+  constexpr size_t CorpusSizes[] = { 10'000u, 100'000u, 1'000'000u, 10'000'000u, 50'000'000u };
+
+  // OBJReader only reads from the model path, so the corpus lives below it
+  const string CorpusDirectory = "_bench/";
+
+  constexpr OBJReader::ReadMethod ReadMethods[] =
+  {
+    OBJReader::ReadMethod::LINE_BY_LINE,
+    OBJReader::ReadMethod::BLOCK_IO,
+    OBJReader::ReadMethod::MEMORY_MAPPED,
+    OBJReader::ReadMethod::PARALLEL,
+    OBJReader::ReadMethod::STREAMING
+  };
+
+  // Points the UV projection kernels are timed and checked on
+  constexpr size_t ProjectionPointCount = 1'000'000u;
+
+  constexpr UV::Generation Projections[] =
+  {
+    UV::Generation::PLANAR,
+    UV::Generation::SPHERICAL,
+    UV::Generation::CYLINDRICAL,
+    UV::Generation::CUBE_MAP
+  };
+
+  // The options every scene object is loaded with
+  constexpr MeshCache::Options PostProcessOptions = { true, true, UV::Generation::PLANAR, true, true, true, true, true, true };
+
+  struct Settings
+  {
+    size_t MaxTriangles = CorpusSizes[std::size(CorpusSizes) - 1u];
+    string OutPath;
+    bool KeepCorpus = false;
+    bool IncludeSynthetic = true;
+    bool IncludeModels = true;
+    bool IncludeProjections = true;
+  };
+
+  const char* getMethodName(const OBJReader::ReadMethod method) noexcept
+  {
+    switch (method)
+    {
+    case OBJReader::ReadMethod::LINE_BY_LINE:  return "LINE_BY_LINE";
+    case OBJReader::ReadMethod::BLOCK_IO:      return "BLOCK_IO";
+    case OBJReader::ReadMethod::MEMORY_MAPPED: return "MEMORY_MAPPED";
+    case OBJReader::ReadMethod::PARALLEL:      return "PARALLEL";
+    case OBJReader::ReadMethod::STREAMING:     return "STREAMING";
+    default:                                   return "UNKNOWN";
+    }
+  }
+
+  // File name friendly version of SyntheticOBJ::GetFaceFormatName
+  const char* getFaceFormatTag(const SyntheticOBJ::FaceFormat format) noexcept
+  {
+    switch (format)
+    {
+    case SyntheticOBJ::FaceFormat::POSITION:          return "v";
+    case SyntheticOBJ::FaceFormat::POSITION_TEXCOORD: return "v_vt";
+    case SyntheticOBJ::FaceFormat::POSITION_NORMAL:   return "v_vn";
+    case SyntheticOBJ::FaceFormat::FULL:              return "v_vt_vn";
+    case SyntheticOBJ::FaceFormat::FULL_RELATIVE:     return "rel_v_vt_vn";
+    default:                                          return "unknown";
+    }
+  }
+
+  const char* getProjectionName(const UV::Generation generation) noexcept
+  {
+    switch (generation)
+    {
+    case UV::Generation::PLANAR:      return "planar";
+    case UV::Generation::SPHERICAL:   return "spherical";
+    case UV::Generation::CYLINDRICAL: return "cylindrical";
+    case UV::Generation::CUBE_MAP:    return "cube_map";
+    default:                          return "custom";
+    }
+  }
+
+  string quoteJSON(const string& text)
+  {
+    string quoted = "\"";
+    for (const char c : text)
+    {
+      if (c == '"' || c == '\\')
+        quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+
+  double millisecondsSince(const std::chrono::high_resolution_clock::time_point& startTime) noexcept
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+  }
+
+  /// <summary>
+  /// Reads and post-processes one file in this process and prints the
+  /// measurements as a single JSON line. Runs in a child process per case so
+  /// the peak memory and allocation counts belong to that case alone.
+  /// </summary>
+  int runCase(const string& fileName, const OBJReader::ReadMethod method)
+  {
+    std::error_code error;
+    const uintmax_t fileBytes = std::filesystem::file_size(Paths::MODEL_PATH + fileName, error);
+    if (error)
+      return 1;
+
+    const size_t allocationsBefore = MemoryStats::GetAllocationCount();
+
+    Mesh mesh;
+    OBJReader reader;
+    const auto readStart = std::chrono::high_resolution_clock::now();
+    reader.ReadOBJFile(fileName, &mesh, method, false);
+    const double readMs = millisecondsSince(readStart);
+    if (mesh.GetTriangleCount() == 0u)
+      return 1;
+
+    MeshPostProcess::PhaseTimings phases;
+    const auto postProcessStart = std::chrono::high_resolution_clock::now();
+    MeshPostProcess::Apply(mesh, PostProcessOptions, &phases);
+    const double postProcessMs = millisecondsSince(postProcessStart);
+
+    const size_t allocations = MemoryStats::GetAllocationCount() - allocationsBefore;
+    const double readSeconds = std::max(readMs, 1e-6) / 1000.0;
+
+    stringstream json;
+    json << "{\"method\":" << quoteJSON(getMethodName(method))
+      << ",\"vertices\":" << mesh.GetVertexCount()
+      << ",\"triangles\":" << mesh.GetTriangleCount()
+      << ",\"mb_per_s\":" << static_cast<double>(fileBytes) / (1024.0 * 1024.0) / readSeconds
+      << ",\"triangles_per_s\":" << static_cast<double>(mesh.GetTriangleCount()) / readSeconds
+      << ",\"phases_ms\":{\"read\":" << readMs
+      << ",\"weld\":" << phases.WeldMs
+      << ",\"optimize\":" << phases.OptimizeMs
+      << ",\"bounds\":" << phases.BoundsMs
+      << ",\"normals\":" << phases.NormalsMs
+      << ",\"assemble\":" << phases.AssembleMs
+      << ",\"volumes\":" << phases.VolumesMs
+      << ",\"tangents\":" << phases.TangentMs
+      << ",\"meshlets\":" << phases.MeshletMs
+      << ",\"quantize\":" << phases.QuantizeMs
+      << ",\"lod\":" << phases.LodMs
+      << ",\"post_process\":" << postProcessMs
+      << ",\"total\":" << readMs + postProcessMs
+      << "},\"allocations\":" << allocations
+      << ",\"peak_resident_bytes\":" << MemoryStats::GetPeakResidentBytes()
+      << "}";
+
+    // Log output shares stdout, so the measurements go on a line of their own
+    std::cout << '\n' << json.str() << std::endl;
+    return 0;
+  }
+
+  /// <summary>
+  /// Projects a point exactly, in double precision with the standard library,
+  /// as the reference the kernels are measured against
+  /// </summary>
+  glm::dvec2 projectExactly(const vec3& position, const UV::Generation generation,
+    const vec3& min, const vec3& center, const vec3& inverseSize) noexcept
+  {
+    const glm::dvec3 p(position);
+    const glm::dvec3 d = p - glm::dvec3(center);
+    const double pi = 3.14159265358979323846;
+    switch (generation)
+    {
+    case UV::Generation::PLANAR:
+      return { (p.x - min.x) * inverseSize.x, (p.y - min.y) * inverseSize.y };
+    case UV::Generation::SPHERICAL:
+    case UV::Generation::CYLINDRICAL:
+    {
+      double theta = std::atan2(d.z, d.x);
+      if (theta < 0.0)
+        theta += 2.0 * pi;
+      const double length = glm::length(d);
+      const double v = generation == UV::Generation::SPHERICAL ?
+        (length > 0.0 ? 1.0 - std::acos(d.y / length) / pi : 1.0) :
+        (p.y - min.y) * inverseSize.y;
+      return { theta / (2.0 * pi), v };
+    }
+    case UV::Generation::CUBE_MAP:
+    {
+      const glm::dvec3 b = d * glm::dvec3(inverseSize);
+      const glm::dvec3 a = glm::abs(b);
+      double major, s, t, column, row;
+      if (a.x >= a.y && a.x >= a.z)
+      {
+        major = a.x; s = b.x >= 0.0 ? -b.z : b.z; t = b.y; column = b.x >= 0.0 ? 0.0 : 1.0; row = 0.0;
+      }
+      else if (a.y >= a.z)
+      {
+        major = a.y; s = b.x; t = b.y >= 0.0 ? -b.z : b.z; column = b.y >= 0.0 ? 2.0 : 0.0; row = b.y >= 0.0 ? 0.0 : 1.0;
+      }
+      else
+      {
+        major = a.z; s = b.z >= 0.0 ? b.x : -b.x; t = b.y; column = b.z >= 0.0 ? 1.0 : 2.0; row = 1.0;
+      }
+      const double scale = major > 0.0 ? 0.5 / major : 0.0;
+      return { (column + 0.5 + s * scale) / 3.0, (row + 0.5 + t * scale) / 2.0 };
+    }
+    default:
+      return { 0.0, 0.0 };
+    }
+  }
+
+  /// <summary>
+  /// Times every UV projection with each instruction set the CPU has, and with
+  /// the standard library's atan2 and acos for comparison, over a noisy sphere.
+  /// Each run is checked against the exact projection.
+  /// </summary>
+  void benchmarkProjections(vector<string>& results)
+  {
+    std::mt19937 random(1234u);
+    std::normal_distribution<float> normal(0.f, 1.f);
+    std::uniform_real_distribution<float> radius(0.9f, 1.1f);
+    vector<vec3> positions(ProjectionPointCount);
+    for (vec3& position : positions)
+    {
+      const vec3 direction(normal(random), normal(random), normal(random));
+      const float length = glm::length(direction);
+      position = length > 0.f ? direction * (radius(random) / length) : vec3(0.f);
+    }
+
+    vec3 min, max;
+    MeshKernels::CalculateBounds(positions.data(), positions.size(), min, max);
+    const vec3 center = (min + max) * 0.5f;
+    const vec3 inverseSize = 1.f / (max - min);
+
+    const MeshKernels::InstructionSet supported = MeshKernels::GetInstructionSet();
+    vector<vec2> texcoords(positions.size());
+    vector<glm::dvec2> reference(positions.size());
+
+    // The libm row is the per-vertex atan2 and acos the kernels replace
+    const auto projectWithLibm = [&](const UV::Generation generation)
+    {
+      const float twoPi = 6.28318531f;
+      const float pi = 3.14159265f;
+      for (size_t i = 0u; i < positions.size(); ++i)
+      {
+        const vec3 d = positions[i] - center;
+        float theta = std::atan2(d.z, d.x);
+        theta = theta < 0.f ? theta + twoPi : theta;
+        const float length = glm::length(d);
+        const float v = generation == UV::Generation::SPHERICAL ?
+          (length > 0.f ? 1.f - std::acos(d.y / length) / pi : 1.f) :
+          (positions[i].y - min.y) * inverseSize.y;
+        texcoords[i] = vec2(theta / twoPi, v);
+      }
+    };
+
+    for (const UV::Generation generation : Projections)
+    {
+      for (size_t i = 0u; i < positions.size(); ++i)
+        reference[i] = projectExactly(positions[i], generation, min, center, inverseSize);
+
+      const bool isAngular = generation == UV::Generation::SPHERICAL || generation == UV::Generation::CYLINDRICAL;
+      for (int set = -1; set <= static_cast<int>(supported); ++set)
+      {
+        const bool useLibm = set < 0;
+        if (useLibm && !isAngular)
+          continue;
+        if (!useLibm)
+          MeshKernels::SetInstructionSet(static_cast<MeshKernels::InstructionSet>(set));
+
+        // Best of a few runs, the first also warms the caches
+        double bestMs = std::numeric_limits<double>::max();
+        for (int run = 0; run < 5; ++run)
+        {
+          const auto start = std::chrono::high_resolution_clock::now();
+          if (useLibm)
+            projectWithLibm(generation);
+          else
+            MeshKernels::ProjectTexcoords(positions.data(), positions.size(), generation, min, center, inverseSize, texcoords.data());
+          bestMs = std::min(bestMs, millisecondsSince(start));
+        }
+
+        // U wraps around at the seam, so 0 and 1 are the same place there
+        double maxError = 0.0;
+        for (size_t i = 0u; i < positions.size(); ++i)
+        {
+          double uError = std::abs(static_cast<double>(texcoords[i].x) - reference[i].x);
+          if (isAngular)
+            uError = std::min(uError, 1.0 - uError);
+          const double vError = std::abs(static_cast<double>(texcoords[i].y) - reference[i].y);
+          maxError = std::max(maxError, std::max(uError, vError));
+        }
+
+        stringstream json;
+        json << "{\"projection\":" << quoteJSON(getProjectionName(generation))
+          << ",\"instruction_set\":" << quoteJSON(useLibm ? "LIBM" :
+            MeshKernels::GetInstructionSetName(static_cast<MeshKernels::InstructionSet>(set)))
+          << ",\"vertices\":" << positions.size()
+          << ",\"ms\":" << bestMs
+          << ",\"vertices_per_s\":" << static_cast<double>(positions.size()) / (std::max(bestMs, 1e-6) / 1000.0)
+          << ",\"max_error\":" << maxError
+          << ",\"within_bound\":" << (useLibm || maxError <= MeshKernels::TEXCOORD_PROJECTION_ERROR ? "true" : "false")
+          << "}";
+        results.push_back(json.str());
+      }
+    }
+    MeshKernels::SetInstructionSet(supported);
+  }
+
+  /// <summary>
+  /// Benchmarks one file with every read method, each in its own child process
+  /// </summary>
+  void benchmarkFile(const string& executable, const string& fileName, const string& source,
+    const string& faceFormat, vector<string>& results)
+  {
+    std::error_code error;
+    const uintmax_t fileBytes = std::filesystem::file_size(Paths::MODEL_PATH + fileName, error);
+
+    for (const OBJReader::ReadMethod method : ReadMethods)
+    {
+      std::cerr << "  " << fileName << " [" << getMethodName(method) << "]" << std::endl;
+
+      string command = "\"" + executable + "\" --case \"" + fileName + "\" " +
+        std::to_string(static_cast<int>(method));
+#ifdef _WIN32
+      // cmd.exe strips the outer quotes when the command itself starts with one
+      command = "\"" + command + "\"";
+#endif
+
+      string output;
+      int status = -1;
+      if (FILE* child = popen(command.c_str(), "r"))
+      {
+        char buffer[4096];
+        while (fgets(buffer, sizeof(buffer), child))
+          output += buffer;
+        status = pclose(child);
+      }
+
+      // The measurements are the last line that is a JSON object
+      string measurement;
+      stringstream lines(output);
+      for (string line; std::getline(lines, line);)
+      {
+        if (!line.empty() && line.front() == '{')
+          measurement = line;
+      }
+
+      string entry = "{\"file\":" + quoteJSON(fileName) +
+        ",\"source\":" + quoteJSON(source) +
+        ",\"face_format\":" + quoteJSON(faceFormat) +
+        ",\"file_bytes\":" + std::to_string(fileBytes);
+      if (status == 0 && !measurement.empty())
+        entry += "," + measurement.substr(1u);
+      else
+        entry += ",\"method\":" + quoteJSON(getMethodName(method)) + ",\"error\":\"read failed\"}";
+      results.push_back(std::move(entry));
+    }
+  }
+
+  void printUsage()
+  {
+    std::cerr <<
+      "Usage: OBJBenchmark [options]\n"
+      "  --out <file>            Write the JSON report to a file instead of stdout\n"
+      "  --max-triangles <n>     Skip synthetic files larger than n triangles (default 50000000)\n"
+      "  --keep-corpus           Keep the generated files in " << Paths::MODEL_PATH << CorpusDirectory << "\n"
+      "  --no-synthetic          Only benchmark the models in " << Paths::MODEL_PATH << "\n"
+      "  --no-models             Only benchmark the synthetic corpus\n"
+      "  --no-uv                 Skip the UV projection kernels\n";
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  // Only errors, the progress goes to stderr and the report to stdout
+  Log::Logger::Instance().SetLevel(Log::Logger::LogLevel::Error);
+
+  if (argc == 4 && string(argv[1]) == "--case")
+    return runCase(argv[2], static_cast<OBJReader::ReadMethod>(std::stoi(argv[3])));
+
+  Settings settings;
+  for (int i = 1; i < argc; ++i)
+  {
+    const string arg = argv[i];
+    if (arg == "--out" && i + 1 < argc)
+      settings.OutPath = argv[++i];
+    else if (arg == "--max-triangles" && i + 1 < argc)
+      settings.MaxTriangles = std::stoull(argv[++i]);
+    else if (arg == "--keep-corpus")
+      settings.KeepCorpus = true;
+    else if (arg == "--no-synthetic")
+      settings.IncludeSynthetic = false;
+    else if (arg == "--no-models")
+      settings.IncludeModels = false;
+    else if (arg == "--no-uv")
+      settings.IncludeProjections = false;
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+
+  const string executable = argv[0];
+  vector<string> results;
+
+  if (settings.IncludeSynthetic)
+  {
+    std::filesystem::create_directories(Paths::MODEL_PATH + CorpusDirectory);
+    for (const size_t triangles : CorpusSizes)
+    {
+      if (triangles > settings.MaxTriangles)
+        break;
+
+      for (int f = 0; f < static_cast<int>(SyntheticOBJ::FaceFormat::COUNT); ++f)
+      {
+        const auto format = static_cast<SyntheticOBJ::FaceFormat>(f);
+        const string fileName = CorpusDirectory + "grid_" + std::to_string(triangles) + "_" + getFaceFormatTag(format) + ".obj";
+        const string path = Paths::MODEL_PATH + fileName;
+
+        if (!std::filesystem::exists(path))
+        {
+          std::cerr << "Generating " << path << std::endl;
+          if (!SyntheticOBJ::Write(path, triangles, format))
+          {
+            Log::Error("Could not generate " + path);
+            continue;
+          }
+        }
+
+        benchmarkFile(executable, fileName, "synthetic", SyntheticOBJ::GetFaceFormatName(format), results);
+
+        // The largest files run to gigabytes, only one is kept around at a time
+        if (!settings.KeepCorpus)
+          std::filesystem::remove(path);
+      }
+    }
+
+    if (!settings.KeepCorpus)
+      std::filesystem::remove(Paths::MODEL_PATH + CorpusDirectory);
+  }
+
+  if (settings.IncludeModels)
+  {
+    vector<string> models;
+    for (const auto& entry : std::filesystem::directory_iterator(Paths::MODEL_PATH))
+    {
+      if (entry.is_regular_file() && entry.path().extension() == ".obj")
+        models.push_back(entry.path().filename().string());
+    }
+    std::sort(models.begin(), models.end());
+
+    for (const string& model : models)
+      benchmarkFile(executable, model, "model", "", results);
+  }
+
+  vector<string> projectionResults;
+  if (settings.IncludeProjections)
+  {
+    std::cerr << "  UV projections" << std::endl;
+    benchmarkProjections(projectionResults);
+  }
+
+  std::ofstream outFile;
+  if (!settings.OutPath.empty())
+    outFile.open(settings.OutPath, std::ios::trunc);
+  std::ostream& out = outFile.is_open() ? outFile : std::cout;
+
+  out << "{\"hardware_threads\":" << std::thread::hardware_concurrency()
+    << ",\"instruction_set\":\"" << MeshKernels::GetInstructionSetName(MeshKernels::GetInstructionSet())
+    << "\",\"results\":[\n";
+  for (size_t i = 0u; i < results.size(); ++i)
+    out << "  " << results[i] << (i + 1u < results.size() ? ",\n" : "\n");
+  out << "],\"uv_projection\":[\n";
+  for (size_t i = 0u; i < projectionResults.size(); ++i)
+    out << "  " << projectionResults[i] << (i + 1u < projectionResults.size() ? ",\n" : "\n");
+  out << "]}" << std::endl;
+
+  return 0;
+}
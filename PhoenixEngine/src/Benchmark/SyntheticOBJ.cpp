@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+// File:    SyntheticOBJ.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Writes procedural OBJ files of a given size for benchmarking
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "SyntheticOBJ.h"
+#include "GraphicsCommon.h"
+#include <glm/gtc/constants.hpp>
+
+#include <charconv>
+#include <cmath>
+
+namespace
+{
+  // Gathers records in a large buffer so a multi-gigabyte file isn't written a line at a time
+  class RecordWriter
+  {
+  public:
+    static constexpr size_t BUFFER_SIZE = 4u * 1024u * 1024u;
+    static constexpr size_t MAX_RECORD = 256u; // Longer than any single record
+
+    RecordWriter(const string& path) :
+      m_File(path, std::ios::binary | std::ios::trunc),
+      m_Buffer(BUFFER_SIZE),
+      m_Used(0u)
+    {}
+
+    ~RecordWriter() { Flush(); }
+
+    bool IsOpen() const { return m_File.is_open(); }
+    bool IsGood() const { return m_File.good(); }
+
+    void Flush()
+    {
+      m_File.write(m_Buffer.data(), static_cast<std::streamsize>(m_Used));
+      m_Used = 0u;
+    }
+
+    void Text(const char* text)
+    {
+      reserve();
+      const size_t length = strlen(text);
+      memcpy(m_Buffer.data() + m_Used, text, length);
+      m_Used += length;
+    }
+
+    void Char(const char c)
+    {
+      m_Buffer[m_Used++] = c;
+    }
+
+    void Float(const float value)
+    {
+      const auto result = std::to_chars(m_Buffer.data() + m_Used, m_Buffer.data() + m_Buffer.size(),
+        value, std::chars_format::fixed, 6);
+      m_Used = static_cast<size_t>(result.ptr - m_Buffer.data());
+    }
+
+    void Integer(const long long value)
+    {
+      const auto result = std::to_chars(m_Buffer.data() + m_Used, m_Buffer.data() + m_Buffer.size(), value);
+      m_Used = static_cast<size_t>(result.ptr - m_Buffer.data());
+    }
+
+  private:
+    std::ofstream m_File;
+    vector<char> m_Buffer;
+    size_t m_Used;
+
+    // Every record starts with Text, so checking there keeps a full record in bounds
+    void reserve()
+    {
+      if (m_Used + MAX_RECORD > m_Buffer.size())
+        Flush();
+    }
+  };
+
+  // A gentle wave over the unit square, so normals and bounds aren't trivial
+  constexpr float Frequency = 4.f * glm::pi<float>();
+  constexpr float Amplitude = 0.05f;
+
+  float height(const float x, const float z) noexcept
+  {
+    return Amplitude * sinf(x * Frequency) * cosf(z * Frequency);
+  }
+
+  vec3 normal(const float x, const float z) noexcept
+  {
+    const float dx = Amplitude * Frequency * cosf(x * Frequency) * cosf(z * Frequency);
+    const float dz = -Amplitude * Frequency * sinf(x * Frequency) * sinf(z * Frequency);
+    return glm::normalize(vec3(-dx, 1.f, -dz));
+  }
+}
+
+const char* SyntheticOBJ::GetFaceFormatName(const FaceFormat format) noexcept
+{
+  switch (format)
+  {
+  case FaceFormat::POSITION:          return "v";
+  case FaceFormat::POSITION_TEXCOORD: return "v/vt";
+  case FaceFormat::POSITION_NORMAL:   return "v//vn";
+  case FaceFormat::FULL:              return "v/vt/vn";
+  case FaceFormat::FULL_RELATIVE:     return "-v/-vt/-vn";
+  default:                            return "unknown";
+  }
+}
+
+bool SyntheticOBJ::Write(const string& path, const size_t triangleCount, const FaceFormat format) noexcept
+{
+  if (triangleCount == 0u)
+    return false;
+
+  RecordWriter writer(path);
+  if (!writer.IsOpen())
+  {
+    Log::Error("[SyntheticOBJ] Could not create " + path);
+    return false;
+  }
+
+  // Two triangles per cell, the last row is only as full as it needs to be
+  const size_t columns = std::max<size_t>(1u, static_cast<size_t>(std::sqrt(triangleCount / 2.0)));
+  const size_t rows = (triangleCount + 2u * columns - 1u) / (2u * columns);
+  const size_t rowLength = columns + 1u;
+  const size_t vertexCount = rowLength * (rows + 1u);
+
+  const bool writeTexcoords = format == FaceFormat::POSITION_TEXCOORD ||
+    format == FaceFormat::FULL || format == FaceFormat::FULL_RELATIVE;
+  const bool writeNormals = format == FaceFormat::POSITION_NORMAL ||
+    format == FaceFormat::FULL || format == FaceFormat::FULL_RELATIVE;
+
+  writer.Text("# Synthetic grid: ");
+  writer.Integer(static_cast<long long>(triangleCount));
+  writer.Text(" triangles, ");
+  writer.Text(GetFaceFormatName(format));
+  writer.Char('\n');
+
+  for (size_t r = 0u; r <= rows; ++r)
+  {
+    const float z = static_cast<float>(r) / static_cast<float>(rows);
+    for (size_t c = 0u; c <= columns; ++c)
+    {
+      const float x = static_cast<float>(c) / static_cast<float>(columns);
+      writer.Text("v ");
+      writer.Float(x);
+      writer.Char(' ');
+      writer.Float(height(x, z));
+      writer.Char(' ');
+      writer.Float(z);
+      writer.Char('\n');
+    }
+  }
+
+  if (writeTexcoords)
+  {
+    for (size_t r = 0u; r <= rows; ++r)
+    {
+      for (size_t c = 0u; c <= columns; ++c)
+      {
+        writer.Text("vt ");
+        writer.Float(static_cast<float>(c) / static_cast<float>(columns));
+        writer.Char(' ');
+        writer.Float(static_cast<float>(r) / static_cast<float>(rows));
+        writer.Char('\n');
+      }
+    }
+  }
+
+  if (writeNormals)
+  {
+    for (size_t r = 0u; r <= rows; ++r)
+    {
+      const float z = static_cast<float>(r) / static_cast<float>(rows);
+      for (size_t c = 0u; c <= columns; ++c)
+      {
+        const vec3 n = normal(static_cast<float>(c) / static_cast<float>(columns), z);
+        writer.Text("vn ");
+        writer.Float(n.x);
+        writer.Char(' ');
+        writer.Float(n.y);
+        writer.Char(' ');
+        writer.Float(n.z);
+        writer.Char('\n');
+      }
+    }
+  }
+
+  // Every stream has one element per grid vertex, so a corner uses the same
+  // index for all of them. Relative indices count back from the end of it.
+  const auto writeCorner = [&](const size_t vertex)
+  {
+    const long long index = (format == FaceFormat::FULL_RELATIVE) ?
+      static_cast<long long>(vertex) - static_cast<long long>(vertexCount) :
+      static_cast<long long>(vertex) + 1;
+
+    writer.Char(' ');
+    writer.Integer(index);
+    if (format == FaceFormat::POSITION)
+      return;
+    writer.Char('/');
+    if (writeTexcoords)
+      writer.Integer(index);
+    if (!writeNormals)
+      return;
+    writer.Char('/');
+    writer.Integer(index);
+  };
+
+  size_t written = 0u;
+  for (size_t r = 0u; r < rows && written < triangleCount; ++r)
+  {
+    for (size_t c = 0u; c < columns && written < triangleCount; ++c)
+    {
+      const size_t v00 = r * rowLength + c;
+      const size_t v01 = v00 + 1u;
+      const size_t v10 = v00 + rowLength;
+      const size_t v11 = v10 + 1u;
+
+      writer.Text("f");
+      writeCorner(v00);
+      writeCorner(v10);
+      writeCorner(v01);
+      writer.Char('\n');
+      if (++written == triangleCount)
+        break;
+
+      writer.Text("f");
+      writeCorner(v01);
+      writeCorner(v10);
+      writeCorner(v11);
+      writer.Char('\n');
+      ++written;
+    }
+  }
+
+  writer.Flush();
+  return writer.IsGood();
+}
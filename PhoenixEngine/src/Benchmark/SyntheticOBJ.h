@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+// File:    SyntheticOBJ.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Writes procedural OBJ files of a given size for benchmarking
+//------------------------------------------------------------------------------
+#pragma once
+
+namespace SyntheticOBJ
+{
+  /// <summary>
+  /// The corner layout written on each face record
+  /// </summary>
+  enum class FaceFormat
+  {
+    POSITION,           // f 1 2 3
+    POSITION_TEXCOORD,  // f 1/1 2/2 3/3
+    POSITION_NORMAL,    // f 1//1 2//2 3//3
+    FULL,               // f 1/1/1 2/2/2 3/3/3
+    FULL_RELATIVE,      // f -3/-3/-3 -2/-2/-2 -1/-1/-1
+    COUNT
+  };
+
+  /// <summary>
+  /// Gets the name a face format is reported under
+  /// </summary>
+  /// <param name="format">The face format</param>
+  /// <returns>A short name, e.g. "v/vt/vn"</returns>
+  const char* GetFaceFormatName(FaceFormat format) noexcept;
+
+  /// <summary>
+  /// Writes a displaced grid with exactly the requested number of triangles.
+  /// Texcoord and normal records are only written if the face format uses them.
+  /// </summary>
+  /// <param name="path">Path of the file to write</param>
+  /// <param name="triangleCount">Number of triangles in the file</param>
+  /// <param name="format">Corner layout of the face records</param>
+  /// <returns>[T/F] The file was written completely</returns>
+  bool Write(const string& path, size_t triangleCount, FaceFormat format) noexcept;
+}
@@ -0,0 +1,330 @@
+//------------------------------------------------------------------------------
+// File:    BoundsFitter.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Fits bounding spheres and oriented boxes around meshes
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "BoundsFitter.h"
+
+namespace
+{
+  using glm::dvec3;
+
+  // Spheres are fitted in double, the seed points are few and their circumspheres ill conditioned
+  struct Sphere
+  {
+    dvec3 Center;
+    double Radius;  // Negative for the empty sphere
+  };
+
+  // The axes, the cube diagonals and the edge diagonals. The extreme points
+  // along them are close to the ones the smallest sphere touches.
+  const std::array<vec3, 13> SEED_DIRECTIONS = {
+    vec3(1.f, 0.f, 0.f), vec3(0.f, 1.f, 0.f), vec3(0.f, 0.f, 1.f),
+    vec3(1.f, 1.f, 1.f), vec3(1.f, 1.f, -1.f), vec3(1.f, -1.f, 1.f), vec3(1.f, -1.f, -1.f),
+    vec3(1.f, 1.f, 0.f), vec3(1.f, -1.f, 0.f), vec3(1.f, 0.f, 1.f), vec3(1.f, 0.f, -1.f),
+    vec3(0.f, 1.f, 1.f), vec3(0.f, 1.f, -1.f) };
+
+  bool contains(const Sphere& sphere, const dvec3& point) noexcept
+  {
+    return glm::length(point - sphere.Center) <= sphere.Radius * (1.0 + 1e-9) + 1e-12;
+  }
+
+  // Grows the sphere just enough to take in the point, keeping everything it held (Ritter 1990)
+  void grow(Sphere& sphere, const dvec3& point) noexcept
+  {
+    const double distance = glm::length(point - sphere.Center);
+    if (distance <= sphere.Radius)
+      return;
+    const double radius = 0.5 * (sphere.Radius + distance);
+    sphere.Center += (radius - sphere.Radius) / distance * (point - sphere.Center);
+    sphere.Radius = radius;
+  }
+
+  // Smallest sphere with every point on its surface. Degenerate sets, where
+  // the points are collinear or coplanar, fall back to a sphere that holds them.
+  Sphere sphereThrough(const dvec3* points, const unsigned count) noexcept
+  {
+    switch (count)
+    {
+    case 0u:
+      return Sphere{ dvec3(0.0), -1.0 };
+    case 1u:
+      return Sphere{ points[0], 0.0 };
+    case 2u:
+      return Sphere{ 0.5 * (points[0] + points[1]), 0.5 * glm::length(points[1] - points[0]) };
+    case 3u:
+    {
+      const dvec3 a = points[1] - points[0];
+      const dvec3 b = points[2] - points[0];
+      const dvec3 normal = cross(a, b);
+      const double denominator = 2.0 * dot(normal, normal);
+      if (denominator <= 1e-12 * dot(a, a) * dot(b, b))
+      {
+        // Collinear, the two farthest apart span the other
+        Sphere sphere = sphereThrough(points, 2u);
+        grow(sphere, points[2]);
+        return sphere;
+      }
+      const dvec3 offset = (dot(b, b) * cross(normal, a) + dot(a, a) * cross(b, normal)) / denominator;
+      return Sphere{ points[0] + offset, glm::length(offset) };
+    }
+    default:
+    {
+      const dvec3 a = points[1] - points[0];
+      const dvec3 b = points[2] - points[0];
+      const dvec3 c = points[3] - points[0];
+      const double denominator = 2.0 * dot(a, cross(b, c));
+      const double scale = glm::length(a) * glm::length(b) * glm::length(c);
+      if (std::abs(denominator) <= 1e-9 * scale)
+      {
+        // Coplanar, the circle through three of them grows to take in the fourth
+        Sphere sphere = sphereThrough(points, 3u);
+        grow(sphere, points[3]);
+        return sphere;
+      }
+      const dvec3 offset = (dot(a, a) * cross(b, c) + dot(b, b) * cross(c, a) + dot(c, c) * cross(a, b)) / denominator;
+      return Sphere{ points[0] + offset, glm::length(offset) };
+    }
+    }
+  }
+
+  // Smallest sphere around the first count points with the support points on
+  // its surface (Welzl 1991). Only ever sees the seed points, so the recursion stays shallow.
+  Sphere welzl(const vector<dvec3>& points, const size_t count, std::array<dvec3, 4>& support,
+    const unsigned supportCount) noexcept
+  {
+    if (count == 0u || supportCount == 4u)
+      return sphereThrough(support.data(), supportCount);
+
+    const dvec3& point = points[count - 1u];
+    const Sphere sphere = welzl(points, count - 1u, support, supportCount);
+    if (contains(sphere, point))
+      return sphere;
+
+    support[supportCount] = point;
+    return welzl(points, count - 1u, support, supportCount + 1u);
+  }
+
+  // Eigenvectors of a symmetric 3x3 matrix by cyclic Jacobi rotations, as the
+  // columns of vectors, with the eigenvalues left on the diagonal of matrix
+  void jacobiEigen(double matrix[3][3], double vectors[3][3]) noexcept
+  {
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+      for (unsigned j = 0u; j < 3u; ++j)
+        vectors[i][j] = i == j ? 1.0 : 0.0;
+    }
+
+    const double scale = std::abs(matrix[0][0]) + std::abs(matrix[1][1]) + std::abs(matrix[2][2]);
+    for (unsigned sweep = 0u; sweep < 32u; ++sweep)
+    {
+      const double offDiagonal = std::abs(matrix[0][1]) + std::abs(matrix[0][2]) + std::abs(matrix[1][2]);
+      if (offDiagonal <= 1e-15 * scale)
+        return;
+
+      for (const auto& [p, q] : { std::pair{ 0u, 1u }, std::pair{ 0u, 2u }, std::pair{ 1u, 2u } })
+      {
+        if (matrix[p][q] == 0.0)
+          continue;
+
+        // Rotation in the pq plane that zeroes matrix[p][q]
+        const double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * matrix[p][q]);
+        const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+        const double c = 1.0 / std::sqrt(t * t + 1.0);
+        const double s = t * c;
+
+        for (unsigned k = 0u; k < 3u; ++k)
+        {
+          const double kp = matrix[k][p];
+          const double kq = matrix[k][q];
+          matrix[k][p] = c * kp - s * kq;
+          matrix[k][q] = s * kp + c * kq;
+        }
+        for (unsigned k = 0u; k < 3u; ++k)
+        {
+          const double pk = matrix[p][k];
+          const double qk = matrix[q][k];
+          matrix[p][k] = c * pk - s * qk;
+          matrix[q][k] = s * pk + c * qk;
+        }
+        for (unsigned k = 0u; k < 3u; ++k)
+        {
+          const double kp = vectors[k][p];
+          const double kq = vectors[k][q];
+          vectors[k][p] = c * kp - s * kq;
+          vectors[k][q] = s * kp + c * kq;
+        }
+      }
+    }
+  }
+
+  // Covariance of the surface, each triangle weighted by its area (Gottschalk 1996),
+  // or of the points when there is no area. Returns false for an empty mesh.
+  bool covariance(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles, double result[3][3]) noexcept
+  {
+    double sums[3][3] = {};
+    dvec3 mean(0.0);
+    double weight = 0.0;
+
+    for (const Mesh::Triangle& tri : triangles)
+    {
+      const dvec3 p0(positions[tri.Index1]);
+      const dvec3 p1(positions[tri.Index2]);
+      const dvec3 p2(positions[tri.Index3]);
+      const double area = 0.5 * glm::length(cross(p1 - p0, p2 - p0));
+      if (area <= 0.0)
+        continue;
+
+      // Second moments of the triangle, uniform over its area
+      const dvec3 centroid = (p0 + p1 + p2) / 3.0;
+      for (unsigned i = 0u; i < 3u; ++i)
+      {
+        for (unsigned j = i; j < 3u; ++j)
+          sums[i][j] += area / 12.0 * (9.0 * centroid[i] * centroid[j] + p0[i] * p0[j] + p1[i] * p1[j] + p2[i] * p2[j]);
+      }
+      mean += area * centroid;
+      weight += area;
+    }
+
+    if (weight <= 0.0)
+    {
+      for (const vec3& position : positions)
+      {
+        const dvec3 p(position);
+        for (unsigned i = 0u; i < 3u; ++i)
+        {
+          for (unsigned j = i; j < 3u; ++j)
+            sums[i][j] += p[i] * p[j];
+        }
+        mean += p;
+      }
+      weight = static_cast<double>(positions.size());
+      if (weight <= 0.0)
+        return false;
+    }
+
+    mean /= weight;
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+      for (unsigned j = i; j < 3u; ++j)
+      {
+        result[i][j] = sums[i][j] / weight - mean[i] * mean[j];
+        result[j][i] = result[i][j];
+      }
+    }
+    return true;
+  }
+
+  // Box along the axes that holds every point
+  Mesh::OrientedBox fitAlongAxes(const vector<vec3>& positions, const vec3 (&axes)[3]) noexcept
+  {
+    vec3 low(std::numeric_limits<float>::max());
+    vec3 high(std::numeric_limits<float>::lowest());
+    for (const vec3& position : positions)
+    {
+      const vec3 projected(dot(position, axes[0]), dot(position, axes[1]), dot(position, axes[2]));
+      low = glm::min(low, projected);
+      high = glm::max(high, projected);
+    }
+
+    const vec3 middle = 0.5f * (low + high);
+    Mesh::OrientedBox result;
+    result.Center = middle.x * axes[0] + middle.y * axes[1] + middle.z * axes[2];
+    result.Axes[0] = axes[0];
+    result.Axes[1] = axes[1];
+    result.Axes[2] = axes[2];
+    result.HalfExtents = 0.5f * (high - low);
+    return result;
+  }
+
+  // Volume first, then surface area to choose between flat boxes
+  std::pair<float, float> boxSize(const vec3& halfExtents) noexcept
+  {
+    return {
+      halfExtents.x * halfExtents.y * halfExtents.z,
+      halfExtents.x * halfExtents.y + halfExtents.y * halfExtents.z + halfExtents.z * halfExtents.x };
+  }
+}
+
+Mesh::BoundingSphere BoundsFitter::FitSphere(const vector<vec3>& positions) noexcept
+{
+  Mesh::BoundingSphere result;
+  if (positions.empty())
+    return result;
+
+  // The extreme points along each seed direction
+  std::array<size_t, 2u * SEED_DIRECTIONS.size()> extremes = {};
+  std::array<float, 2u * SEED_DIRECTIONS.size()> extents;
+  for (size_t d = 0u; d < SEED_DIRECTIONS.size(); ++d)
+  {
+    extents[2u * d] = dot(positions[0], SEED_DIRECTIONS[d]);
+    extents[2u * d + 1u] = extents[2u * d];
+  }
+  for (size_t v = 1u; v < positions.size(); ++v)
+  {
+    for (size_t d = 0u; d < SEED_DIRECTIONS.size(); ++d)
+    {
+      const float extent = dot(positions[v], SEED_DIRECTIONS[d]);
+      if (extent < extents[2u * d])
+      {
+        extents[2u * d] = extent;
+        extremes[2u * d] = v;
+      }
+      else if (extent > extents[2u * d + 1u])
+      {
+        extents[2u * d + 1u] = extent;
+        extremes[2u * d + 1u] = v;
+      }
+    }
+  }
+
+  // The exact sphere around them, grown over the rest in one pass
+  std::sort(extremes.begin(), extremes.end());
+  vector<dvec3> seeds;
+  seeds.reserve(extremes.size());
+  for (size_t e = 0u; e < extremes.size(); ++e)
+  {
+    if (e == 0u || extremes[e] != extremes[e - 1u])
+      seeds.emplace_back(positions[extremes[e]]);
+  }
+  std::array<dvec3, 4> support;
+  Sphere sphere = welzl(seeds, seeds.size(), support, 0u);
+  for (const vec3& position : positions)
+    grow(sphere, dvec3(position));
+
+  // Measured again around the rounded center, so every point is inside in float
+  result.Center = vec3(sphere.Center);
+  for (const vec3& position : positions)
+    result.Radius = std::max(result.Radius, glm::length(position - result.Center));
+  return result;
+}
+
+Mesh::OrientedBox BoundsFitter::FitOrientedBox(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+  const Mesh::BoundingBox& box) noexcept
+{
+  Mesh::OrientedBox aligned;
+  aligned.Center = vec3(0.5f * (box.xMin + box.xMax), 0.5f * (box.yMin + box.yMax), 0.5f * (box.zMin + box.zMax));
+  aligned.HalfExtents = vec3(0.5f * (box.xMax - box.xMin), 0.5f * (box.yMax - box.yMin), 0.5f * (box.zMax - box.zMin));
+
+  double matrix[3][3];
+  if (!covariance(positions, triangles, matrix))
+    return aligned;
+
+  double vectors[3][3];
+  jacobiEigen(matrix, vectors);
+
+  // Largest spread first, the third axis completes a right handed frame
+  std::array<unsigned, 3> order = { 0u, 1u, 2u };
+  std::sort(order.begin(), order.end(), [&](const unsigned lhs, const unsigned rhs) { return matrix[lhs][lhs] > matrix[rhs][rhs]; });
+  vec3 axes[3];
+  for (unsigned a = 0u; a < 2u; ++a)
+    axes[a] = glm::normalize(vec3(vectors[0][order[a]], vectors[1][order[a]], vectors[2][order[a]]));
+  axes[2] = glm::normalize(cross(axes[0], axes[1]));
+  axes[1] = cross(axes[2], axes[0]);
+
+  // Symmetric shapes have no preferred axes, PCA can do worse than the box it already has
+  const Mesh::OrientedBox fitted = fitAlongAxes(positions, axes);
+  return boxSize(fitted.HalfExtents) < boxSize(aligned.HalfExtents) ? fitted : aligned;
+}
@@ -0,0 +1,33 @@
+//------------------------------------------------------------------------------
+// File:    BoundsFitter.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Fits bounding spheres and oriented boxes around meshes
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+
+namespace BoundsFitter
+{
+  /// <summary>
+  /// Fits a sphere within a few percent of the smallest one around the points.
+  /// The extreme points along 13 directions get an exact Welzl sphere, which a
+  /// Ritter pass over every point then grows just enough to hold the rest.
+  /// </summary>
+  /// <param name="positions">[Const Ref] Points to enclose</param>
+  /// <returns>A sphere holding every point, radius 0 if there are none</returns>
+  Mesh::BoundingSphere FitSphere(const vector<vec3>& positions) noexcept;
+
+  /// <summary>
+  /// Fits a box along the principal axes of the surface, from the covariance of
+  /// the triangles weighted by area so uneven tessellation doesn't tilt it.
+  /// Falls back to the points for meshes without area, and to the axis aligned
+  /// box when that is no larger.
+  /// </summary>
+  /// <param name="positions">[Const Ref] Points to enclose</param>
+  /// <param name="triangles">[Const Ref] Triangles over the points</param>
+  /// <param name="box">[Const Ref] Axis aligned bounds of the points</param>
+  /// <returns>A box holding every point</returns>
+  Mesh::OrientedBox FitOrientedBox(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+    const Mesh::BoundingBox& box) noexcept;
+}
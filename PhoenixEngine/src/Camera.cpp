@@ -156,6 +156,11 @@ void Camera::SetViewData(const ViewData& viewData)
   m_ViewData = viewData;
 }
 
+const Camera::ViewData& Camera::GetViewData() const noexcept
+{
+  return m_ViewData;
+}
+
 const vec3& Camera::GetPosition() const noexcept
 {
   return m_Position;
@@ -147,6 +147,12 @@ class Camera
   /// <param name="viewData">FOV, Aspect Ratio, Culling Distance</param>
   void SetViewData(const ViewData& viewData);
 
+  /// <summary>
+  /// Gets the viewing data for the camera
+  /// </summary>
+  /// <returns>FOV, Aspect Ratio, Culling Distance</returns>
+  const ViewData& GetViewData() const noexcept;
+
   /// <summary>
   /// Gets the camera's position in world space
   /// </summary>
@@ -3,7 +3,8 @@
 
 ContextManager::ContextManager() noexcept :
   m_Contexts(),
-  m_CurrentContextIndex(Error::Context::INVALID_CONTEXT)
+  m_CurrentContextIndex(Error::Context::INVALID_CONTEXT),
+  m_bCurrentReadsTangents(false)
 {
 }
 
@@ -54,6 +55,11 @@ void ContextManager::SetContext(unsigned contextIndex) noexcept
       }
     }
     m_CurrentContextIndex = contextIndex;
+
+    // Checked once per switch so the mesh draws only need the flag
+    const vector<VertexAttribute>& attributes = m_Contexts[m_CurrentContextIndex].VertexAttributes;
+    m_bCurrentReadsTangents = std::any_of(attributes.begin(), attributes.end(),
+      [](const VertexAttribute& attribute) { return attribute.Name == "tangent"; });
   }
 
   glUseProgram(m_Contexts[m_CurrentContextIndex].ProgramID);
@@ -96,6 +102,11 @@ const vector<ContextManager::VertexAttribute>& ContextManager::GetCurrentVertexA
   return m_Contexts[m_CurrentContextIndex].VertexAttributes;
 }
 
+bool ContextManager::CurrentContextReadsTangents() const noexcept
+{
+  return m_bCurrentReadsTangents;
+}
+
 void ContextManager::AddNewUniformAttribute(unsigned contextIndex, const string& name)
 {
   assert(contextIndex < m_Contexts.size());
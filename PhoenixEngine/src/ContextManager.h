@@ -70,6 +70,7 @@ public:
   GLuint GetCurrentProgram() const noexcept;
   const vector<UniformAttribute>& GetCurrentUniformAttributes() const noexcept;
   const vector<VertexAttribute>& GetCurrentVertexAttributes() const noexcept;
+  bool CurrentContextReadsTangents() const noexcept;
 
   void AddNewUniformAttribute(unsigned contextIndex, const string& name);
   void AddNewVertexAttribute(unsigned contextIndex, const VertexAttribute& vertexAttribute);
@@ -80,4 +81,5 @@ private:
   vector<Context> m_Contexts;
 
   unsigned m_CurrentContextIndex;
+  bool m_bCurrentReadsTangents;       // The current context declares a "tangent" vertex attribute
 };
@@ -97,7 +97,8 @@ namespace UV
 		CUSTOM = 0u,
 		SPHERICAL,
 		CYLINDRICAL,
-		PLANAR
+		PLANAR,
+		CUBE_MAP
 	};
 }
 
@@ -37,7 +37,8 @@ namespace
     ImGui::DemoObject::Lucy,
     ImGui::DemoObject::Quad,
     ImGui::DemoObject::Sphere,
-    ImGui::DemoObject::StarWars
+    ImGui::DemoObject::StarWars,
+    ImGui::DemoObject::Suzanne
   };
 
   static const char* DEMOOBJECTNAMES[(size_t)ImGui::DemoObject::COUNT] =
@@ -50,7 +51,8 @@ namespace
     "Lucy",
     "Quad",
     "Sphere",
-    "StarWars"
+    "StarWars",
+    "Suzanne"
   };
 
   static const char* DEMOOBJECTFILENAMES[(size_t)ImGui::DemoObject::COUNT] =
@@ -63,7 +65,8 @@ namespace
     "lucy_princeton.obj",
     "quad.obj",
     "sphere.obj",
-    "starwars1.obj"
+    "starwars1.obj",
+    "suzanne.fbx"
   };
 
   static const char* SHADERNAMES[1] =
@@ -53,6 +53,7 @@ namespace ImGui
     Quad,
     Sphere,
     StarWars,
+    Suzanne,
     COUNT
   };
 
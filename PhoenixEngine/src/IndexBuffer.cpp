@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+// File:    IndexBuffer.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Packs triangle lists into 16 bit index buffers with base vertices
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "IndexBuffer.h"
+
+namespace
+{
+  // Adds a range, or grows the last one when it continues it with the same base
+  void addRange(vector<IndexBuffer::Range>& ranges, const unsigned firstTriangle, const unsigned triangleCount,
+    const int baseVertex) noexcept
+  {
+    if (!ranges.empty())
+    {
+      IndexBuffer::Range& last = ranges.back();
+      if (last.BaseVertex == baseVertex && last.FirstTriangle + last.TriangleCount == firstTriangle)
+      {
+        last.TriangleCount += triangleCount;
+        return;
+      }
+    }
+    ranges.push_back(IndexBuffer::Range{ firstTriangle, triangleCount, baseVertex });
+  }
+}
+
+bool IndexBuffer::AppendShort(const Mesh::Triangle* triangles, const size_t triangleCount, const size_t vertexCount,
+  ShortIndices& result) noexcept
+{
+  if (triangleCount == 0u)
+    return true;
+
+  // Ranges of these triangles, counted from the first of them
+  vector<Range> ranges;
+  if (vertexCount <= MAX_SHORT_VERTICES)
+  {
+    ranges.push_back(Range{ 0u, static_cast<unsigned>(triangleCount), 0 });
+  }
+  else
+  {
+    // Grow each range until the next triangle would take its vertex span past 16 bits
+    unsigned rangeStart = 0u;
+    unsigned low = std::numeric_limits<unsigned>::max();
+    unsigned high = 0u;
+    for (size_t t = 0u; t < triangleCount; ++t)
+    {
+      const Mesh::Triangle& tri = triangles[t];
+      const unsigned triangleLow = std::min({ tri.Index1, tri.Index2, tri.Index3 });
+      const unsigned triangleHigh = std::max({ tri.Index1, tri.Index2, tri.Index3 });
+      if (triangleHigh - triangleLow >= MAX_SHORT_VERTICES)
+        return false;
+
+      if (std::max(high, triangleHigh) - std::min(low, triangleLow) >= MAX_SHORT_VERTICES)
+      {
+        ranges.push_back(Range{ rangeStart, static_cast<unsigned>(t) - rangeStart, static_cast<int>(low) });
+        rangeStart = static_cast<unsigned>(t);
+        low = triangleLow;
+        high = triangleHigh;
+      }
+      else
+      {
+        low = std::min(low, triangleLow);
+        high = std::max(high, triangleHigh);
+      }
+    }
+    ranges.push_back(Range{ rangeStart, static_cast<unsigned>(triangleCount) - rangeStart, static_cast<int>(low) });
+  }
+
+  // Every index relative to the base of its range
+  const auto firstTriangle = static_cast<unsigned>(result.Indices.size() / 3u);
+  result.Indices.resize(result.Indices.size() + 3u * triangleCount);
+  uint16_t* indices = result.Indices.data() + 3u * size_t(firstTriangle);
+  for (const Range& range : ranges)
+  {
+    const auto base = static_cast<unsigned>(range.BaseVertex);
+    for (size_t t = range.FirstTriangle; t < size_t(range.FirstTriangle) + range.TriangleCount; ++t)
+    {
+      indices[3u * t + 0u] = static_cast<uint16_t>(triangles[t].Index1 - base);
+      indices[3u * t + 1u] = static_cast<uint16_t>(triangles[t].Index2 - base);
+      indices[3u * t + 2u] = static_cast<uint16_t>(triangles[t].Index3 - base);
+    }
+    addRange(result.Ranges, firstTriangle + range.FirstTriangle, range.TriangleCount, range.BaseVertex);
+  }
+  return true;
+}
+
+bool IndexBuffer::IsFragmented(const ShortIndices& indices) noexcept
+{
+  const size_t triangleCount = indices.Indices.size() / 3u;
+  return indices.Ranges.size() > 1u && indices.Ranges.size() * MIN_RANGE_TRIANGLES > triangleCount;
+}
+
+size_t IndexBuffer::FindRange(const vector<Range>& ranges, const unsigned triangle) noexcept
+{
+  const auto next = std::upper_bound(ranges.begin(), ranges.end(), triangle,
+    [](const unsigned value, const Range& range) { return value < range.FirstTriangle; });
+  return next == ranges.begin() ? 0u : static_cast<size_t>(next - ranges.begin()) - 1u;
+}
@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+// File:    IndexBuffer.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Packs triangle lists into 16 bit index buffers with base vertices
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+
+namespace IndexBuffer
+{
+  // Vertices one 16 bit range can address from its base vertex
+  constexpr size_t MAX_SHORT_VERTICES = 65536u;
+
+  // Average triangles per range below which the extra draws cost more than the halved index fetch
+  constexpr size_t MIN_RANGE_TRIANGLES = 1024u;
+
+  /// <summary>
+  /// A run of triangles whose 16 bit indices are relative to one base vertex
+  /// </summary>
+  struct Range
+  {
+    unsigned FirstTriangle; // Offset of the range in the index buffer, in triangles
+    unsigned TriangleCount; // Triangles in the range
+    int BaseVertex;         // Added to every index of the range when drawn
+  };
+
+  /// <summary>
+  /// 16 bit indices and the ranges that cover them, in index buffer order
+  /// </summary>
+  struct ShortIndices
+  {
+    vector<uint16_t> Indices;
+    vector<Range> Ranges;
+  };
+
+  /// <summary>
+  /// Appends triangles to a 16 bit index buffer. Meshes of at most
+  /// MAX_SHORT_VERTICES vertices fit one range from vertex 0. Larger ones are
+  /// split wherever the vertices a run of triangles uses stop fitting 16 bits,
+  /// which after OptimizeVertexFetch is rarely more than every 65536 vertices.
+  /// </summary>
+  /// <param name="triangles">Triangles to append</param>
+  /// <param name="triangleCount">Number of triangles</param>
+  /// <param name="vertexCount">Number of vertices the triangles index</param>
+  /// <param name="result">[In/Out] Index buffer the triangles are added to</param>
+  /// <returns>[T/F] The triangles fit, false if one triangle alone spans too many vertices, leaving result as it was</returns>
+  bool AppendShort(const Mesh::Triangle* triangles, size_t triangleCount, size_t vertexCount, ShortIndices& result) noexcept;
+
+  /// <summary>
+  /// Checks whether the ranges are so short that 32 bit indices, drawn in one
+  /// call, would be cheaper
+  /// </summary>
+  /// <param name="indices">[Const Ref] A packed index buffer</param>
+  /// <returns>[T/F] Averages fewer than MIN_RANGE_TRIANGLES triangles per range</returns>
+  bool IsFragmented(const ShortIndices& indices) noexcept;
+
+  /// <summary>
+  /// Finds the range holding a triangle
+  /// </summary>
+  /// <param name="ranges">[Const Ref] Ranges in index buffer order, covering the triangle</param>
+  /// <param name="triangle">Offset of the triangle in the index buffer</param>
+  /// <returns>Position of the range in ranges</returns>
+  size_t FindRange(const vector<Range>& ranges, unsigned triangle) noexcept;
+}
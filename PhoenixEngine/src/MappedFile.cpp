@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+// File:    MappedFile.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Read-only memory mapped view of a file on disk
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() noexcept :
+  m_Data(nullptr),
+  m_Size(0u),
+  m_hFile(nullptr),
+  m_hMapping(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const string& filePath) noexcept
+{
+  Close();
+
+  HANDLE hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (hFile == INVALID_HANDLE_VALUE)
+  {
+    Log::Error("[MappedFile] Could not open file: " + filePath);
+    return false;
+  }
+  m_hFile = hFile;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(hFile, &size) || size.QuadPart <= 0)
+  {
+    Log::Error("[MappedFile] Empty or unreadable file: " + filePath);
+    Close();
+    return false;
+  }
+
+  HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (hMapping == nullptr)
+  {
+    Log::Error("[MappedFile] Could not create file mapping: " + filePath);
+    Close();
+    return false;
+  }
+  m_hMapping = hMapping;
+
+  m_Data = static_cast<const char*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+  if (m_Data == nullptr)
+  {
+    Log::Error("[MappedFile] Could not map view of file: " + filePath);
+    Close();
+    return false;
+  }
+  m_Size = static_cast<size_t>(size.QuadPart);
+
+  return true;
+}
+
+void MappedFile::Close() noexcept
+{
+  if (m_Data)
+    UnmapViewOfFile(m_Data);
+  if (m_hMapping)
+    CloseHandle(static_cast<HANDLE>(m_hMapping));
+  if (m_hFile)
+    CloseHandle(static_cast<HANDLE>(m_hFile));
+
+  m_Data = nullptr;
+  m_Size = 0u;
+  m_hFile = nullptr;
+  m_hMapping = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const string& filePath) noexcept
+{
+  Close();
+
+  const int fd = open(filePath.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    Log::Error("[MappedFile] Could not open file: " + filePath);
+    return false;
+  }
+
+  struct stat info {};
+  if (fstat(fd, &info) != 0 || info.st_size <= 0)
+  {
+    Log::Error("[MappedFile] Empty or unreadable file: " + filePath);
+    close(fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    Log::Error("[MappedFile] Could not map file: " + filePath);
+    return false;
+  }
+  madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+  m_Data = static_cast<const char*>(data);
+  m_Size = static_cast<size_t>(info.st_size);
+
+  return true;
+}
+
+void MappedFile::Close() noexcept
+{
+  if (m_Data)
+    munmap(const_cast<char*>(m_Data), m_Size);
+
+  m_Data = nullptr;
+  m_Size = 0u;
+}
+
+#endif
@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------
+// File:    MappedFile.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Read-only memory mapped view of a file on disk
+//------------------------------------------------------------------------------
+#pragma once
+
+class MappedFile
+{
+public:
+  /// <summary>
+  /// Default constructor, nothing is mapped until Open is called
+  /// </summary>
+  MappedFile() noexcept;
+
+  /// <summary>
+  /// Unmaps the view and closes the file if one is open
+  /// </summary>
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+
+  /// <summary>
+  /// Maps the entire file into memory as a read-only view
+  /// </summary>
+  /// <param name="filePath">Path of the file to map</param>
+  /// <returns>[T/F] The file was opened and mapped</returns>
+  bool Open(const string& filePath) noexcept;
+
+  /// <summary>
+  /// Unmaps the view and closes the file
+  /// </summary>
+  void Close() noexcept;
+
+  /// <summary>
+  /// Checks if a file is currently mapped
+  /// </summary>
+  /// <returns>[T/F] A file is mapped</returns>
+  inline bool IsOpen() const noexcept { return m_Data != nullptr; }
+
+  /// <summary>
+  /// Gets the first byte of the mapped view
+  /// </summary>
+  /// <returns>Pointer to the start of the file contents</returns>
+  inline const char* Begin() const noexcept { return m_Data; }
+
+  /// <summary>
+  /// Gets one past the last byte of the mapped view
+  /// </summary>
+  /// <returns>Pointer to the end of the file contents</returns>
+  inline const char* End() const noexcept { return m_Data + m_Size; }
+
+  /// <summary>
+  /// Gets the size of the mapped file
+  /// </summary>
+  /// <returns>The number of bytes mapped</returns>
+  inline size_t Size() const noexcept { return m_Size; }
+
+private:
+  const char* m_Data;   // Start of the mapped view
+  size_t m_Size;        // Size of the mapped view in bytes
+
+  void* m_hFile;        // OS handle to the open file
+  void* m_hMapping;     // OS handle to the file mapping object
+};
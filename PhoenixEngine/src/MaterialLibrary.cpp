@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+// File:    MaterialLibrary.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Reads the materials of a Wavefront .mtl library
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MaterialLibrary.h"
+#include <fstream>
+
+namespace
+{
+  // Reads the r g b of a color record, a single value stands for all three
+  vec3 readColor(stringstream& record) noexcept
+  {
+    vec3 color(0.f);
+    record >> color.r;
+    if (!(record >> color.g >> color.b))
+      color = vec3(color.r);
+    return color;
+  }
+
+  float mean(const vec3& color) noexcept
+  {
+    return (color.r + color.g + color.b) / 3.f;
+  }
+}
+
+bool MaterialLibrary::Read(const string& filepath, std::map<string, Material>& materials) noexcept
+{
+  std::ifstream inFile(Paths::MODEL_PATH + filepath);
+  if (!inFile.is_open())
+    return false;
+
+  const Material basic(Material::Type::BASIC);
+  Material* current = nullptr;
+  string line;
+  while (std::getline(inFile, line))
+  {
+    stringstream record(line);
+    string key;
+    if (!(record >> key) || key[0] == '#')
+      continue;
+
+    if (key == "newmtl")
+    {
+      // Names may hold spaces, so they run to the end of the line
+      string name;
+      std::getline(record >> std::ws, name);
+      while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back())))
+        name.pop_back();
+      // A repeated name starts over, like the later definition replacing the earlier one
+      current = &materials.try_emplace(name, Material::Type::BASIC).first->second;
+      *current = basic;
+      continue;
+    }
+    // Records before the first material have nothing to apply to
+    if (current == nullptr)
+      continue;
+
+    if (key == "Ka")
+      current->SetAmbient(mean(readColor(record)));
+    else if (key == "Kd")
+      current->SetDiffuse(mean(readColor(record)));
+    else if (key == "Ks")
+      current->SetSpecular(mean(readColor(record)));
+    else if (key == "Ke")
+      current->SetEmissive(readColor(record));
+    else if (key == "Ns")
+    {
+      float exponent = 0.f;
+      if (record >> exponent)
+        current->SetSpecularExp(exponent);
+    }
+    // Textures, transparency and illumination models have no place in Material yet
+  }
+
+  return true;
+}
@@ -0,0 +1,24 @@
+//------------------------------------------------------------------------------
+// File:    MaterialLibrary.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Reads the materials of a Wavefront .mtl library
+//------------------------------------------------------------------------------
+#pragma once
+#include "Material.h"
+#include <map>
+
+namespace MaterialLibrary
+{
+  /// <summary>
+  /// Reads every 'newmtl' of a material library into a Material. The Phong
+  /// factors are scalars, so the Ka, Kd and Ks colors become the mean of their
+  /// channels. Ke is the emissive color and Ns the specular exponent, within
+  /// what Material clamps them to. Anything the file leaves out keeps the
+  /// basic material's value.
+  /// </summary>
+  /// <param name="filepath">[Const Ref] Path of the library under the model directory</param>
+  /// <param name="materials">[Out] Receives the materials by name</param>
+  /// <returns>[T/F] The library could be opened</returns>
+  bool Read(const string& filepath, std::map<string, Material>& materials) noexcept;
+}
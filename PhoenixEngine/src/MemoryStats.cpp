@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// File:    MemoryStats.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Process wide heap allocation and resident memory statistics
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MemoryStats.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+  std::atomic<size_t> s_AllocationCount{ 0u };
+  thread_local size_t s_ThreadAllocationCount = 0u;
+
+#ifdef _MSC_VER
+#define MEMORYSTATS_NOINLINE __declspec(noinline)
+#else
+#define MEMORYSTATS_NOINLINE __attribute__((noinline))
+#endif
+
+  // The operators below only call these. Kept out of line so GCC doesn't pair
+  // malloc and free with the replaced new and delete and warn of a mismatch.
+  MEMORYSTATS_NOINLINE void* allocate(std::size_t size, std::size_t alignment) noexcept
+  {
+    s_AllocationCount.fetch_add(1u, std::memory_order_relaxed);
+    ++s_ThreadAllocationCount;
+    if (!size)
+      size = 1u;
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+      return std::malloc(size);
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1u) & ~(alignment - 1u));
+#endif
+  }
+
+  MEMORYSTATS_NOINLINE void release(void* ptr, std::size_t alignment) noexcept
+  {
+#ifdef _WIN32
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+      _aligned_free(ptr);
+      return;
+    }
+#else
+    (void)alignment;
+#endif
+    std::free(ptr);
+  }
+}
+
+// Replacing the global allocation functions is the only way to see every
+// allocation, including vector growth inside the STL. The array and nothrow
+// forms forward to these by default, so between the plain and over-aligned
+// forms every operator new is counted.
+void* operator new(std::size_t size)
+{
+  if (void* ptr = allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (void* ptr = allocate(size, static_cast<std::size_t>(alignment)))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  release(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  release(ptr, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+  release(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+  release(ptr, static_cast<std::size_t>(alignment));
+}
+
+size_t MemoryStats::GetAllocationCount() noexcept
+{
+  return s_AllocationCount.load(std::memory_order_relaxed);
+}
+
+size_t MemoryStats::GetThreadAllocationCount() noexcept
+{
+  return s_ThreadAllocationCount;
+}
+
+void MemoryStats::AddThreadAllocations(const size_t Count) noexcept
+{
+  s_ThreadAllocationCount += Count;
+}
+
+size_t MemoryStats::GetPeakResidentBytes() noexcept
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters{};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0u;
+  return static_cast<size_t>(counters.PeakWorkingSetSize);
+#else
+  struct rusage usage {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0u;
+  // Reported in kilobytes
+  return static_cast<size_t>(usage.ru_maxrss) * 1024u;
+#endif
+}
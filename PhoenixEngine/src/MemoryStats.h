@@ -0,0 +1,38 @@
+//------------------------------------------------------------------------------
+// File:    MemoryStats.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Process wide heap allocation and resident memory statistics
+//------------------------------------------------------------------------------
+#pragma once
+
+namespace MemoryStats
+{
+  /// <summary>
+  /// Gets the number of heap allocations made through operator new since startup.
+  /// Sample before and after an operation to count its allocations.
+  /// </summary>
+  /// <returns>The running allocation count</returns>
+  size_t GetAllocationCount() noexcept;
+
+  /// <summary>
+  /// Gets the number of heap allocations made on the calling thread, plus any
+  /// that helper threads handed over with AddThreadAllocations. Unlike the
+  /// process wide count, other threads working at the same time don't show up.
+  /// </summary>
+  /// <returns>The running allocation count of this thread</returns>
+  size_t GetThreadAllocationCount() noexcept;
+
+  /// <summary>
+  /// Credits allocations made on a helper thread to the calling thread, so work
+  /// split across threads is counted by the thread that started it
+  /// </summary>
+  /// <param name="Count">Allocations the helper made, from its own thread count</param>
+  void AddThreadAllocations(size_t Count) noexcept;
+
+  /// <summary>
+  /// Gets the largest resident set (working set) the process has reached
+  /// </summary>
+  /// <returns>Peak resident memory in bytes, or 0 if unavailable</returns>
+  size_t GetPeakResidentBytes() noexcept;
+}
@@ -6,8 +6,164 @@
 //------------------------------------------------------------------------------
 #include "pch.h"
 #include "Mesh.h"
+#include "MeshKernels.h"
+#include "VertexCacheOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "MeshWelder.h"
+#include "BoundsFitter.h"
+#include "MemoryStats.h"
 #include <glm/gtc/epsilon.hpp>    // For episolon use in checking normal congruency
 #include <glm/gtc/constants.hpp>  // PI and related constants
+#include <glm/gtc/packing.hpp>    // Normal and UV packing for the quantized vertex format
+
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  // Splits [0, count) into one contiguous range per hardware thread and runs
+  // them concurrently. Ranges too small to be worth a thread run inline.
+  template<typename Body>
+  void parallelFor(const size_t count, Body&& body)
+  {
+    constexpr size_t MinRangeSize = 16u * 1024u;
+    const size_t rangeCount = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), std::max<size_t>(1u, count / MinRangeSize));
+    if (rangeCount <= 1u)
+    {
+      body(size_t(0u), count);
+      return;
+    }
+
+    // Allocations on the workers are credited to the calling thread
+    vector<size_t> allocations(rangeCount, 0u);
+    vector<std::thread> workers;
+    workers.reserve(rangeCount - 1u);
+    for (size_t r = 1u; r < rangeCount; ++r)
+    {
+      workers.emplace_back([&, r]
+        {
+          const size_t before = MemoryStats::GetThreadAllocationCount();
+          body(count * r / rangeCount, count * (r + 1u) / rangeCount);
+          allocations[r] = MemoryStats::GetThreadAllocationCount() - before;
+        });
+    }
+    body(size_t(0u), count / rangeCount);
+    for (std::thread& worker : workers)
+      worker.join();
+    for (const size_t workerAllocations : allocations)
+      MemoryStats::AddThreadAllocations(workerAllocations);
+  }
+
+  // Moves every element of a per-vertex or per-triangle array to its new index.
+  // Arrays that weren't filled in are left alone.
+  template<typename T>
+  void scatter(vector<T>& values, const vector<unsigned>& newIndices)
+  {
+    if (values.size() != newIndices.size())
+      return;
+
+    vector<T> moved(values.size());
+    for (size_t i = 0u; i < values.size(); ++i)
+      moved[newIndices[i]] = values[i];
+    values.swap(moved);
+  }
+
+  // Orders the triangles inside each meshlet for the post-transform cache. The
+  // meshlets keep their ranges, only the triangles within them move. Vertices
+  // are numbered per meshlet so the adjacency stays meshlet sized.
+  void optimizeMeshletTriangles(const vector<Mesh::Triangle>& triangles, const size_t vertexCount,
+    const vector<Mesh::Meshlet>& meshlets, vector<unsigned>& order) noexcept
+  {
+    vector<unsigned> localIndex(vertexCount, Error::INVALID_INDEX);
+    vector<unsigned> localVertices;
+    vector<Mesh::Triangle> localTriangles;
+    vector<unsigned> slice;
+    const auto toLocal = [&](const unsigned vertex)
+    {
+      if (localIndex[vertex] == Error::INVALID_INDEX)
+      {
+        localIndex[vertex] = static_cast<unsigned>(localVertices.size());
+        localVertices.push_back(vertex);
+      }
+      return localIndex[vertex];
+    };
+
+    for (const Mesh::Meshlet& meshlet : meshlets)
+    {
+      localTriangles.clear();
+      for (unsigned i = 0u; i < meshlet.TriangleCount; ++i)
+      {
+        const Mesh::Triangle& tri = triangles[order[meshlet.FirstTriangle + i]];
+        localTriangles.emplace_back(toLocal(tri.Index1), toLocal(tri.Index2), toLocal(tri.Index3));
+      }
+
+      Mesh::VertexAdjacency adjacency;
+      Mesh::BuildVertexAdjacency(localTriangles, localVertices.size(), adjacency);
+      const vector<unsigned> localOrder = VertexCacheOptimizer::OptimizeTriangleOrder(localTriangles, adjacency);
+      slice.assign(order.begin() + meshlet.FirstTriangle, order.begin() + meshlet.FirstTriangle + meshlet.TriangleCount);
+      for (unsigned i = 0u; i < meshlet.TriangleCount; ++i)
+        order[meshlet.FirstTriangle + i] = slice[localOrder[i]];
+
+      for (const unsigned vertex : localVertices)
+        localIndex[vertex] = Error::INVALID_INDEX;
+      localVertices.clear();
+    }
+  }
+
+  // Keeps the elements whose index maps to the next new index, in order, and
+  // drops the ones merged into an earlier element. Arrays that weren't filled in are left alone.
+  template<typename T>
+  void compact(vector<T>& values, const vector<unsigned>& newIndices, const size_t newCount)
+  {
+    if (values.size() != newIndices.size())
+      return;
+
+    size_t next = 0u;
+    for (size_t i = 0u; i < values.size(); ++i)
+    {
+      if (newIndices[i] == next)
+        values[next++] = values[i];
+    }
+    values.resize(newCount);
+  }
+
+  // Keeps the elements at the given increasing indices, in order
+  template<typename T>
+  void gather(vector<T>& values, const vector<unsigned>& indices, const size_t oldCount)
+  {
+    if (values.size() != oldCount)
+      return;
+
+    for (size_t i = 0u; i < indices.size(); ++i)
+      values[i] = values[indices[i]];
+    values.resize(indices.size());
+  }
+
+  // The angle of a triangle's corner at one of its vertices
+  float cornerAngle(const vector<vec3>& positions, const Mesh::Triangle& tri, const unsigned vertex) noexcept
+  {
+    unsigned other1 = tri.Index2, other2 = tri.Index3;
+    if (tri.Index2 == vertex)
+    {
+      other1 = tri.Index3;
+      other2 = tri.Index1;
+    }
+    else if (tri.Index3 == vertex)
+    {
+      other1 = tri.Index1;
+      other2 = tri.Index2;
+    }
+
+    const vec3 e1 = positions[other1] - positions[vertex];
+    const vec3 e2 = positions[other2] - positions[vertex];
+    const float lengths = glm::length(e1) * glm::length(e2);
+    if (lengths <= 0.f)
+      return 0.f;
+    return acosf(glm::clamp(glm::dot(e1, e2) / lengths, -1.f, 1.f));
+  }
+}
 
 Mesh::Mesh(const vec3& origin, bool isStatic) noexcept :
   m_Origin(origin),
@@ -20,8 +176,24 @@ Mesh::Mesh(const vec3& origin, bool isStatic) noexcept :
   m_TriangleArray(),
   m_TexcoordArray(),
   m_VertexData(),
+  m_PackedVertexData(),
+  m_TangentArray(),
+  m_TangentData(),
+  m_VertexAdjacency(),
+  m_HalfEdges(),
+  m_LodTriangleArray(),
+  m_LodArray(),
+  m_MeshletArray(),
+  m_SubmeshArray(),
+  m_MaterialNames(),
+  m_MaterialLibrary(),
+  m_Bounds{ 0.f, 0.f, 0.f, 0.f, 0.f, 0.f },
+  m_BoundsVertexCount(0u),
+  m_BoundsAreCached(false),
+  m_BoundingVolumes(),
   m_MeshIsDirty(true),
-  m_NormalsAreCalculated(false)
+  m_NormalsAreCalculated(false),
+  m_TexcoordsAreImported(false)
 {}
 
 unsigned Mesh::GetVertexCount() const noexcept
@@ -71,9 +243,27 @@ void Mesh::AddVertexNormal(float x, float y, float z) noexcept
 void Mesh::AddTriangle(unsigned index1, unsigned index2, unsigned index3) noexcept
 {
   m_TriangleArray.emplace_back(index1, index2, index3);
+  m_VertexAdjacency.Offsets.clear();
+  m_HalfEdges.Twins.clear();
+  m_LodTriangleArray.clear();
+  m_LodArray.clear();
+  m_MeshletArray.clear();
+  m_SubmeshArray.clear();
+  m_MaterialNames.clear();
   m_MeshIsDirty = true;
 }
 
+void Mesh::Reserve(unsigned vertexCount, unsigned triangleCount, bool withAttributes) noexcept
+{
+  m_PositionArray.reserve(vertexCount);
+  m_TriangleArray.reserve(triangleCount);
+  if (withAttributes)
+  {
+    m_VertexNormalArray.reserve(vertexCount);
+    m_TexcoordArray.reserve(vertexCount);
+  }
+}
+
 const vector<vec3>& Mesh::GetVertexNormalArray() const noexcept
 {
   return m_VertexNormalArray;
@@ -96,35 +286,42 @@ const vector<vec2>& Mesh::GetTexcoordArray() const noexcept
 
 Mesh::BoundingBox Mesh::CalculateBoundingBox() const noexcept
 {
-  BoundingBox bounds = { 0.f };
-  bounds.xMin = numeric_limits<float>::max();
-  bounds.yMin = numeric_limits<float>::max();
-  bounds.zMin = numeric_limits<float>::max();
-  bounds.xMax = numeric_limits<float>::min();
-  bounds.yMax = numeric_limits<float>::min();
-  bounds.zMax = numeric_limits<float>::min();
+  // An empty mesh has an empty box at the origin rather than an inverted one
+  if (m_PositionArray.empty())
+    return BoundingBox{ 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
 
-  // Find the minimum x, y, z values
-  for (const vec3& v : m_PositionArray)
+  vec3 min, max;
+  MeshKernels::CalculateBounds(m_PositionArray.data(), m_PositionArray.size(), min, max);
+  return BoundingBox{ min.x, min.y, min.z, max.x, max.y, max.z };
+}
+
+const Mesh::BoundingBox& Mesh::GetBoundingBox() const noexcept
+{
+  // Vertices are only ever added or moved through the mesh, and moving them
+  // updates the cache, so a matching count means nothing has changed
+  if (!m_BoundsAreCached || m_BoundsVertexCount != m_PositionArray.size())
   {
-    bounds.xMin = std::min(v.x, bounds.xMin);
-    bounds.xMax = std::max(v.x, bounds.xMax);
-    bounds.yMin = std::min(v.y, bounds.yMin);
-    bounds.yMax = std::max(v.y, bounds.yMax);
-    bounds.zMin = std::min(v.z, bounds.zMin);
-    bounds.zMax = std::max(v.z, bounds.zMax);
+    m_Bounds = CalculateBoundingBox();
+    m_BoundsVertexCount = m_PositionArray.size();
+    m_BoundsAreCached = true;
   }
-
-  return bounds;
+  return m_Bounds;
 }
 
 vec3 Mesh::CalculateBoundingBoxSize() noexcept
 {
-  BoundingBox bounds = CalculateBoundingBox();
+  const BoundingBox& bounds = GetBoundingBox();
 
   return vec3(bounds.xMax - bounds.xMin, bounds.yMax - bounds.yMin, bounds.zMax - bounds.zMin);
 }
 
+void Mesh::CalculateBoundingVolumes() noexcept
+{
+  m_BoundingVolumes.Aabb = GetBoundingBox();
+  m_BoundingVolumes.Sphere = BoundsFitter::FitSphere(m_PositionArray);
+  m_BoundingVolumes.Obb = BoundsFitter::FitOrientedBox(m_PositionArray, m_TriangleArray, m_BoundingVolumes.Aabb);
+}
+
 float Mesh::CalculateWidestPoint() noexcept
 {
   // First get the bounding box size
@@ -148,7 +345,7 @@ namespace
   };
 }
 
-void Mesh::CalculateNormals(bool flipNormals) noexcept
+void Mesh::CalculateNormals(bool flipNormals, NormalWeighting weighting) noexcept
 {
   // Vertices and indices must be populated
   if (m_PositionArray.empty() || m_TriangleArray.empty())
@@ -157,261 +354,928 @@ void Mesh::CalculateNormals(bool flipNormals) noexcept
     return;
   }
 
-  // First get the surface normals
-  calculateSurfaceNormals(flipNormals);
-  // Using surface normals, average them out per vertex
-  calculateVertexNormals();
+  // First get the surface normals, and the areas if they are weighed by them
+  vector<float> areas;
+  calculateSurfaceNormals(flipNormals, weighting == NormalWeighting::AREA ? &areas : nullptr);
+  // Using surface normals, blend them per vertex
+  calculateVertexNormals(weighting, areas);
 }
 
-void Mesh::ScaleToUnitSize() noexcept
+void Mesh::CalculateTangents() noexcept
+{
+  const size_t vertexCount = m_PositionArray.size();
+  if (m_VertexNormalArray.size() != vertexCount || m_TexcoordArray.size() != vertexCount)
+  {
+    Log::Error("[Mesh] Tangents need a normal and a UV coordinate per vertex");
+    m_TangentArray.clear();
+    m_TangentData.clear();
+    return;
+  }
+
+  // The directions U and V increase in across each triangle. Triangles
+  // without UV area get none and don't count.
+  vector<vec3> faceTangents(m_TriangleArray.size());
+  vector<vec3> faceBitangents(m_TriangleArray.size());
+  parallelFor(m_TriangleArray.size(), [&](const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const Triangle& tri = m_TriangleArray[i];
+        const vec3 e1 = m_PositionArray[tri.Index2] - m_PositionArray[tri.Index1];
+        const vec3 e2 = m_PositionArray[tri.Index3] - m_PositionArray[tri.Index1];
+        const vec2 d1 = m_TexcoordArray[tri.Index2] - m_TexcoordArray[tri.Index1];
+        const vec2 d2 = m_TexcoordArray[tri.Index3] - m_TexcoordArray[tri.Index1];
+
+        // Twice the signed area in UV space. Dividing by it gives the gradients,
+        // only their directions are kept so just its sign is applied.
+        const float area = d1.x * d2.y - d2.x * d1.y;
+        const vec3 tangent = area > 0.f ? e1 * d2.y - e2 * d1.y : e2 * d1.y - e1 * d2.y;
+        const vec3 bitangent = area > 0.f ? e2 * d1.x - e1 * d2.x : e1 * d2.x - e2 * d1.x;
+        const float tangentLength = glm::length(tangent);
+        const float bitangentLength = glm::length(bitangent);
+        const bool isValid = area != 0.f && tangentLength > 0.f && bitangentLength > 0.f;
+        faceTangents[i] = isValid ? tangent / tangentLength : vec3(0.f);
+        faceBitangents[i] = isValid ? bitangent / bitangentLength : vec3(0.f);
+      }
+    });
+
+  // Each vertex gathers from its own triangles in adjacency order and writes
+  // only its own tangent, so the sums come out the same on any thread count
+  const VertexAdjacency& adjacency = GetVertexAdjacency();
+  m_TangentArray.resize(vertexCount);
+  m_TangentData.resize(vertexCount);
+  parallelFor(vertexCount, [&](const size_t begin, const size_t end)
+    {
+      for (size_t v = begin; v < end; ++v)
+      {
+        const float normalLength = glm::length(m_VertexNormalArray[v]);
+        const vec3 normal = normalLength > 0.f ? m_VertexNormalArray[v] / normalLength : vec3(0.f, 0.f, 1.f);
+        const auto projectNormalized = [&normal](const vec3& direction)
+        {
+          const vec3 projected = direction - normal * dot(normal, direction);
+          const float length = glm::length(projected);
+          return length > 0.f ? projected / length : vec3(0.f);
+        };
+
+        vec3 tangent(0.f);
+        vec3 bitangent(0.f);
+        for (unsigned k = adjacency.Offsets[v]; k < adjacency.Offsets[v + 1u]; ++k)
+        {
+          const unsigned t = adjacency.Triangles[k];
+          const float angle = cornerAngle(m_PositionArray, m_TriangleArray[t], static_cast<unsigned>(v));
+          tangent += projectNormalized(faceTangents[t]) * angle;
+          bitangent += projectNormalized(faceBitangents[t]) * angle;
+        }
+
+        // Vertices without UV area around them get any tangent in the plane
+        tangent = projectNormalized(tangent);
+        if (tangent == vec3(0.f))
+          tangent = projectNormalized(std::abs(normal.x) < 0.9f ? vec3(1.f, 0.f, 0.f) : vec3(0.f, 1.f, 0.f));
+
+        const float sign = dot(cross(normal, tangent), bitangent) < 0.f ? -1.f : 1.f;
+        m_TangentArray[v] = vec4(tangent, sign);
+        m_TangentData[v] = glm::packSnorm3x10_1x2(m_TangentArray[v]);
+      }
+    });
+  m_MeshIsDirty = true;
+}
+
+const Mesh::VertexAdjacency& Mesh::GetVertexAdjacency() noexcept
+{
+  const VertexAdjacency& adjacency = m_VertexAdjacency;
+  if (adjacency.Offsets.size() != m_PositionArray.size() + 1u || adjacency.Triangles.size() != 3u * m_TriangleArray.size())
+    BuildVertexAdjacency(m_TriangleArray, m_PositionArray.size(), m_VertexAdjacency);
+  return m_VertexAdjacency;
+}
+
+void Mesh::BuildVertexAdjacency(const vector<Triangle>& triangleArray, const size_t vertexCount, VertexAdjacency& adjacency) noexcept
 {
-  // First find the ratio of v to the widest axis
-  float factor = 1.f / CalculateWidestPoint();
+  vector<unsigned>& offsets = adjacency.Offsets;
+  vector<unsigned>& triangles = adjacency.Triangles;
+  const size_t cornerCount = 3u * triangleArray.size();
 
-  // For each location, rescale
-  for (vec3& v : m_PositionArray)
+  // Count the triangles on each vertex, one slot along so the prefix sum
+  // leaves the start of each vertex's run in its own slot
+  offsets.assign(vertexCount + 1u, 0u);
+  for (const Triangle& tri : triangleArray)
   {
-    v *= factor;
+    ++offsets[tri.Index1 + 1u];
+    ++offsets[tri.Index2 + 1u];
+    ++offsets[tri.Index3 + 1u];
   }
+  for (size_t v = 1u; v <= vertexCount; ++v)
+    offsets[v] += offsets[v - 1u];
 
-  // For each surface normal location, rescale
-  for (vec3& np : m_SurfaceNormalPositionArray)
+  // Filled in triangle order, so every run is sorted and the sums over it are deterministic
+  triangles.resize(cornerCount);
+  vector<unsigned> cursor(offsets.begin(), offsets.end() - 1);
+  for (unsigned t = 0u; t < triangleArray.size(); ++t)
   {
-    np *= factor;
+    const Triangle& tri = triangleArray[t];
+    triangles[cursor[tri.Index1]++] = t;
+    triangles[cursor[tri.Index2]++] = t;
+    triangles[cursor[tri.Index3]++] = t;
   }
 }
 
-vec3 Mesh::FindCentroid() const noexcept
+const Mesh::HalfEdgeTable& Mesh::GetHalfEdges() noexcept
 {
-  BoundingBox bounds = CalculateBoundingBox();
-
-  // Average the center of 
-  vec3 center(
-    bounds.xMin + ((bounds.xMax - bounds.xMin) / 2.f),
-    bounds.yMin + ((bounds.yMax - bounds.yMin) / 2.f),
-    bounds.zMin + ((bounds.zMax - bounds.zMin) / 2.f)
-  );
-
-  return center;
+  if (m_HalfEdges.Twins.size() != 3u * m_TriangleArray.size() || m_HalfEdges.Outgoing.size() != m_PositionArray.size())
+  {
+    BuildHalfEdges(m_TriangleArray, m_PositionArray.size(), m_HalfEdges);
+    if (!m_HalfEdges.NonManifoldEdges.empty())
+      Log::Trace("Mesh::GetHalfEdges - " + std::to_string(m_HalfEdges.NonManifoldEdges.size()) + " non-manifold edges.");
+  }
+  return m_HalfEdges;
 }
 
-void Mesh::ResetOriginToCentroid() noexcept
+void Mesh::BuildHalfEdges(const vector<Triangle>& triangleArray, const size_t vertexCount, HalfEdgeTable& halfEdges) noexcept
 {
-  vec3 oldOrigin = m_Origin;
-  m_Origin = FindCentroid();
+  const size_t halfEdgeCount = 3u * triangleArray.size();
+  halfEdges.Twins.assign(halfEdgeCount, Error::INVALID_INDEX);
+  halfEdges.EdgeIndices.assign(halfEdgeCount, Error::INVALID_INDEX);
+  halfEdges.Outgoing.assign(vertexCount, Error::INVALID_INDEX);
+  halfEdges.Edges.clear();
+  halfEdges.NonManifoldEdges.clear();
+  if (halfEdgeCount == 0u)
+    return;
+
+  // A closed mesh has one edge per 1.5 triangles, so more slots than half-edges
+  // keeps the table at most half full and can never fill up, even for a soup.
+  // Slots only hold the edge index to stay small, the key is read back from it.
+  unsigned bits = 1u;
+  while ((size_t(1u) << bits) <= halfEdgeCount)
+    ++bits;
+  const size_t mask = (size_t(1u) << bits) - 1u;
+  vector<unsigned> slots(mask + 1u, Error::INVALID_INDEX);
 
-  vec3 move = m_Origin - oldOrigin;
+  // Per edge, the first half-edge found on it and how many have been
+  constexpr uint8_t NonManifold = 3u;
+  vector<unsigned> firstHalfEdge;
+  vector<uint8_t> useCount;
+  halfEdges.Edges.reserve(halfEdgeCount / 2u + 1u);
+  firstHalfEdge.reserve(halfEdgeCount / 2u + 1u);
+  useCount.reserve(halfEdgeCount / 2u + 1u);
+
+  const auto markNonManifold = [&](const unsigned edge)
+  {
+    const unsigned first = firstHalfEdge[edge];
+    if (halfEdges.Twins[first] != Error::INVALID_INDEX)
+    {
+      halfEdges.Twins[halfEdges.Twins[first]] = Error::INVALID_INDEX;
+      halfEdges.Twins[first] = Error::INVALID_INDEX;
+    }
+    useCount[edge] = NonManifold;
+    halfEdges.NonManifoldEdges.push_back(edge);
+  };
 
-  for (vec3& v : m_PositionArray)
+  for (unsigned t = 0u; t < triangleArray.size(); ++t)
   {
-    v -= move;
+    const Triangle& tri = triangleArray[t];
+    if (tri.Index1 == tri.Index2 || tri.Index2 == tri.Index3 || tri.Index1 == tri.Index3)
+      continue;
+
+    const unsigned corners[3] = { tri.Index1, tri.Index2, tri.Index3 };
+    for (unsigned corner = 0u; corner < 3u; ++corner)
+    {
+      const unsigned halfEdge = 3u * t + corner;
+      const unsigned from = corners[corner];
+      const unsigned to = corners[corner == 2u ? 0u : corner + 1u];
+      const unsigned low = std::min(from, to);
+      const unsigned high = std::max(from, to);
+
+      // Fibonacci hashing of the vertex pair, then linear probing
+      const uint64_t key = (uint64_t(low) << 32u) | uint64_t(high);
+      size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64u - bits));
+      while (slots[slot] != Error::INVALID_INDEX)
+      {
+        const Edge& edge = halfEdges.Edges[slots[slot]];
+        if (std::min(edge.Index1, edge.Index2) == low && std::max(edge.Index1, edge.Index2) == high)
+          break;
+        slot = (slot + 1u) & mask;
+      }
+
+      unsigned edge = slots[slot];
+      if (edge == Error::INVALID_INDEX)
+      {
+        edge = static_cast<unsigned>(halfEdges.Edges.size());
+        slots[slot] = edge;
+        halfEdges.Edges.emplace_back(from, to);
+        firstHalfEdge.push_back(halfEdge);
+        useCount.push_back(1u);
+      }
+      else if (useCount[edge] == 1u)
+      {
+        // The twin has to run the other way, otherwise the windings disagree
+        if (halfEdges.Edges[edge].Index1 == from)
+        {
+          markNonManifold(edge);
+        }
+        else
+        {
+          halfEdges.Twins[firstHalfEdge[edge]] = halfEdge;
+          halfEdges.Twins[halfEdge] = firstHalfEdge[edge];
+          useCount[edge] = 2u;
+        }
+      }
+      else if (useCount[edge] == 2u)
+      {
+        markNonManifold(edge);
+      }
+      halfEdges.EdgeIndices[halfEdge] = edge;
+    }
   }
 
-  for (vec3& sn : m_SurfaceNormalPositionArray)
+  // Now that the twins are final, prefer border half-edges so a walk around a
+  // vertex can start at one end of its fan and reach every triangle
+  for (unsigned halfEdge = 0u; halfEdge < halfEdgeCount; ++halfEdge)
   {
-    sn -= move;
+    if (halfEdges.EdgeIndices[halfEdge] == Error::INVALID_INDEX)
+      continue;
+
+    const Triangle& tri = triangleArray[HalfEdgeTable::TriangleOf(halfEdge)];
+    const unsigned corner = halfEdge % 3u;
+    const unsigned from = corner == 0u ? tri.Index1 : (corner == 1u ? tri.Index2 : tri.Index3);
+    unsigned& outgoing = halfEdges.Outgoing[from];
+    if (outgoing == Error::INVALID_INDEX ||
+      (halfEdges.Twins[halfEdge] == Error::INVALID_INDEX && halfEdges.Twins[outgoing] != Error::INVALID_INDEX))
+      outgoing = halfEdge;
   }
-  m_MeshIsDirty = true;
 }
 
-void Mesh::GenerateTexcoords(UV::Generation generation) noexcept
+Mesh::WeldReport Mesh::WeldVertices(const float relativeEpsilon) noexcept
 {
-  switch (generation)
+  WeldReport report{ 0u, 0u, 0u };
+  const size_t vertexCount = m_PositionArray.size();
+  const size_t triangleCount = m_TriangleArray.size();
+  if (vertexCount == 0u)
+    return report;
+
+  const BoundingBox& bounds = GetBoundingBox();
+  const float epsilon = relativeEpsilon *
+    glm::length(vec3(bounds.xMax - bounds.xMin, bounds.yMax - bounds.yMin, bounds.zMax - bounds.zMin));
+
+  // Generated normals and UVs are made again afterwards, only imported ones have to match
+  const bool keepNormals = m_NormalsAreCalculated && m_VertexNormalArray.size() == vertexCount;
+  const bool keepTexcoords = m_TexcoordsAreImported && m_TexcoordArray.size() == vertexCount;
+  unsigned keptCount = 0u;
+  const vector<unsigned> newVertices = MeshWelder::WeldVertices(m_PositionArray,
+    keepNormals ? &m_VertexNormalArray : nullptr, keepTexcoords ? &m_TexcoordArray : nullptr, epsilon, keptCount);
+  report.VerticesRemoved = static_cast<unsigned>(vertexCount) - keptCount;
+
+  compact(m_PositionArray, newVertices, keptCount);
+  compact(m_VertexNormalArray, newVertices, keptCount);
+  compact(m_TexcoordArray, newVertices, keptCount);
+  compact(m_VertexData, newVertices, keptCount);
+  compact(m_PackedVertexData, newVertices, keptCount);
+  compact(m_TangentArray, newVertices, keptCount);
+  compact(m_TangentData, newVertices, keptCount);
+  for (Triangle& tri : m_TriangleArray)
+    tri = Triangle(newVertices[tri.Index1], newVertices[tri.Index2], newVertices[tri.Index3]);
+
+  const vector<unsigned> keptTriangles = MeshWelder::CleanTriangles(m_PositionArray, m_TriangleArray, epsilon,
+    report.DegenerateTrianglesRemoved, report.DuplicateTrianglesRemoved);
+  const vector<unsigned> submeshes = getTriangleSubmeshes();
+  gather(m_TriangleArray, keptTriangles, triangleCount);
+  gather(m_SurfaceNormalArray, keptTriangles, triangleCount);
+  gather(m_SurfaceNormalPositionArray, keptTriangles, triangleCount);
+
+  // The kept triangles are in order, so each submesh is still a range and only shrinks
+  if (!submeshes.empty())
   {
-  case UV::Generation::SPHERICAL:
-    calculateSphereUVs();
-    break;
-  case UV::Generation::CYLINDRICAL:
-    calculateCylinderUVs();
-    break;
-  case UV::Generation::PLANAR:
-    calculatePlanarUVs();
-    break;
-  case UV::Generation::CUSTOM:
-  default:
-    break;
+    m_SubmeshArray.assign(m_MaterialNames.size(), Submesh{ 0u, 0u });
+    for (const unsigned t : keptTriangles)
+      ++m_SubmeshArray[submeshes[t]].TriangleCount;
+    for (size_t s = 1u; s < m_SubmeshArray.size(); ++s)
+      m_SubmeshArray[s].FirstTriangle = m_SubmeshArray[s - 1u].FirstTriangle + m_SubmeshArray[s - 1u].TriangleCount;
   }
+
+  // Everything built on the old vertex or triangle numbers is gone
+  m_VertexAdjacency.Offsets.clear();
+  m_HalfEdges.Twins.clear();
+  m_LodTriangleArray.clear();
+  m_LodArray.clear();
+  m_MeshletArray.clear();
   m_MeshIsDirty = true;
+  return report;
 }
 
-void Mesh::AssembleVertexData() noexcept
+Mesh::VertexCacheReport Mesh::OptimizeVertexCache() noexcept
 {
-  for (size_t i = 0; i < m_PositionArray.size(); ++i)
-  {
-    m_VertexData.emplace_back(m_PositionArray[i], m_VertexNormalArray[i], m_TexcoordArray[i]);
-  }
+  const size_t vertexCount = m_PositionArray.size();
+  VertexCacheReport report{ 0.f, 0.f };
+  if (m_TriangleArray.empty())
+    return report;
+
+  report.AcmrBefore = VertexCacheOptimizer::CalculateACMR(m_TriangleArray, vertexCount);
+
+  // One pass over the whole mesh, then each submesh keeps its share of the order
+  vector<unsigned> order = VertexCacheOptimizer::OptimizeTriangleOrder(m_TriangleArray, GetVertexAdjacency());
+  groupBySubmesh(order);
+  reorderTriangles(order);
+
+  // Renumbering doesn't change which vertices are cached, only where they are fetched from
+  const vector<unsigned> newVertices = VertexCacheOptimizer::OptimizeVertexFetch(m_TriangleArray, vertexCount);
+  scatter(m_PositionArray, newVertices);
+  scatter(m_VertexNormalArray, newVertices);
+  scatter(m_TexcoordArray, newVertices);
+  scatter(m_VertexData, newVertices);
+  scatter(m_PackedVertexData, newVertices);
+  scatter(m_TangentArray, newVertices);
+  scatter(m_TangentData, newVertices);
+  for (Triangle& tri : m_LodTriangleArray)
+    tri = Triangle(newVertices[tri.Index1], newVertices[tri.Index2], newVertices[tri.Index3]);
+
+  // The triangle numbers changed, the bounds did not
+  m_VertexAdjacency.Offsets.clear();
+  m_HalfEdges.Twins.clear();
+  m_MeshletArray.clear();
   m_MeshIsDirty = true;
+
+  report.AcmrAfter = VertexCacheOptimizer::CalculateACMR(m_TriangleArray, vertexCount);
+  return report;
 }
 
-void Mesh::calculateSurfaceNormals(bool flipNormals) noexcept
+void Mesh::GenerateLevelsOfDetail(const vector<float>& ratios, const bool optimizeVertexCache) noexcept
 {
-  m_SurfaceNormalArray.clear();
-  m_SurfaceNormalPositionArray.clear();
-  m_SurfaceNormalArray.resize(GetTriangleCount(), vec3(0.0f));
-  m_SurfaceNormalPositionArray.resize(GetTriangleCount(), vec3(0.0f));
+  m_LodTriangleArray.clear();
+  m_LodArray.clear();
+  m_SubmeshArray.resize(m_MaterialNames.size());
+  if (m_TriangleArray.empty())
+    return;
+
+  m_LodArray.push_back(LevelOfDetail{ 0u, GetTriangleCount(), 0.f });
+
+  // Errors are stored relative to the radius so they scale with the object
+  const BoundingBox& bounds = GetBoundingBox();
+  const float radius = 0.5f * glm::length(vec3(bounds.xMax - bounds.xMin, bounds.yMax - bounds.yMin, bounds.zMax - bounds.zMin));
+
+  // Submeshes are simplified on their own so no triangle changes material,
+  // a mesh without them is one range
+  const vector<Submesh> ranges = m_SubmeshArray.empty() ?
+    vector<Submesh>{ Submesh{ 0u, GetTriangleCount() } } : m_SubmeshArray;
 
-  for (size_t i = 0; i < m_TriangleArray.size(); ++i)
+  // Simplifying the previous level is cheaper than starting from full detail
+  // every time. Its error builds on the previous level's, so they add up.
+  vector<vector<Triangle>> previous(ranges.size());
+  for (size_t s = 0u; s < ranges.size(); ++s)
+    previous[s].assign(m_TriangleArray.begin() + ranges[s].FirstTriangle,
+      m_TriangleArray.begin() + ranges[s].FirstTriangle + ranges[s].TriangleCount);
+  vector<float> errors(ranges.size(), 0.f);
+  vector<bool> locked(ranges.size(), false);
+
+  for (const float ratio : ratios)
   {
-    Mesh::Triangle& tri = m_TriangleArray[i];
-    vec3 v1 = m_PositionArray[tri.Index1];
-    vec3 v2 = m_PositionArray[tri.Index2];
-    vec3 v3 = m_PositionArray[tri.Index3];
+    bool attempted = false;
+    bool reduced = false;
+    vector<vector<Triangle>> levels(ranges.size());
+    for (size_t s = 0u; s < ranges.size(); ++s)
+    {
+      const size_t target = static_cast<size_t>(ratio * static_cast<float>(ranges[s].TriangleCount));
+      if (locked[s] || target == 0u || target >= previous[s].size())
+        continue;
+      attempted = true;
 
-    vec3 e1 = v2 - v1;
-    vec3 e2 = v3 - v1;
+      float levelError = 0.f;
+      levels[s] = MeshSimplifier::Simplify(m_PositionArray, previous[s], target, &levelError);
+      // Everything left is locked in place, coarser levels would be the same
+      if (levels[s].empty() || levels[s].size() >= previous[s].size())
+      {
+        levels[s].clear();
+        locked[s] = true;
+        continue;
+      }
+      reduced = true;
+      errors[s] += levelError;
 
-    vec3 n = normalize(cross(e1, e2));
+      if (optimizeVertexCache)
+      {
+        VertexAdjacency adjacency;
+        BuildVertexAdjacency(levels[s], m_PositionArray.size(), adjacency);
+        const vector<unsigned> order = VertexCacheOptimizer::OptimizeTriangleOrder(levels[s], adjacency);
+        vector<Triangle> ordered;
+        ordered.reserve(order.size());
+        for (const unsigned t : order)
+          ordered.push_back(levels[s][t]);
+        levels[s].swap(ordered);
+      }
+    }
+    if (!reduced)
+    {
+      if (attempted)
+        break;
+      continue;
+    }
 
-    m_SurfaceNormalArray[i] = flipNormals ? -1.f * n : n;
+    // Submeshes that couldn't go further carry their previous triangles into this level
+    const unsigned first = GetTriangleCount() + static_cast<unsigned>(m_LodTriangleArray.size());
+    float error = 0.f;
+    for (size_t s = 0u; s < ranges.size(); ++s)
+    {
+      if (!levels[s].empty())
+        previous[s] = std::move(levels[s]);
+      error = std::max(error, errors[s]);
+      if (!m_MaterialNames.empty())
+        m_SubmeshArray.push_back(Submesh{
+          GetTriangleCount() + static_cast<unsigned>(m_LodTriangleArray.size()), static_cast<unsigned>(previous[s].size()) });
+      m_LodTriangleArray.insert(m_LodTriangleArray.end(), previous[s].begin(), previous[s].end());
+    }
 
-    m_SurfaceNormalPositionArray[i] = 1.f / 3.f * (v1 + v2 + v3);
+    m_LodArray.push_back(LevelOfDetail{
+      first,
+      GetTriangleCount() + static_cast<unsigned>(m_LodTriangleArray.size()) - first,
+      radius > 0.f ? error / radius : 0.f });
   }
-  m_MeshIsDirty = true;
 }
 
-void Mesh::calculateVertexNormals() noexcept
+void Mesh::BuildMeshlets(const bool optimizeVertexCache) noexcept
 {
-  m_VertexNormalArray.clear();
-  m_VertexNormalArray.resize(GetVertexCount(), vec3(0.0f));
-
-  vector<pair<vec3, float>> normArray(m_VertexNormalArray.size(), make_pair(vec3(0.f), 0.f));
-  for (size_t i = 0; i < m_SurfaceNormalArray.size(); ++i)
+  vector<unsigned> order;
+  vector<Meshlet> meshlets;
+  if (m_SubmeshArray.empty())
   {
-    Mesh::Triangle& tri = m_TriangleArray[i];
-    vec3 sN = m_SurfaceNormalArray[i];
-
-    // first - Surface Normal
-    normArray[tri.Index1].first += sN;
-    normArray[tri.Index2].first += sN;
-    normArray[tri.Index3].first += sN;
-    // second - triangles shared
-    ++normArray[tri.Index1].second;
-    ++normArray[tri.Index2].second;
-    ++normArray[tri.Index3].second;
+    meshlets = MeshletBuilder::Build(m_PositionArray, m_TriangleArray, GetVertexAdjacency(), order);
   }
-
-  for (size_t i = 0; i < normArray.size(); ++i)
+  else
   {
-    if (normArray[i].second > 0.f)
+    // Each submesh is clustered on its own so no meshlet crosses a material
+    order.reserve(m_TriangleArray.size());
+    for (size_t s = 0u; s < m_MaterialNames.size(); ++s)
     {
-      m_VertexNormalArray[i] = 1.f / normArray[i].second * normArray[i].first;
+      const Submesh& range = m_SubmeshArray[s];
+      if (range.TriangleCount == 0u)
+        continue;
+
+      const vector<Triangle> triangles(m_TriangleArray.begin() + range.FirstTriangle,
+        m_TriangleArray.begin() + range.FirstTriangle + range.TriangleCount);
+      VertexAdjacency adjacency;
+      BuildVertexAdjacency(triangles, m_PositionArray.size(), adjacency);
+      vector<unsigned> rangeOrder;
+      for (Meshlet& meshlet : MeshletBuilder::Build(m_PositionArray, triangles, adjacency, rangeOrder))
+      {
+        meshlet.FirstTriangle += range.FirstTriangle;
+        meshlets.push_back(meshlet);
+      }
+      for (const unsigned t : rangeOrder)
+        order.push_back(range.FirstTriangle + t);
     }
   }
-  m_MeshIsDirty = true;
+
+  // Clustering regroups the triangles, which undoes the vertex cache order.
+  // Ordering the triangles within each meshlet gets most of it back.
+  if (optimizeVertexCache)
+    optimizeMeshletTriangles(m_TriangleArray, m_PositionArray.size(), meshlets, order);
+  reorderTriangles(order);
+  m_MeshletArray = std::move(meshlets);
 }
 
-void Mesh::calculatePlanarUVs() noexcept
+void Mesh::SetSubmeshes(const vector<unsigned>& triangleMaterials, vector<string> materialNames) noexcept
 {
-  m_TexcoordArray.clear();
+  m_SubmeshArray.clear();
+  m_MaterialNames.clear();
+  m_LodTriangleArray.clear();
+  m_LodArray.clear();
+  if (triangleMaterials.size() != m_TriangleArray.size() || materialNames.empty())
+    return;
 
-  // First get the bounding box size
-  BoundingBox bounds = CalculateBoundingBox();
+  // Materials no triangle uses would only be empty draws
+  vector<unsigned> counts(materialNames.size(), 0u);
+  for (const unsigned material : triangleMaterials)
+    ++counts[material];
+  vector<unsigned> submeshes(materialNames.size(), Error::INVALID_INDEX);
+  unsigned used = 0u;
+  for (unsigned m = 0u; m < materialNames.size(); ++m)
+  {
+    if (counts[m] == 0u)
+      continue;
+    submeshes[m] = used;
+    counts[used] = counts[m];
+    if (used != m)
+      materialNames[used] = std::move(materialNames[m]);
+    ++used;
+  }
+  materialNames.resize(used);
 
-  for (const vec3& vertex : m_PositionArray)
+  // Counting sort by submesh, stable within each one
+  vector<unsigned> next(used, 0u);
+  for (unsigned s = 0u; s < used; ++s)
   {
-    float u = (vertex.x - bounds.xMin) / (bounds.xMax - bounds.xMin);
-    float v = (vertex.y - bounds.yMin) / (bounds.yMax - bounds.yMin);
-    m_TexcoordArray.emplace_back(u, v);
+    m_SubmeshArray.push_back(Submesh{ s == 0u ? 0u : next[s - 1u] + counts[s - 1u], counts[s] });
+    next[s] = m_SubmeshArray.back().FirstTriangle;
   }
+  vector<unsigned> order(m_TriangleArray.size());
+  for (unsigned t = 0u; t < order.size(); ++t)
+    order[next[submeshes[triangleMaterials[t]]]++] = t;
 
+  reorderTriangles(order);
+  m_MaterialNames = std::move(materialNames);
+}
+
+void Mesh::reorderTriangles(const vector<unsigned>& order) noexcept
+{
+  // The order gives the old triangle for each new slot, the arrays need the reverse
+  vector<unsigned> newTriangles(order.size());
+  for (unsigned slot = 0u; slot < order.size(); ++slot)
+    newTriangles[order[slot]] = slot;
+  scatter(m_TriangleArray, newTriangles);
+  scatter(m_SurfaceNormalArray, newTriangles);
+  scatter(m_SurfaceNormalPositionArray, newTriangles);
+
+  // The adjacency refers to triangle numbers, and the meshlets to ranges of them
+  m_VertexAdjacency.Offsets.clear();
+  m_HalfEdges.Twins.clear();
+  m_MeshletArray.clear();
   m_MeshIsDirty = true;
 }
 
-void Mesh::calculateSphereUVs() noexcept
+vector<unsigned> Mesh::getTriangleSubmeshes() const noexcept
 {
-  m_TexcoordArray.clear();
-  // First get the bounding box size
-  vec3 bounds = CalculateBoundingBoxSize();
-  // Find the centroid
-  vec3 centroid = FindCentroid();
+  vector<unsigned> submeshes;
+  if (m_MaterialNames.empty())
+    return submeshes;
 
-  // For each vertex
-  for (const vec3& vertex : m_PositionArray)
+  submeshes.assign(m_TriangleArray.size(), Error::INVALID_INDEX);
+  for (unsigned s = 0u; s < m_MaterialNames.size(); ++s)
   {
-    // Adjust vertex position by centroid
-    vec3 pos = vertex - centroid;
-    // Get first angle
-    float theta = glm::atan(pos.z / pos.x);
+    const Submesh& range = m_SubmeshArray[s];
+    std::fill(submeshes.begin() + range.FirstTriangle, submeshes.begin() + range.FirstTriangle + range.TriangleCount, s);
+  }
+  return submeshes;
+}
 
-    // Adjust angle by quadrant
-    if (pos.z < 0)
-    {
-      if (pos.x < 0)
-      {
-        theta += glm::pi<float>();
-      }
-      else
-      {
-        theta += glm::pi<float>() * 3.f / 2.f;
-      }
-    }
-    else
+void Mesh::groupBySubmesh(vector<unsigned>& order) const noexcept
+{
+  const vector<unsigned> submeshes = getTriangleSubmeshes();
+  if (submeshes.empty())
+    return;
+
+  // The submeshes keep their sizes, so their starts are where each one fills in
+  vector<unsigned> next(m_MaterialNames.size());
+  for (size_t s = 0u; s < next.size(); ++s)
+    next[s] = m_SubmeshArray[s].FirstTriangle;
+  vector<unsigned> grouped(order.size());
+  for (const unsigned t : order)
+    grouped[next[submeshes[t]]++] = t;
+  order.swap(grouped);
+}
+
+Mesh::QuantizationReport Mesh::QuantizeVertexData() noexcept
+{
+  const size_t vertexCount = m_VertexData.size();
+  m_PackedVertexData.resize(vertexCount);
+
+  vec3 offset, scale;
+  GetPositionDequantization(GetBoundingBox(), offset, scale);
+  const vec3 inverseScale(
+    scale.x > 0.f ? 1.f / scale.x : 0.f,
+    scale.y > 0.f ? 1.f / scale.y : 0.f,
+    scale.z > 0.f ? 1.f / scale.z : 0.f);
+
+  // Each range keeps its own worst case, merged once they are all done
+  std::mutex reportMutex;
+  QuantizationReport report{ 0.f, 0.f, 0.f };
+
+  parallelFor(vertexCount, [&](const size_t begin, const size_t end)
     {
-      if (pos.x < 0)
+      QuantizationReport local{ 0.f, 0.f, 0.f };
+      for (size_t i = begin; i < end; ++i)
       {
-        theta += glm::pi<float>() / 2.f;
+        const VertexData& vertex = m_VertexData[i];
+        PackedVertexData& packed = m_PackedVertexData[i];
+
+        const vec3 position = glm::round(glm::clamp((vertex.Position - offset) * inverseScale, 0.f, 1.f) * 65535.f);
+        packed.Position[0] = static_cast<uint16_t>(position.x);
+        packed.Position[1] = static_cast<uint16_t>(position.y);
+        packed.Position[2] = static_cast<uint16_t>(position.z);
+        packed.Position[3] = 0u;
+        packed.Normal = glm::packSnorm3x10_1x2(vec4(vertex.Normal, 0.f));
+        packed.Texcoord = glm::packHalf2x16(vertex.Texcoord);
+
+        // Unpack the way the GPU will, to measure what was lost
+        const vec3 unpackedPosition = offset + position * (1.f / 65535.f) * scale;
+        const vec3 unpackedNormal = vec3(glm::unpackSnorm3x10_1x2(packed.Normal));
+        const vec2 unpackedTexcoord = glm::unpackHalf2x16(packed.Texcoord);
+
+        local.MaxPositionError = std::max(local.MaxPositionError, glm::length(unpackedPosition - vertex.Position));
+        const float normalLength = glm::length(vertex.Normal) * glm::length(unpackedNormal);
+        if (normalLength > 0.f)
+        {
+          const float cosine = glm::clamp(dot(vertex.Normal, unpackedNormal) / normalLength, -1.f, 1.f);
+          local.MaxNormalError = std::max(local.MaxNormalError, glm::degrees(acosf(cosine)));
+        }
+        local.MaxTexcoordError = std::max(local.MaxTexcoordError, glm::length(unpackedTexcoord - vertex.Texcoord));
       }
-    }
 
-    // Get second angle
-    float phi = acos(pos.y / glm::length(pos));
+      std::lock_guard<std::mutex> lock(reportMutex);
+      report.MaxPositionError = std::max(report.MaxPositionError, local.MaxPositionError);
+      report.MaxNormalError = std::max(report.MaxNormalError, local.MaxNormalError);
+      report.MaxTexcoordError = std::max(report.MaxTexcoordError, local.MaxTexcoordError);
+    });
+
+  return report;
+}
+
+void Mesh::GetPositionDequantization(const BoundingBox& bounds, vec3& offset, vec3& scale) noexcept
+{
+  offset = vec3(bounds.xMin, bounds.yMin, bounds.zMin);
+  scale = vec3(bounds.xMax - bounds.xMin, bounds.yMax - bounds.yMin, bounds.zMax - bounds.zMin);
+}
+
+void Mesh::ReleaseArrays(const bool keepCollision) noexcept
+{
+  // Sweep the bounds while the positions are still here
+  const BoundingBox bounds = GetBoundingBox();
+
+  // Swapping with empty vectors frees the memory, clear() would keep it
+  vector<vec3>().swap(m_VertexNormalArray);
+  vector<vec3>().swap(m_SurfaceNormalArray);
+  vector<vec3>().swap(m_SurfaceNormalPositionArray);
+  vector<vec2>().swap(m_TexcoordArray);
+  vector<VertexData>().swap(m_VertexData);
+  vector<PackedVertexData>().swap(m_PackedVertexData);
+  vector<vec4>().swap(m_TangentArray);
+  vector<uint32_t>().swap(m_TangentData);
+  vector<Mesh::Triangle>().swap(m_LodTriangleArray);
+  m_VertexAdjacency = VertexAdjacency();
+  m_HalfEdges = HalfEdgeTable();
+  if (!keepCollision)
+  {
+    vector<vec3>().swap(m_PositionArray);
+    vector<Mesh::Triangle>().swap(m_TriangleArray);
+  }
+
+  SetBoundingBox(bounds);
+}
+
+void Mesh::SetBoundingBox(const BoundingBox& bounds) noexcept
+{
+  m_Bounds = bounds;
+  m_BoundsVertexCount = m_PositionArray.size();
+  m_BoundsAreCached = true;
+}
+
+void Mesh::ScaleToUnitSize() noexcept
+{
+  ScaleAndRecenter(true, false);
+}
+
+void Mesh::ScaleAndRecenter(const bool scaleToUnitSize, const bool resetOrigin) noexcept
+{
+  if (m_PositionArray.empty() || (!scaleToUnitSize && !resetOrigin))
+    return;
+
+  // At most one sweep for the bounds, both options follow from them
+  vec3 translation;
+  const float scale = prepareTransform(scaleToUnitSize, resetOrigin, translation);
+
+  // And one sweep to apply them
+  MeshKernels::ScaleTranslate(m_PositionArray.data(), m_PositionArray.size(), scale, translation);
+  MeshKernels::ScaleTranslate(m_SurfaceNormalPositionArray.data(), m_SurfaceNormalPositionArray.size(), scale, translation);
+  transformMeshlets(scale, translation);
+
+  // The box moves with the vertices, so it stays cached
+  m_Bounds = BoundingBox{
+    m_Bounds.xMin * scale + translation.x, m_Bounds.yMin * scale + translation.y, m_Bounds.zMin * scale + translation.z,
+    m_Bounds.xMax * scale + translation.x, m_Bounds.yMax * scale + translation.y, m_Bounds.zMax * scale + translation.z };
+
+  // So do the volumes, a uniform scale keeps their shape and the box's axes
+  m_BoundingVolumes.Aabb = m_Bounds;
+  m_BoundingVolumes.Sphere.Center = m_BoundingVolumes.Sphere.Center * scale + translation;
+  m_BoundingVolumes.Sphere.Radius *= std::abs(scale);
+  m_BoundingVolumes.Obb.Center = m_BoundingVolumes.Obb.Center * scale + translation;
+  m_BoundingVolumes.Obb.HalfExtents *= std::abs(scale);
+}
+
+vec3 Mesh::FindCentroid() const noexcept
+{
+  const BoundingBox& bounds = GetBoundingBox();
+
+  // Average the center of 
+  vec3 center(
+    bounds.xMin + ((bounds.xMax - bounds.xMin) / 2.f),
+    bounds.yMin + ((bounds.yMax - bounds.yMin) / 2.f),
+    bounds.zMin + ((bounds.zMax - bounds.zMin) / 2.f)
+  );
 
-    // Set the UVs
-    float u = theta / glm::two_pi<float>();
-    float v = (glm::pi<float>() - phi) / glm::pi<float>();
+  return center;
+}
 
-    m_TexcoordArray.emplace_back(u, v);
+void Mesh::ResetOriginToCentroid() noexcept
+{
+  ScaleAndRecenter(false, true);
+}
+
+void Mesh::GenerateTexcoords(UV::Generation generation) noexcept
+{
+  switch (generation)
+  {
+  case UV::Generation::SPHERICAL:
+  case UV::Generation::CYLINDRICAL:
+  case UV::Generation::PLANAR:
+  case UV::Generation::CUBE_MAP:
+    calculateProjectedUVs(generation);
+    break;
+  case UV::Generation::CUSTOM:
+  default:
+    break;
   }
   m_MeshIsDirty = true;
 }
 
-void Mesh::calculateCylinderUVs() noexcept
+void Mesh::AssembleVertexData() noexcept
 {
-  m_TexcoordArray.clear();
-  // First get the bounding box size
-  vec3 bounds = CalculateBoundingBoxSize();
-  // Find the centroid
-  vec3 centroid = FindCentroid();
+  transformAndAssemble(1.f, vec3(0.f), UV::Generation::CUSTOM);
+}
+
+float Mesh::prepareTransform(const bool scaleToUnitSize, const bool resetOrigin, vec3& translation) noexcept
+{
+  translation = vec3(0.f);
+  if (m_PositionArray.empty() || (!scaleToUnitSize && !resetOrigin))
+    return 1.f;
 
-  // For each vertex
-  for (const vec3& vertex : m_PositionArray)
+  const BoundingBox& bounds = GetBoundingBox();
+  const vec3 min(bounds.xMin, bounds.yMin, bounds.zMin);
+  const vec3 max(bounds.xMax, bounds.yMax, bounds.zMax);
+
+  // Ratio of v to the widest axis
+  const float widest = std::max(std::max(max.x - min.x, max.y - min.y), max.z - min.z);
+  const float scale = (scaleToUnitSize && widest > 0.f) ? 1.f / widest : 1.f;
+
+  // The centroid lands where the old origin was, the same as scaling and then recentering
+  if (resetOrigin)
   {
-    // Adjust vertex position by centroid
-    vec3 pos = vertex - centroid;
-    // Get the radial angle
-    float theta = glm::atan(pos.z / pos.x);
+    const vec3 oldOrigin = m_Origin;
+    m_Origin = (min + max) * 0.5f * scale;
+    translation = oldOrigin - m_Origin;
+    m_MeshIsDirty = true;
+  }
+  return scale;
+}
+
+void Mesh::transformAndAssemble(const float scale, const vec3& translation, const UV::Generation generation) noexcept
+{
+  const size_t vertexCount = m_PositionArray.size();
+  const bool isTransformed = scale != 1.f || translation != vec3(0.f);
+  const bool isProjected = generation != UV::Generation::CUSTOM;
+
+  // Where the box ends up, found from the cached one instead of another sweep
+  BoundingBox bounds{ 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+  if (isTransformed || isProjected)
+  {
+    const BoundingBox& current = GetBoundingBox();
+    bounds = BoundingBox{
+      current.xMin * scale + translation.x, current.yMin * scale + translation.y, current.zMin * scale + translation.z,
+      current.xMax * scale + translation.x, current.yMax * scale + translation.y, current.zMax * scale + translation.z };
+  }
+  const TexcoordProjection projection(generation, bounds);
 
-    // Adjust angle by quadrant
-    if (pos.z < 0)
+  // Meshes can arrive without normals or UVs, those vertices get zeros
+  const bool hasNormals = m_VertexNormalArray.size() >= vertexCount;
+  if (isProjected)
+    m_TexcoordArray.resize(vertexCount);
+  const bool hasTexcoords = m_TexcoordArray.size() >= vertexCount;
+
+  // Every entry is overwritten, so earlier data is replaced rather than appended to
+  m_VertexData.resize(vertexCount);
+  m_PackedVertexData.clear();
+
+  // Each block is transformed and projected by the kernels, then assembled
+  // while it is still in cache, so every vertex is read from memory once
+  constexpr size_t BlockSize = 1024u;
+  parallelFor(vertexCount, [&](const size_t begin, const size_t end)
     {
-      if (pos.x < 0)
+      for (size_t block = begin; block < end; block += BlockSize)
       {
-        theta += glm::pi<float>();
+        const size_t count = std::min(BlockSize, end - block);
+        if (isTransformed)
+          MeshKernels::ScaleTranslate(m_PositionArray.data() + block, count, scale, translation);
+        if (isProjected)
+          projection.Project(m_PositionArray.data() + block, count, m_TexcoordArray.data() + block);
+
+        for (size_t i = block; i < block + count; ++i)
+        {
+          m_VertexData[i] = VertexData{ m_PositionArray[i], hasNormals ? m_VertexNormalArray[i] : vec3(0.f),
+            hasTexcoords ? m_TexcoordArray[i] : vec2(0.f) };
+        }
       }
-      else
+    });
+
+  if (isTransformed)
+  {
+    MeshKernels::ScaleTranslate(m_SurfaceNormalPositionArray.data(), m_SurfaceNormalPositionArray.size(), scale, translation);
+    transformMeshlets(scale, translation);
+    m_Bounds = bounds;
+  }
+  m_MeshIsDirty = true;
+}
+
+void Mesh::transformMeshlets(const float scale, const vec3& translation) noexcept
+{
+  // A uniform scale keeps the spheres spheres and leaves the cones alone
+  for (Meshlet& meshlet : m_MeshletArray)
+  {
+    meshlet.Center = meshlet.Center * scale + translation;
+    meshlet.Radius *= std::abs(scale);
+  }
+}
+
+void Mesh::calculateSurfaceNormals(bool flipNormals, vector<float>* areas) noexcept
+{
+  // Every entry is overwritten below
+  m_SurfaceNormalArray.resize(GetTriangleCount());
+  m_SurfaceNormalPositionArray.resize(GetTriangleCount());
+  if (areas)
+    areas->resize(GetTriangleCount());
+
+  const float sign = flipNormals ? -1.f : 1.f;
+
+  // Each triangle only writes its own entries, so the ranges run independently
+  parallelFor(m_TriangleArray.size(), [&](const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
       {
-        theta += glm::pi<float>() * 3.f / 2.f;
+        const Mesh::Triangle& tri = m_TriangleArray[i];
+        const vec3& v1 = m_PositionArray[tri.Index1];
+        const vec3& v2 = m_PositionArray[tri.Index2];
+        const vec3& v3 = m_PositionArray[tri.Index3];
+
+        // The cross product's length is twice the area, a degenerate triangle gets no normal
+        const vec3 n = cross(v2 - v1, v3 - v1);
+        const float length = glm::length(n);
+        m_SurfaceNormalArray[i] = length > 0.f ? n * (sign / length) : vec3(0.f);
+        if (areas)
+          (*areas)[i] = 0.5f * length;
+
+        m_SurfaceNormalPositionArray[i] = 1.f / 3.f * (v1 + v2 + v3);
       }
-    }
-    else
+    });
+  m_MeshIsDirty = true;
+}
+
+void Mesh::calculateVertexNormals(const NormalWeighting weighting, const vector<float>& areas) noexcept
+{
+  const VertexAdjacency& adjacency = GetVertexAdjacency();
+  m_VertexNormalArray.resize(GetVertexCount());
+
+  // Each vertex gathers from its own triangles and writes only its own normal,
+  // so threads never write the same entry and need no atomics
+  parallelFor(m_VertexNormalArray.size(), [&](const size_t begin, const size_t end)
     {
-      if (pos.x < 0)
+      for (size_t v = begin; v < end; ++v)
       {
-        theta += glm::pi<float>() / 2.f;
+        vec3 sum(0.f);
+        for (unsigned k = adjacency.Offsets[v]; k < adjacency.Offsets[v + 1u]; ++k)
+        {
+          const unsigned t = adjacency.Triangles[k];
+          switch (weighting)
+          {
+          case NormalWeighting::AREA:
+            sum += m_SurfaceNormalArray[t] * areas[t];
+            break;
+          case NormalWeighting::ANGLE:
+            sum += m_SurfaceNormalArray[t] * cornerAngle(m_PositionArray, m_TriangleArray[t], static_cast<unsigned>(v));
+            break;
+          case NormalWeighting::UNIFORM:
+          default:
+            sum += m_SurfaceNormalArray[t];
+            break;
+          }
+        }
+
+        // Vertices without triangles keep a zero normal
+        const float length = glm::length(sum);
+        m_VertexNormalArray[v] = length > 0.f ? sum / length : vec3(0.f);
       }
-    }
+    });
+  m_MeshIsDirty = true;
+}
 
-    // U is based on radial angle
-    float u = theta / glm::two_pi<float>();
-    // V is based on cylinder height
-    float v = (pos.y - bounds.y / -2.f) / bounds.y;
+void Mesh::calculateProjectedUVs(const UV::Generation generation) noexcept
+{
+  // The bounds are cached, so this is a single sweep over the vertices
+  const TexcoordProjection projection(generation, GetBoundingBox());
+
+  m_TexcoordArray.resize(m_PositionArray.size());
+  parallelFor(m_PositionArray.size(), [&](const size_t begin, const size_t end)
+    {
+      projection.Project(m_PositionArray.data() + begin, end - begin, m_TexcoordArray.data() + begin);
+    });
 
-    m_TexcoordArray.emplace_back(u, v);
-  }
   m_MeshIsDirty = true;
 }
 
-void Mesh::calculateCubeMapUVs() noexcept
+Mesh::TexcoordProjection::TexcoordProjection(const UV::Generation generation, const BoundingBox& bounds) noexcept :
+  Generation(generation),
+  Min(bounds.xMin, bounds.yMin, bounds.zMin),
+  InverseSize(0.f),
+  Center((bounds.xMin + bounds.xMax) * 0.5f, (bounds.yMin + bounds.yMax) * 0.5f, (bounds.zMin + bounds.zMax) * 0.5f)
+{
+  const vec3 size(bounds.xMax - bounds.xMin, bounds.yMax - bounds.yMin, bounds.zMax - bounds.zMin);
+  for (int axis = 0; axis < 3; ++axis)
+    InverseSize[axis] = size[axis] > 0.f ? 1.f / size[axis] : 0.f;
+}
+
+void Mesh::TexcoordProjection::Project(const vec3* positions, const size_t count, vec2* texcoords) const noexcept
 {
-  Log::Error("Mesh::calculateCubeMapUVs not implemented.");
+  MeshKernels::ProjectTexcoords(positions, count, Generation, Min, Center, InverseSize, texcoords);
 }
@@ -7,6 +7,8 @@
 #pragma once
 #include "GraphicsCommon.h" // GLEW and Common Graphics types
 
+namespace MeshPostProcess { struct Pipeline; }
+
   class Mesh
   {
 #pragma region Features
@@ -22,6 +24,18 @@
       vec2 Texcoord;  // Texture UV Coordinates
     };
 
+    /// <summary>
+    /// VertexData packed to half the size. Positions are unsigned normalized
+    /// within the bounding box and are dequantized in the vertex shader, the
+    /// normal is signed normalized 10-10-10-2 and the UVs are half floats.
+    /// </summary>
+    struct PackedVertexData
+    {
+      uint16_t Position[4]; // X, Y, Z across the bounding box, and padding
+      uint32_t Normal;      // GL_INT_2_10_10_10_REV
+      uint32_t Texcoord;    // Two GL_HALF_FLOAT
+    };
+
     /// <summary>
     /// Index-based data structure for mesh edges
     /// </summary>
@@ -56,6 +70,142 @@
       float xMin, yMin, zMin, xMax, yMax, zMax;
     };
 
+    /// <summary>
+    /// A sphere around the mesh in object space
+    /// </summary>
+    struct BoundingSphere
+    {
+      vec3 Center = vec3(0.f);
+      float Radius = 0.f;
+    };
+
+    /// <summary>
+    /// A box around the mesh in object space, turned to fit it. It spans
+    /// Center +- HalfExtents[i] * Axes[i], the axes are orthonormal.
+    /// </summary>
+    struct OrientedBox
+    {
+      vec3 Center = vec3(0.f);
+      vec3 Axes[3] = { vec3(1.f, 0.f, 0.f), vec3(0.f, 1.f, 0.f), vec3(0.f, 0.f, 1.f) };
+      vec3 HalfExtents = vec3(0.f);
+    };
+
+    /// <summary>
+    /// The bounds culling, level of detail selection and picking test against,
+    /// fitted once after processing so none of them need the vertices
+    /// </summary>
+    struct BoundingVolumes
+    {
+      BoundingBox Aabb{ 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+      BoundingSphere Sphere;  // Within a few percent of the smallest
+      OrientedBox Obb;        // Along the principal axes, or the AABB when that is tighter
+    };
+
+    /// <summary>
+    /// The triangles around every vertex in compressed sparse row form. The
+    /// triangles using vertex v are Triangles[Offsets[v]] up to Triangles[Offsets[v + 1]].
+    /// </summary>
+    struct VertexAdjacency
+    {
+      vector<unsigned> Offsets;   // One per vertex, plus the end of the last one
+      vector<unsigned> Triangles; // Incident triangle indices, three entries per triangle
+    };
+
+    /// <summary>
+    /// Half-edges of the triangles in flat arrays. Half-edge h runs along
+    /// triangle h / 3 from its corner h % 3 to the next corner, so the triangle
+    /// and the next half-edge follow from the index and the start vertex is
+    /// read from the triangle. Only the twins and the edges need storing.
+    /// </summary>
+    struct HalfEdgeTable
+    {
+      vector<unsigned> Twins;       // Opposite half-edge of each half-edge, INVALID_INDEX on borders and non-manifold edges
+      vector<unsigned> EdgeIndices; // Undirected edge each half-edge lies on, an index into Edges
+      vector<unsigned> Outgoing;    // A half-edge leaving each vertex, a border one if it has any, INVALID_INDEX if unused
+      vector<Edge> Edges;           // Every undirected edge once, in the order first found
+      vector<unsigned> NonManifoldEdges; // Edges on more than two triangles, or on two that wind it the same way
+
+      static inline unsigned Next(const unsigned halfEdge) noexcept { return halfEdge % 3u == 2u ? halfEdge - 2u : halfEdge + 1u; }
+      static inline unsigned Prev(const unsigned halfEdge) noexcept { return halfEdge % 3u == 0u ? halfEdge + 2u : halfEdge - 1u; }
+      static inline unsigned TriangleOf(const unsigned halfEdge) noexcept { return halfEdge / 3u; }
+    };
+
+    /// <summary>
+    /// How each triangle's normal counts towards the normals of its vertices
+    /// </summary>
+    enum class NormalWeighting
+    {
+      UNIFORM,  // Every incident triangle counts the same
+      AREA,     // Larger triangles count more
+      ANGLE     // Triangles count by the angle of their corner at the vertex
+    };
+
+    /// <summary>
+    /// Average cache miss ratio (vertex shader runs per triangle) of the
+    /// triangle order before and after OptimizeVertexCache
+    /// </summary>
+    struct VertexCacheReport
+    {
+      float AcmrBefore;
+      float AcmrAfter;
+    };
+
+    /// <summary>
+    /// One level of detail, a range of the index buffer. The full detail
+    /// triangles come first and the coarser levels follow them.
+    /// </summary>
+    struct LevelOfDetail
+    {
+      unsigned FirstTriangle; // Offset of the level in the index buffer, in triangles
+      unsigned TriangleCount; // Triangles in the level
+      float Error;            // Largest deviation from the full detail surface, relative to the bounding radius
+    };
+
+    /// <summary>
+    /// The triangles of one material, a range of the index buffer. Every
+    /// submesh of a level of detail lies within that level's range.
+    /// </summary>
+    struct Submesh
+    {
+      unsigned FirstTriangle; // Offset of the submesh in the index buffer, in triangles
+      unsigned TriangleCount; // Triangles in the submesh, may be 0 once welding or simplifying removed them all
+    };
+
+    /// <summary>
+    /// A cluster of neighbouring full detail triangles, a range of the index
+    /// buffer with the bounds to cull it by as a whole
+    /// </summary>
+    struct Meshlet
+    {
+      unsigned FirstTriangle; // Offset of the meshlet in the index buffer, in triangles
+      unsigned TriangleCount; // Triangles in the meshlet
+      vec3 Center;            // Bounding sphere in object space
+      float Radius;
+      vec3 ConeApex;          // Point behind every triangle's plane, the cone is tested from here
+      vec3 ConeAxis;          // Average triangle normal
+      float ConeCutoff;       // Sine of the normal cone's half angle, 1 if it can't be culled
+    };
+
+    /// <summary>
+    /// What WeldVertices removed
+    /// </summary>
+    struct WeldReport
+    {
+      unsigned VerticesRemoved;             // Vertices welded onto another one
+      unsigned DegenerateTrianglesRemoved;  // Triangles with a repeated vertex or no area
+      unsigned DuplicateTrianglesRemoved;   // Triangles repeating an earlier one
+    };
+
+    /// <summary>
+    /// Largest difference between the packed and the float vertex data
+    /// </summary>
+    struct QuantizationReport
+    {
+      float MaxPositionError; // Object space distance
+      float MaxNormalError;   // Angle in degrees
+      float MaxTexcoordError; // Distance in UV space
+    };
+
   public:
     /// <summary>
     /// Default constructor
@@ -68,6 +218,10 @@
     /// Default destructor
     /// </summary>
     ~Mesh() = default;
+    Mesh(const Mesh&) = default;
+    Mesh& operator=(const Mesh&) = default;
+    Mesh(Mesh&&) noexcept = default;
+    Mesh& operator=(Mesh&&) noexcept = default;
 
     /// <summary>
     /// Gets the number of vertices of the mesh
@@ -131,6 +285,15 @@
     /// <returns></returns>
     void AddTriangle(unsigned index1, unsigned index2, unsigned index3) noexcept;
 
+    /// <summary>
+    /// Allocates room for the final size of the mesh up front, so adding
+    /// vertices and triangles one at a time never reallocates
+    /// </summary>
+    /// <param name="vertexCount">Total number of vertices the mesh will hold</param>
+    /// <param name="triangleCount">Total number of triangles the mesh will hold</param>
+    /// <param name="withAttributes">[T/F] Also reserve vertex normals and UV coordinates</param>
+    void Reserve(unsigned vertexCount, unsigned triangleCount, bool withAttributes = true) noexcept;
+
     /// <summary>
     /// Sets the origin of the mesh to a new location in object space
     /// </summary>
@@ -153,7 +316,13 @@
     /// Sets that the normals have been calculated
     /// </summary>
     /// <param name="isStatic">[T/F] The normals have been calculated</param>
-    inline void SetNormalsAreCalculated(bool areNormalsCalculated) noexcept { m_MeshIsStatic = areNormalsCalculated; }
+    inline void SetNormalsAreCalculated(bool areNormalsCalculated) noexcept { m_NormalsAreCalculated = areNormalsCalculated; }
+
+    /// <summary>
+    /// Sets that the UV coordinates were imported with the mesh
+    /// </summary>
+    /// <param name="areTexcoordsImported">[T/F] The UV coordinates were imported</param>
+    inline void SetTexcoordsAreImported(bool areTexcoordsImported) noexcept { m_TexcoordsAreImported = areTexcoordsImported; }
 
     /// <summary>
     /// Gets whether or not the mesh is set to be static
@@ -167,6 +336,12 @@
     /// <returns>[T/F] The mesh has normals calculated</returns>
     inline bool NormalsAreCalculated() const noexcept { return m_NormalsAreCalculated; }
 
+    /// <summary>
+    /// Gets whether or not the UV coordinates were imported and shouldn't be generated
+    /// </summary>
+    /// <returns>[T/F] The mesh has imported UV coordinates</returns>
+    inline bool TexcoordsAreImported() const noexcept { return m_TexcoordsAreImported; }
+
     /// <summary>
     /// Gets the Vertex Normal Array
     /// </summary>
@@ -191,18 +366,50 @@
     /// <returns>[Const Ref] The vector of UV coordinates</returns>
     const vector<vec2>& GetTexcoordArray() const noexcept;
 
+    /// <summary>
+    /// Gets the Tangent Array, the bitangent is w * cross(normal, tangent)
+    /// </summary>
+    /// <returns>[Const Ref] The vector of tangents, empty until CalculateTangents</returns>
+    inline const vector<vec4>& GetTangentArray() const noexcept { return m_TangentArray; }
+
+    /// <summary>
+    /// Gets whether the tangent stream has been calculated for the GPU
+    /// </summary>
+    /// <returns>[T/F] CalculateTangents has filled the tangent stream</returns>
+    inline bool HasTangents() const noexcept { return !m_TangentData.empty(); }
+
     /// <summary>
     /// Calculates the bounding box around the mesh in object space (min->max in x,y,z)
     /// </summary>
     /// <returns>A structure of min/max in x,y,z</returns>
     BoundingBox CalculateBoundingBox() const noexcept;
 
+    /// <summary>
+    /// Gets the bounding box, only sweeping the vertices if they were added to
+    /// or moved since it was last calculated
+    /// </summary>
+    /// <returns>[Const Ref] The cached min/max in x,y,z</returns>
+    const BoundingBox& GetBoundingBox() const noexcept;
+
     /// <summary>
     /// Calculates the bounding box size around the mesh in object space (min->max in x,y,z)
     /// </summary>
     /// <returns>A 3 float vector of the length between min and max in each dimension</returns>
     vec3 CalculateBoundingBoxSize() noexcept;
 
+    /// <summary>
+    /// Fits the bounding box, sphere and oriented box around the vertices.
+    /// Call it once the positions are final, ScaleAndRecenter is the only
+    /// change after it that the volumes follow.
+    /// </summary>
+    void CalculateBoundingVolumes() noexcept;
+
+    /// <summary>
+    /// Gets the volumes CalculateBoundingVolumes fitted, without touching the vertices
+    /// </summary>
+    /// <returns>[Const Ref] The bounding volumes, all empty until calculated</returns>
+    inline const BoundingVolumes& GetBoundingVolumes() const noexcept { return m_BoundingVolumes; }
+
     /// <summary>
     /// Calculates the greatest width of the three dimensions
     /// </summary>
@@ -213,13 +420,190 @@
     /// Calculates the normals based on current vertices
     /// </summary>
     /// <param name="flipNormals">[T/F] The normals should be inverted</param>
-    void CalculateNormals(bool flipNormals = false) noexcept;
+    /// <param name="weighting">How triangle normals are blended into vertex normals</param>
+    void CalculateNormals(bool flipNormals = false, NormalWeighting weighting = NormalWeighting::UNIFORM) noexcept;
+
+    /// <summary>
+    /// Calculates a tangent per vertex for normal mapping, in the MikkTSpace
+    /// convention: each triangle's UV gradient is projected onto the tangent
+    /// plane of the vertex normal and weighted by the corner angle, and w holds
+    /// the sign of the bitangent. Triangles are processed in parallel, then
+    /// each vertex sums its own triangles in a fixed order, so the result
+    /// doesn't depend on the thread count. Also packs the GPU tangent stream.
+    /// </summary>
+    void CalculateTangents() noexcept;
+
+    /// <summary>
+    /// Gets the vertex to triangle adjacency, building it first if the vertex
+    /// or triangle count changed since it was last built
+    /// </summary>
+    /// <returns>[Const Ref] The adjacency table</returns>
+    const VertexAdjacency& GetVertexAdjacency() noexcept;
+
+    /// <summary>
+    /// Builds the vertex to triangle adjacency of any triangle list
+    /// </summary>
+    /// <param name="triangles">[Const Ref] The triangles</param>
+    /// <param name="vertexCount">Number of vertices the triangles index</param>
+    /// <param name="adjacency">[Out] Receives the adjacency table</param>
+    static void BuildVertexAdjacency(const vector<Triangle>& triangles, size_t vertexCount, VertexAdjacency& adjacency) noexcept;
+
+    /// <summary>
+    /// Gets the half-edge table, building it first if the vertex or triangle
+    /// count changed since it was last built
+    /// </summary>
+    /// <returns>[Const Ref] The half-edge table</returns>
+    const HalfEdgeTable& GetHalfEdges() noexcept;
+
+    /// <summary>
+    /// Builds the half-edge table of any triangle list. Edges are matched up
+    /// through an open addressing hash of their vertex pairs, in time linear
+    /// in the triangle count. Degenerate triangles keep their half-edges but
+    /// are left unmatched.
+    /// </summary>
+    /// <param name="triangles">[Const Ref] The triangles</param>
+    /// <param name="vertexCount">Number of vertices the triangles index</param>
+    /// <param name="halfEdges">[Out] Receives the half-edge table</param>
+    static void BuildHalfEdges(const vector<Triangle>& triangles, size_t vertexCount, HalfEdgeTable& halfEdges) noexcept;
+
+    /// <summary>
+    /// Welds vertices closer than epsilon, then drops the triangles that became
+    /// degenerate and those repeating another. Imported normals and UVs have to
+    /// match as well, so seams and hard edges the file defines survive.
+    /// Levels of detail and meshlets are dropped, so call it first.
+    /// </summary>
+    /// <param name="relativeEpsilon">Weld distance as a fraction of the bounding box diagonal</param>
+    /// <returns>How many vertices and triangles were removed</returns>
+    WeldReport WeldVertices(float relativeEpsilon) noexcept;
+
+    /// <summary>
+    /// Reorders the triangles for the post-transform vertex cache, then
+    /// renumbers the vertices in the order the triangles first use them so the
+    /// vertex fetch is sequential. Every per-vertex and per-triangle array moves along.
+    /// </summary>
+    /// <returns>The average cache miss ratio before and after</returns>
+    VertexCacheReport OptimizeVertexCache() noexcept;
+
+    /// <summary>
+    /// Builds a chain of simplified levels of detail that share the vertices
+    /// of the full detail mesh. Each level simplifies the one before it.
+    /// </summary>
+    /// <param name="ratios">[Const Ref] Triangle count of each level as a fraction of full detail, decreasing</param>
+    /// <param name="optimizeVertexCache">[T/F] Reorder each level's triangles for the vertex cache</param>
+    void GenerateLevelsOfDetail(const vector<float>& ratios, bool optimizeVertexCache) noexcept;
+
+    /// <summary>
+    /// Gets the levels of detail, full detail first. Empty until GenerateLevelsOfDetail.
+    /// </summary>
+    /// <returns>[Const Ref] The ranges of each level in the index buffer</returns>
+    inline const vector<LevelOfDetail>& GetLevelsOfDetail() const noexcept { return m_LodArray; }
+
+    /// <summary>
+    /// Groups the full detail triangles into meshlets for cluster culling and
+    /// reorders them so each meshlet is a range of the index buffer. Reordering
+    /// the triangles again drops the meshlets, so call it after OptimizeVertexCache.
+    /// </summary>
+    /// <param name="optimizeVertexCache">[T/F] Order the triangles within each meshlet for the vertex cache</param>
+    void BuildMeshlets(bool optimizeVertexCache = false) noexcept;
+
+    /// <summary>
+    /// Gets the meshlets, in index buffer order. Empty until BuildMeshlets.
+    /// </summary>
+    /// <returns>[Const Ref] The meshlets covering the full detail triangles</returns>
+    inline const vector<Meshlet>& GetMeshlets() const noexcept { return m_MeshletArray; }
+
+    /// <summary>
+    /// Splits the full detail triangles into one submesh per material and
+    /// groups them so each submesh is a range of the index buffer. Triangles
+    /// keep their order within a submesh. Materials no triangle uses are
+    /// dropped. Levels of detail and meshlets are dropped as well, the steps
+    /// after this keep the submeshes apart.
+    /// </summary>
+    /// <param name="triangleMaterials">[Const Ref] Index into materialNames of each full detail triangle</param>
+    /// <param name="materialNames">The name of each material, as the material library knows it</param>
+    void SetSubmeshes(const vector<unsigned>& triangleMaterials, vector<string> materialNames) noexcept;
+
+    /// <summary>
+    /// Gets the submeshes, GetSubmeshCount ranges of full detail followed by as
+    /// many for each coarser level of detail. Empty for a single material mesh.
+    /// </summary>
+    /// <returns>[Const Ref] The ranges of each submesh in the index buffer</returns>
+    inline const vector<Submesh>& GetSubmeshes() const noexcept { return m_SubmeshArray; }
+
+    /// <summary>
+    /// Gets the number of materials the mesh is split by
+    /// </summary>
+    /// <returns>The submeshes per level of detail, 0 for a single material mesh</returns>
+    inline unsigned GetSubmeshCount() const noexcept { return static_cast<unsigned>(m_MaterialNames.size()); }
+
+    /// <summary>
+    /// Gets the material name of each submesh, empty for triangles that came before any material
+    /// </summary>
+    /// <returns>[Const Ref] One name per submesh</returns>
+    inline const vector<string>& GetMaterialNames() const noexcept { return m_MaterialNames; }
+
+    /// <summary>
+    /// Sets the material library the submesh materials are looked up in
+    /// </summary>
+    /// <param name="library">[Const Ref] Path of the library under the model directory</param>
+    inline void SetMaterialLibrary(const string& library) noexcept { m_MaterialLibrary = library; }
+
+    /// <summary>
+    /// Gets the material library the submesh materials are looked up in
+    /// </summary>
+    /// <returns>[Const Ref] Path of the library under the model directory, empty if there is none</returns>
+    inline const string& GetMaterialLibrary() const noexcept { return m_MaterialLibrary; }
+
+    /// <summary>
+    /// Packs the assembled vertex data into PackedVertexData for upload.
+    /// Positions are quantized across the current bounding box, see GetPositionDequantization.
+    /// </summary>
+    /// <returns>How far the packed data is from the float data</returns>
+    QuantizationReport QuantizeVertexData() noexcept;
+
+    /// <summary>
+    /// Gets whether the vertex data has been packed by QuantizeVertexData
+    /// </summary>
+    /// <returns>[T/F] The packed vertex data is current</returns>
+    inline bool VertexDataIsQuantized() const noexcept { return !m_PackedVertexData.empty(); }
+
+    /// <summary>
+    /// Gets the offset and scale that turn packed positions, 0 to 1 after
+    /// normalization, back into object space: position = offset + packed * scale
+    /// </summary>
+    /// <param name="bounds">[Const Ref] The bounds the positions were quantized across</param>
+    /// <param name="offset">[Out] Receives the offset</param>
+    /// <param name="scale">[Out] Receives the scale</param>
+    static void GetPositionDequantization(const BoundingBox& bounds, vec3& offset, vec3& scale) noexcept;
+
+    /// <summary>
+    /// Frees the arrays the GPU already holds a copy of once the mesh is
+    /// uploaded. The bounds, levels of detail and meshlets stay, and so do the
+    /// positions and full detail triangles if they are kept for collision.
+    /// </summary>
+    /// <param name="keepCollision">[T/F] Keep the positions and full detail triangles</param>
+    void ReleaseArrays(bool keepCollision) noexcept;
+
+    /// <summary>
+    /// Sets the bounds without sweeping the vertices, for a mesh whose
+    /// positions were released or never held
+    /// </summary>
+    /// <param name="bounds">[Const Ref] The bounds in object space</param>
+    void SetBoundingBox(const BoundingBox& bounds) noexcept;
 
     /// <summary>
     /// Scale the mesh to unit size (fit into a 1x1x1 cube)
     /// </summary>
     void ScaleToUnitSize() noexcept;
 
+    /// <summary>
+    /// Scales to unit size and/or moves the centroid to the origin with one
+    /// bounds sweep and one transform sweep, instead of a pair of each
+    /// </summary>
+    /// <param name="scaleToUnitSize">[T/F] Fit the mesh into a 1x1x1 cube</param>
+    /// <param name="resetOrigin">[T/F] Set the origin to the centroid</param>
+    void ScaleAndRecenter(bool scaleToUnitSize, bool resetOrigin) noexcept;
+
     /// <summary>
     /// Finds the centroid of the mesh via vertex averages
     /// </summary>
@@ -239,45 +623,105 @@
     void GenerateTexcoords(UV::Generation generation) noexcept;
 
     /// <summary>
-    /// Assembles all mesh data into VertexData to be sent to the GPU
+    /// Assembles all mesh data into VertexData to be sent to the GPU, replacing any previous data
     /// </summary>
     void AssembleVertexData() noexcept;
 
   private:
     /// <summary>
-    /// Helper function to calculate surface normals
+    /// Maps positions to UV coordinates, with everything the projection needs
+    /// from the bounds worked out once up front
     /// </summary>
-    /// <param name="flipNormals">[T/F] The normals should be inverted</param>
-    void calculateSurfaceNormals(bool flipNormals = false) noexcept;
+    struct TexcoordProjection
+    {
+      TexcoordProjection(UV::Generation generation, const BoundingBox& bounds) noexcept;
+
+      /// <summary>
+      /// Projects a run of positions with the vectorized kernels
+      /// </summary>
+      /// <param name="positions">Positions in object space</param>
+      /// <param name="count">Number of positions</param>
+      /// <param name="texcoords">[Out] Receives the UV coordinates, 0,0 for generations that don't project</param>
+      void Project(const vec3* positions, size_t count, vec2* texcoords) const noexcept;
+
+      UV::Generation Generation;
+      vec3 Min;         // Bounding box minimum
+      vec3 InverseSize; // Reciprocal of the size, 0 for flat axes
+      vec3 Center;      // Bounding box center
+    };
 
     /// <summary>
-    /// Helper function to calculate vertex normals
+    /// Works out the scale and translation for ScaleAndRecenter and moves the
+    /// origin, without touching the vertices
     /// </summary>
-    void calculateVertexNormals() noexcept;
+    /// <param name="scaleToUnitSize">[T/F] Fit the mesh into a 1x1x1 cube</param>
+    /// <param name="resetOrigin">[T/F] Set the origin to the centroid</param>
+    /// <param name="translation">[Out] Receives the translation to apply after scaling</param>
+    /// <returns>The scale to apply</returns>
+    float prepareTransform(bool scaleToUnitSize, bool resetOrigin, vec3& translation) noexcept;
 
     /// <summary>
-    /// Helper function to calculate UV coordinates with a planar projection
+    /// Transforms the vertices, projects their UVs and writes the vertex data in
+    /// a single sweep. The cached bounds are carried through the transform.
     /// </summary>
-    void calculatePlanarUVs() noexcept;
+    /// <param name="scale">Scale to apply to the positions</param>
+    /// <param name="translation">[Const Ref] Translation to apply after scaling</param>
+    /// <param name="generation">UV projection, CUSTOM keeps the current UVs</param>
+    void transformAndAssemble(float scale, const vec3& translation, UV::Generation generation) noexcept;
 
     /// <summary>
-    /// Helper function to calculate UV coordinates with a spherical projection
+    /// Moves every per-triangle array into a new triangle order
     /// </summary>
-    void calculateSphereUVs() noexcept;
+    /// <param name="order">[Const Ref] The old index of the triangle in each new slot</param>
+    void reorderTriangles(const vector<unsigned>& order) noexcept;
 
     /// <summary>
-    /// Helper function to calculate UV coordinates with a cylindrical projection
+    /// Moves the meshlet bounds along with a uniform scale and translation of the vertices
     /// </summary>
-    /// <returns></returns>
-    void calculateCylinderUVs() noexcept;
-    
+    /// <param name="scale">Scale applied to the positions</param>
+    /// <param name="translation">[Const Ref] Translation applied after scaling</param>
+    void transformMeshlets(float scale, const vec3& translation) noexcept;
+
+    /// <summary>
+    /// Looks up the submesh of every full detail triangle
+    /// </summary>
+    /// <returns>The submesh of each triangle, INVALID_INDEX outside them, empty for a single material mesh</returns>
+    vector<unsigned> getTriangleSubmeshes() const noexcept;
+
+    /// <summary>
+    /// Regroups a new triangle order by submesh, so every submesh stays a
+    /// range. Triangles keep their relative order within their submesh.
+    /// </summary>
+    /// <param name="order">[In/Out] The old index of the triangle in each new slot</param>
+    void groupBySubmesh(vector<unsigned>& order) const noexcept;
+
     /// <summary>
-    /// [Not Implemented] Helper function to calculate UV coordinates with a cube map
+    /// Helper function to calculate surface normals
+    /// </summary>
+    /// <param name="flipNormals">[T/F] The normals should be inverted</param>
+    /// <param name="areas">[Out, Optional] Receives the area of each triangle</param>
+    void calculateSurfaceNormals(bool flipNormals = false, vector<float>* areas = nullptr) noexcept;
+
+    /// <summary>
+    /// Helper function to calculate vertex normals by gathering the surface
+    /// normals around each vertex
     /// </summary>
-    void calculateCubeMapUVs() noexcept;
+    /// <param name="weighting">How triangle normals are blended</param>
+    /// <param name="areas">Area of each triangle, needed for area weighting</param>
+    void calculateVertexNormals(NormalWeighting weighting, const vector<float>& areas) noexcept;
+
+    /// <summary>
+    /// Helper function to calculate UV coordinates with a planar, spherical, cylindrical or cube map projection
+    /// </summary>
+    /// <param name="generation">The projection to use</param>
+    void calculateProjectedUVs(UV::Generation generation) noexcept;
 
   private:
     friend class MeshManager; // Allows the Mesh Manager class exclusive access
+    friend class OBJReader;   // Allows the OBJ Reader to fill arrays in bulk
+    friend class MeshCache;   // Allows the Mesh Cache to write arrays in bulk
+    friend class AssetLoader; // Allows the Asset Loader to fill arrays in bulk
+    friend struct MeshPostProcess::Pipeline; // Allows the pipeline to fuse processing steps
 
     vec3 m_Origin;        // The mesh's origin point (pivot point)
     bool m_MeshIsStatic;  // [T/F] The mesh is static (not dynamic)
@@ -292,7 +736,26 @@
     vector<vec2> m_TexcoordArray;               // UV coordinates
     
     vector<VertexData> m_VertexData;            // GPU data for rendering
+    vector<PackedVertexData> m_PackedVertexData; // Quantized GPU data, empty unless requested
+    vector<vec4> m_TangentArray;                // Vertex tangents, bitangent sign in w, empty unless calculated
+    vector<uint32_t> m_TangentData;             // Tangent stream for the GPU, GL_INT_2_10_10_10_REV
+
+    VertexAdjacency m_VertexAdjacency;          // Triangles around each vertex, built on demand
+    HalfEdgeTable m_HalfEdges;                  // Half-edges of the triangles, built on demand
+
+    vector<Mesh::Triangle> m_LodTriangleArray;  // Triangles of the coarser levels of detail, after the full detail ones
+    vector<LevelOfDetail> m_LodArray;           // Index buffer range of each level of detail
+    vector<Meshlet> m_MeshletArray;             // Clusters of the full detail triangles
+    vector<Submesh> m_SubmeshArray;             // Index buffer range of each material, per level of detail
+    vector<string> m_MaterialNames;             // Material of each submesh
+    string m_MaterialLibrary;                   // Library the materials are defined in
+
+    mutable BoundingBox m_Bounds;               // Bounds as of the last sweep
+    mutable size_t m_BoundsVertexCount;         // Vertex count m_Bounds was found for
+    mutable bool m_BoundsAreCached;             // [T/F] m_Bounds is current, unless vertices were added
+    BoundingVolumes m_BoundingVolumes;          // Fitted by CalculateBoundingVolumes
 
     bool m_MeshIsDirty;                         // [T/F] The mesh has changed fundamentally
     bool m_NormalsAreCalculated;                // [T/F] If the normals have been calculated (ie. imported, or calculated)
+    bool m_TexcoordsAreImported;                // [T/F] If the UV coordinates came from the source file
   };
\ No newline at end of file
@@ -0,0 +1,463 @@
+//------------------------------------------------------------------------------
+// File:    MeshCache.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Versioned binary cache (.pmesh) of fully processed mesh GPU data
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MeshCache.h"
+#include <filesystem>
+
+namespace
+{
+  constexpr char CACHE_MAGIC[4] = { 'P', 'M', 'S', 'H' };
+  constexpr uint64_t CACHE_ALIGNMENT = 16u;
+
+  constexpr uint64_t alignUp(uint64_t value) noexcept
+  {
+    return (value + CACHE_ALIGNMENT - 1u) & ~(CACHE_ALIGNMENT - 1u);
+  }
+
+  // Whether count entries of stride bytes from offset lie within size bytes.
+  // Tested by subtraction, so hostile offsets and counts can't wrap around.
+  constexpr bool fits(uint64_t size, uint64_t offset, uint64_t count, uint64_t stride) noexcept
+  {
+    return offset <= size && count <= (size - offset) / stride;
+  }
+
+  // Whether every range stays within the first triangleCount triangles
+  template<typename Range>
+  bool rangesFit(const Range* ranges, uint32_t count, uint32_t triangleCount) noexcept
+  {
+    for (uint32_t i = 0u; i < count; ++i)
+    {
+      if (ranges[i].FirstTriangle > triangleCount || ranges[i].TriangleCount > triangleCount - ranges[i].FirstTriangle)
+        return false;
+    }
+    return true;
+  }
+}
+
+MeshCache::MeshCache() noexcept :
+  m_File(),
+  m_Header(nullptr)
+{
+}
+
+bool MeshCache::Open(const string& fileName, const Options& options) noexcept
+{
+  Close();
+
+  const string path = cachePath(fileName, options);
+  std::error_code error;
+  if (!std::filesystem::exists(path, error))
+    return false;
+
+  if (!m_File.Open(path))
+    return false;
+
+  // Validate the layout
+  const auto* header = reinterpret_cast<const Header*>(m_File.Begin());
+  const uint64_t size = m_File.Size();
+  if (size < sizeof(Header) ||
+    memcmp(header->Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+    header->Version != VERSION ||
+    !fits(size, header->VertexOffset, header->VertexCount, vertexStride(header->QuantizeVertices != 0u)) ||
+    (header->GenerateTangents != 0u && !fits(size, header->TangentOffset, header->VertexCount, sizeof(uint32_t))) ||
+    !fits(size, header->TriangleOffset, header->TriangleCount, sizeof(Mesh::Triangle)) ||
+    !fits(size, header->LodOffset, header->LodCount, sizeof(Mesh::LevelOfDetail)) ||
+    !fits(size, header->MeshletOffset, header->MeshletCount, sizeof(Mesh::Meshlet)) ||
+    !fits(size, header->SubmeshOffset, header->SubmeshRangeCount, sizeof(Mesh::Submesh)) ||
+    !fits(size, header->NameOffset, header->NameBytes, 1u) ||
+    (header->NameBytes != 0u && m_File.Begin()[header->NameOffset + header->NameBytes - 1u] != '\0'))
+  {
+    Log::Warn("[MeshCache] Discarding incompatible cache: " + path);
+    Close();
+    return false;
+  }
+
+  // Validate the options
+  if (header->ScaleToUnitSize != static_cast<uint32_t>(options.ScaleToUnitSize) ||
+    header->ResetOrigin != static_cast<uint32_t>(options.ResetOrigin) ||
+    header->UvGeneration != static_cast<uint32_t>(options.UvGeneration) ||
+    header->OptimizeVertexCache != static_cast<uint32_t>(options.OptimizeVertexCache) ||
+    header->GenerateLods != static_cast<uint32_t>(options.GenerateLods) ||
+    header->QuantizeVertices != static_cast<uint32_t>(options.QuantizeVertices) ||
+    header->BuildMeshlets != static_cast<uint32_t>(options.BuildMeshlets) ||
+    header->WeldVertices != static_cast<uint32_t>(options.WeldVertices) ||
+    header->GenerateTangents != static_cast<uint32_t>(options.GenerateTangents))
+  {
+    Close();
+    return false;
+  }
+
+  // Validate against the source. A matching size and time is trusted, otherwise
+  // the contents are hashed so a touched but unchanged file still hits.
+  const string sourcePath = Paths::MODEL_PATH + fileName;
+  uint64_t sourceSize = 0u;
+  int64_t sourceTime = 0;
+  if (!readSourceStamp(sourcePath, sourceSize, sourceTime) || sourceSize != header->SourceSize)
+  {
+    Close();
+    return false;
+  }
+  if (sourceTime != header->SourceTime && hashFile(sourcePath) != header->SourceHash)
+  {
+    Close();
+    return false;
+  }
+
+  // Validate the contents, the draws and the CPU side culling index with them
+  // unchecked. Every level of detail has one range per submesh.
+  const auto* triangles = reinterpret_cast<const Mesh::Triangle*>(m_File.Begin() + header->TriangleOffset);
+  const auto* lods = reinterpret_cast<const Mesh::LevelOfDetail*>(m_File.Begin() + header->LodOffset);
+  const auto* meshlets = reinterpret_cast<const Mesh::Meshlet*>(m_File.Begin() + header->MeshletOffset);
+  const auto* submeshes = reinterpret_cast<const Mesh::Submesh*>(m_File.Begin() + header->SubmeshOffset);
+  bool isValid =
+    uint64_t(header->SubmeshRangeCount) == uint64_t(header->SubmeshCount) * std::max(1u, header->LodCount) &&
+    rangesFit(lods, header->LodCount, header->TriangleCount) &&
+    rangesFit(meshlets, header->MeshletCount, header->TriangleCount) &&
+    rangesFit(submeshes, header->SubmeshRangeCount, header->TriangleCount);
+  for (uint32_t i = 0u; isValid && i < header->TriangleCount; ++i)
+  {
+    isValid = triangles[i].Index1 < header->VertexCount &&
+      triangles[i].Index2 < header->VertexCount &&
+      triangles[i].Index3 < header->VertexCount;
+  }
+  if (!isValid)
+  {
+    Log::Warn("[MeshCache] Discarding corrupt cache: " + path);
+    Close();
+    return false;
+  }
+
+  m_Header = header;
+  return true;
+}
+
+void MeshCache::Close() noexcept
+{
+  m_Header = nullptr;
+  m_File.Close();
+}
+
+const Mesh::VertexData* MeshCache::GetVertexData() const noexcept
+{
+  return reinterpret_cast<const Mesh::VertexData*>(m_File.Begin() + m_Header->VertexOffset);
+}
+
+const Mesh::PackedVertexData* MeshCache::GetPackedVertexData() const noexcept
+{
+  return reinterpret_cast<const Mesh::PackedVertexData*>(m_File.Begin() + m_Header->VertexOffset);
+}
+
+const uint32_t* MeshCache::GetTangents() const noexcept
+{
+  if (!HasTangents())
+    return nullptr;
+  return reinterpret_cast<const uint32_t*>(m_File.Begin() + m_Header->TangentOffset);
+}
+
+bool MeshCache::HasTangents() const noexcept
+{
+  return m_Header->GenerateTangents != 0u;
+}
+
+bool MeshCache::IsQuantized() const noexcept
+{
+  return m_Header->QuantizeVertices != 0u;
+}
+
+const Mesh::Triangle* MeshCache::GetTriangles() const noexcept
+{
+  return reinterpret_cast<const Mesh::Triangle*>(m_File.Begin() + m_Header->TriangleOffset);
+}
+
+const Mesh::LevelOfDetail* MeshCache::GetLevelsOfDetail() const noexcept
+{
+  return reinterpret_cast<const Mesh::LevelOfDetail*>(m_File.Begin() + m_Header->LodOffset);
+}
+
+const Mesh::Meshlet* MeshCache::GetMeshlets() const noexcept
+{
+  return reinterpret_cast<const Mesh::Meshlet*>(m_File.Begin() + m_Header->MeshletOffset);
+}
+
+const Mesh::Submesh* MeshCache::GetSubmeshes() const noexcept
+{
+  return reinterpret_cast<const Mesh::Submesh*>(m_File.Begin() + m_Header->SubmeshOffset);
+}
+
+vector<string> MeshCache::GetMaterialNames() const noexcept
+{
+  // The library comes first, the submesh names follow it
+  vector<string> names;
+  const char* name = m_File.Begin() + m_Header->NameOffset;
+  const char* end = name + m_Header->NameBytes;
+  if (name != end)
+    name += strlen(name) + 1u;
+  for (; name < end && names.size() < m_Header->SubmeshCount; name += names.back().size() + 1u)
+    names.emplace_back(name);
+  names.resize(m_Header->SubmeshCount);
+  return names;
+}
+
+string MeshCache::GetMaterialLibrary() const noexcept
+{
+  if (m_Header->NameBytes == 0u)
+    return string();
+  return string(m_File.Begin() + m_Header->NameOffset);
+}
+
+unsigned MeshCache::GetSubmeshCount() const noexcept
+{
+  return m_Header->SubmeshCount;
+}
+
+unsigned MeshCache::GetSubmeshRangeCount() const noexcept
+{
+  return m_Header->SubmeshRangeCount;
+}
+
+unsigned MeshCache::GetVertexCount() const noexcept
+{
+  return m_Header->VertexCount;
+}
+
+unsigned MeshCache::GetTriangleCount() const noexcept
+{
+  return m_Header->TriangleCount;
+}
+
+unsigned MeshCache::GetLodCount() const noexcept
+{
+  return m_Header->LodCount;
+}
+
+unsigned MeshCache::GetMeshletCount() const noexcept
+{
+  return m_Header->MeshletCount;
+}
+
+Mesh::BoundingBox MeshCache::GetBounds() const noexcept
+{
+  return {
+    m_Header->Bounds[0], m_Header->Bounds[1], m_Header->Bounds[2],
+    m_Header->Bounds[3], m_Header->Bounds[4], m_Header->Bounds[5] };
+}
+
+Mesh::BoundingVolumes MeshCache::GetBoundingVolumes() const noexcept
+{
+  Mesh::BoundingVolumes volumes;
+  volumes.Aabb = GetBounds();
+  volumes.Sphere.Center = vec3(m_Header->Sphere[0], m_Header->Sphere[1], m_Header->Sphere[2]);
+  volumes.Sphere.Radius = m_Header->Sphere[3];
+  const float* box = m_Header->OrientedBox;
+  volumes.Obb.Center = vec3(box[0], box[1], box[2]);
+  for (unsigned a = 0u; a < 3u; ++a)
+    volumes.Obb.Axes[a] = vec3(box[3u + 3u * a], box[4u + 3u * a], box[5u + 3u * a]);
+  volumes.Obb.HalfExtents = vec3(box[12], box[13], box[14]);
+  return volumes;
+}
+
+vec3 MeshCache::GetOrigin() const noexcept
+{
+  return vec3(m_Header->Origin[0], m_Header->Origin[1], m_Header->Origin[2]);
+}
+
+bool MeshCache::Write(const string& fileName, const Options& options, const Mesh& mesh) noexcept
+{
+  if (mesh.m_VertexData.size() != mesh.GetVertexCount() ||
+    (options.QuantizeVertices && mesh.m_PackedVertexData.size() != mesh.GetVertexCount()) ||
+    (options.GenerateTangents && mesh.m_TangentData.size() != mesh.GetVertexCount()))
+  {
+    Log::Error("[MeshCache] Vertex data must be assembled before caching: " + fileName);
+    return false;
+  }
+
+  Header header = {};
+  memcpy(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.Version = VERSION;
+
+  const string sourcePath = Paths::MODEL_PATH + fileName;
+  if (!readSourceStamp(sourcePath, header.SourceSize, header.SourceTime))
+    return false;
+  header.SourceHash = hashFile(sourcePath);
+
+  header.ScaleToUnitSize = static_cast<uint32_t>(options.ScaleToUnitSize);
+  header.ResetOrigin = static_cast<uint32_t>(options.ResetOrigin);
+  header.UvGeneration = static_cast<uint32_t>(options.UvGeneration);
+  header.OptimizeVertexCache = static_cast<uint32_t>(options.OptimizeVertexCache);
+  header.GenerateLods = static_cast<uint32_t>(options.GenerateLods);
+  header.QuantizeVertices = static_cast<uint32_t>(options.QuantizeVertices);
+  header.BuildMeshlets = static_cast<uint32_t>(options.BuildMeshlets);
+  header.WeldVertices = static_cast<uint32_t>(options.WeldVertices);
+  header.GenerateTangents = static_cast<uint32_t>(options.GenerateTangents);
+
+  header.VertexCount = static_cast<uint32_t>(mesh.m_VertexData.size());
+  header.TriangleCount = mesh.GetTriangleCount() + static_cast<uint32_t>(mesh.m_LodTriangleArray.size());
+  header.LodCount = static_cast<uint32_t>(mesh.m_LodArray.size());
+  header.MeshletCount = static_cast<uint32_t>(mesh.m_MeshletArray.size());
+  header.SubmeshCount = mesh.GetSubmeshCount();
+  header.SubmeshRangeCount = static_cast<uint32_t>(mesh.m_SubmeshArray.size());
+
+  string names = mesh.GetMaterialLibrary();
+  names.push_back('\0');
+  for (const string& name : mesh.GetMaterialNames())
+  {
+    names += name;
+    names.push_back('\0');
+  }
+  header.NameBytes = static_cast<uint32_t>(names.size());
+
+  const Mesh::BoundingBox& bounds = mesh.GetBoundingBox();
+  header.Bounds[0] = bounds.xMin;
+  header.Bounds[1] = bounds.yMin;
+  header.Bounds[2] = bounds.zMin;
+  header.Bounds[3] = bounds.xMax;
+  header.Bounds[4] = bounds.yMax;
+  header.Bounds[5] = bounds.zMax;
+
+  const Mesh::BoundingVolumes& volumes = mesh.GetBoundingVolumes();
+  header.Sphere[0] = volumes.Sphere.Center.x;
+  header.Sphere[1] = volumes.Sphere.Center.y;
+  header.Sphere[2] = volumes.Sphere.Center.z;
+  header.Sphere[3] = volumes.Sphere.Radius;
+  float* box = header.OrientedBox;
+  box[0] = volumes.Obb.Center.x;
+  box[1] = volumes.Obb.Center.y;
+  box[2] = volumes.Obb.Center.z;
+  for (unsigned a = 0u; a < 3u; ++a)
+  {
+    box[3u + 3u * a] = volumes.Obb.Axes[a].x;
+    box[4u + 3u * a] = volumes.Obb.Axes[a].y;
+    box[5u + 3u * a] = volumes.Obb.Axes[a].z;
+  }
+  box[12] = volumes.Obb.HalfExtents.x;
+  box[13] = volumes.Obb.HalfExtents.y;
+  box[14] = volumes.Obb.HalfExtents.z;
+
+  header.Origin[0] = mesh.GetOrigin().x;
+  header.Origin[1] = mesh.GetOrigin().y;
+  header.Origin[2] = mesh.GetOrigin().z;
+
+  const uint64_t vertexBytes = uint64_t(header.VertexCount) * vertexStride(options.QuantizeVertices);
+  const char* vertexSource = options.QuantizeVertices ?
+    reinterpret_cast<const char*>(mesh.m_PackedVertexData.data()) :
+    reinterpret_cast<const char*>(mesh.m_VertexData.data());
+  const uint64_t tangentBytes = options.GenerateTangents ? uint64_t(header.VertexCount) * sizeof(uint32_t) : 0u;
+  const uint64_t triangleBytes = uint64_t(mesh.GetTriangleCount()) * sizeof(Mesh::Triangle);
+  const uint64_t lodTriangleBytes = uint64_t(mesh.m_LodTriangleArray.size()) * sizeof(Mesh::Triangle);
+  const uint64_t lodBytes = uint64_t(header.LodCount) * sizeof(Mesh::LevelOfDetail);
+  const uint64_t meshletBytes = uint64_t(header.MeshletCount) * sizeof(Mesh::Meshlet);
+  const uint64_t submeshBytes = uint64_t(header.SubmeshRangeCount) * sizeof(Mesh::Submesh);
+  header.VertexOffset = alignUp(sizeof(Header));
+  header.TangentOffset = alignUp(header.VertexOffset + vertexBytes);
+  header.TriangleOffset = alignUp(header.TangentOffset + tangentBytes);
+  header.LodOffset = alignUp(header.TriangleOffset + triangleBytes + lodTriangleBytes);
+  header.MeshletOffset = alignUp(header.LodOffset + lodBytes);
+  header.SubmeshOffset = alignUp(header.MeshletOffset + meshletBytes);
+  header.NameOffset = alignUp(header.SubmeshOffset + submeshBytes);
+
+  const string path = cachePath(fileName, options);
+  const string tempPath = path + ".tmp";
+
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+  // Write to a temporary file first so a partial write is never mistaken for a cache
+  {
+    std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+    if (!outFile)
+    {
+      Log::Error("[MeshCache] Could not create cache file: " + tempPath);
+      return false;
+    }
+
+    const char padding[CACHE_ALIGNMENT] = {};
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    outFile.write(padding, static_cast<std::streamsize>(header.VertexOffset - sizeof(Header)));
+    outFile.write(vertexSource, static_cast<std::streamsize>(vertexBytes));
+    outFile.write(padding, static_cast<std::streamsize>(header.TangentOffset - header.VertexOffset - vertexBytes));
+    outFile.write(reinterpret_cast<const char*>(mesh.m_TangentData.data()), static_cast<std::streamsize>(tangentBytes));
+    outFile.write(padding, static_cast<std::streamsize>(header.TriangleOffset - header.TangentOffset - tangentBytes));
+    outFile.write(reinterpret_cast<const char*>(mesh.m_TriangleArray.data()), static_cast<std::streamsize>(triangleBytes));
+    outFile.write(reinterpret_cast<const char*>(mesh.m_LodTriangleArray.data()), static_cast<std::streamsize>(lodTriangleBytes));
+    outFile.write(padding, static_cast<std::streamsize>(header.LodOffset - header.TriangleOffset - triangleBytes - lodTriangleBytes));
+    outFile.write(reinterpret_cast<const char*>(mesh.m_LodArray.data()), static_cast<std::streamsize>(lodBytes));
+    outFile.write(padding, static_cast<std::streamsize>(header.MeshletOffset - header.LodOffset - lodBytes));
+    outFile.write(reinterpret_cast<const char*>(mesh.m_MeshletArray.data()), static_cast<std::streamsize>(meshletBytes));
+    outFile.write(padding, static_cast<std::streamsize>(header.SubmeshOffset - header.MeshletOffset - meshletBytes));
+    outFile.write(reinterpret_cast<const char*>(mesh.m_SubmeshArray.data()), static_cast<std::streamsize>(submeshBytes));
+    outFile.write(padding, static_cast<std::streamsize>(header.NameOffset - header.SubmeshOffset - submeshBytes));
+    outFile.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    if (!outFile)
+    {
+      Log::Error("[MeshCache] Could not write cache file: " + tempPath);
+      outFile.close();
+      std::filesystem::remove(tempPath, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempPath, path, error);
+  if (error)
+  {
+    Log::Error("[MeshCache] Could not finalize cache file: " + path);
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+
+  Log::Trace("Mesh cache written: " + path);
+  return true;
+}
+
+string MeshCache::cachePath(const string& fileName, const Options& options) noexcept
+{
+  // Each set of options gets its own file so they don't evict each other
+  stringstream path;
+  path << Paths::MESH_CACHE_PATH << fileName << '.'
+    << (options.ScaleToUnitSize ? 's' : '-')
+    << (options.ResetOrigin ? 'o' : '-')
+    << (options.OptimizeVertexCache ? 'v' : '-')
+    << (options.GenerateLods ? 'l' : '-')
+    << (options.QuantizeVertices ? 'q' : '-')
+    << (options.BuildMeshlets ? 'm' : '-')
+    << (options.WeldVertices ? 'w' : '-')
+    << (options.GenerateTangents ? 't' : '-')
+    << static_cast<unsigned>(options.UvGeneration) << ".pmesh";
+  return path.str();
+}
+
+bool MeshCache::readSourceStamp(const string& sourcePath, uint64_t& size, int64_t& time) noexcept
+{
+  std::error_code error;
+  size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+  if (error)
+    return false;
+
+  time = static_cast<int64_t>(std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count());
+  return !error;
+}
+
+uint64_t MeshCache::hashFile(const string& sourcePath) noexcept
+{
+  MappedFile source;
+  if (!source.Open(sourcePath))
+    return 0u;
+
+  // 64-bit FNV-1a
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (const char* c = source.Begin(); c != source.End(); ++c)
+  {
+    hash ^= static_cast<unsigned char>(*c);
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+size_t MeshCache::vertexStride(const bool isQuantized) noexcept
+{
+  return isQuantized ? sizeof(Mesh::PackedVertexData) : sizeof(Mesh::VertexData);
+}
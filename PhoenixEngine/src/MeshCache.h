@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+// File:    MeshCache.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Versioned binary cache (.pmesh) of fully processed mesh GPU data
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+#include "MappedFile.h"
+
+class MeshCache
+{
+public:
+  static constexpr uint32_t VERSION = 11u; // Bump whenever the file layout or mesh processing changes
+
+  /// <summary>
+  /// The import options that produced the cached data
+  /// </summary>
+  struct Options
+  {
+    bool ScaleToUnitSize;
+    bool ResetOrigin;
+    UV::Generation UvGeneration;
+    bool OptimizeVertexCache;
+    bool GenerateLods;
+    bool QuantizeVertices;
+    bool BuildMeshlets;
+    bool WeldVertices;
+    bool GenerateTangents;
+  };
+
+public:
+  MeshCache() noexcept;
+  ~MeshCache() = default;
+  MeshCache(const MeshCache&) = delete;
+  MeshCache& operator=(const MeshCache&) = delete;
+  MeshCache(MeshCache&&) = delete;
+  MeshCache& operator=(MeshCache&&) = delete;
+
+  /// <summary>
+  /// Maps the cache file for a source mesh if it is still valid for the source and options
+  /// </summary>
+  /// <param name="fileName">The source mesh file name, relative to the model path</param>
+  /// <param name="options">The import options the cache must match</param>
+  /// <returns>[T/F] A valid cache was found and mapped</returns>
+  bool Open(const string& fileName, const Options& options) noexcept;
+
+  /// <summary>
+  /// Unmaps the cache file
+  /// </summary>
+  void Close() noexcept;
+
+  /// <summary>
+  /// Gets the interleaved GPU vertex data, straight from the mapped file
+  /// </summary>
+  /// <returns>Pointer to GetVertexCount() vertices, unless IsQuantized</returns>
+  const Mesh::VertexData* GetVertexData() const noexcept;
+
+  /// <summary>
+  /// Gets the packed GPU vertex data, straight from the mapped file
+  /// </summary>
+  /// <returns>Pointer to GetVertexCount() vertices, if IsQuantized</returns>
+  const Mesh::PackedVertexData* GetPackedVertexData() const noexcept;
+
+  /// <summary>
+  /// Gets whether the vertex data is packed, in which case the positions are
+  /// quantized across GetBounds
+  /// </summary>
+  /// <returns>[T/F] The cache holds PackedVertexData</returns>
+  bool IsQuantized() const noexcept;
+
+  /// <summary>
+  /// Gets the packed tangent stream, straight from the mapped file
+  /// </summary>
+  /// <returns>Pointer to GetVertexCount() GL_INT_2_10_10_10_REV tangents, nullptr unless HasTangents</returns>
+  const uint32_t* GetTangents() const noexcept;
+
+  /// <summary>
+  /// Gets whether the cache holds a tangent stream
+  /// </summary>
+  /// <returns>[T/F] The mesh was cached with GenerateTangents</returns>
+  bool HasTangents() const noexcept;
+
+  /// <summary>
+  /// Gets the triangle indices, straight from the mapped file
+  /// </summary>
+  /// <returns>Pointer to GetTriangleCount() triangles</returns>
+  const Mesh::Triangle* GetTriangles() const noexcept;
+
+  /// <summary>
+  /// Gets the index buffer range of each level of detail, straight from the mapped file
+  /// </summary>
+  /// <returns>Pointer to GetLodCount() levels, full detail first</returns>
+  const Mesh::LevelOfDetail* GetLevelsOfDetail() const noexcept;
+
+  /// <summary>
+  /// Gets the meshlets of the full detail triangles, straight from the mapped file
+  /// </summary>
+  /// <returns>Pointer to GetMeshletCount() meshlets</returns>
+  const Mesh::Meshlet* GetMeshlets() const noexcept;
+
+  /// <summary>
+  /// Gets the index buffer range of each submesh, straight from the mapped file
+  /// </summary>
+  /// <returns>Pointer to GetSubmeshRangeCount() ranges, GetSubmeshCount() per level of detail</returns>
+  const Mesh::Submesh* GetSubmeshes() const noexcept;
+
+  /// <summary>
+  /// Gets the material name of each submesh
+  /// </summary>
+  /// <returns>GetSubmeshCount() names, copied out of the file</returns>
+  vector<string> GetMaterialNames() const noexcept;
+
+  /// <summary>
+  /// Gets the material library the submesh materials are looked up in
+  /// </summary>
+  /// <returns>Path of the library under the model directory, empty if there is none</returns>
+  string GetMaterialLibrary() const noexcept;
+
+  unsigned GetSubmeshCount() const noexcept;
+  unsigned GetSubmeshRangeCount() const noexcept;
+  unsigned GetVertexCount() const noexcept;
+  unsigned GetTriangleCount() const noexcept;
+  unsigned GetLodCount() const noexcept;
+  unsigned GetMeshletCount() const noexcept;
+  Mesh::BoundingBox GetBounds() const noexcept;
+
+  /// <summary>
+  /// Gets the bounding box, sphere and oriented box fitted on import
+  /// </summary>
+  /// <returns>The bounding volumes, copied out of the header</returns>
+  Mesh::BoundingVolumes GetBoundingVolumes() const noexcept;
+
+  vec3 GetOrigin() const noexcept;
+
+  /// <summary>
+  /// Writes the processed mesh to the cache, keyed by the source file's time, size and hash
+  /// </summary>
+  /// <param name="fileName">The source mesh file name, relative to the model path</param>
+  /// <param name="options">The import options that produced the mesh</param>
+  /// <param name="mesh">The mesh with assembled vertex data</param>
+  /// <returns>[T/F] The cache file was written</returns>
+  static bool Write(const string& fileName, const Options& options, const Mesh& mesh) noexcept;
+
+private:
+  /// <summary>
+  /// On-disk header, followed by the vertex data, the tangents, the triangles,
+  /// the levels of detail, the meshlets, the submeshes and the material names
+  /// </summary>
+  struct Header
+  {
+    char Magic[4];            // "PMSH"
+    uint32_t Version;         // MeshCache::VERSION at write time
+
+    uint64_t SourceSize;      // Size of the source file in bytes
+    int64_t SourceTime;       // Last write time of the source file
+    uint64_t SourceHash;      // FNV-1a hash of the source file contents
+
+    uint32_t ScaleToUnitSize; // Options::ScaleToUnitSize
+    uint32_t ResetOrigin;     // Options::ResetOrigin
+    uint32_t UvGeneration;    // Options::UvGeneration
+    uint32_t OptimizeVertexCache; // Options::OptimizeVertexCache
+    uint32_t GenerateLods;    // Options::GenerateLods
+    uint32_t QuantizeVertices; // Options::QuantizeVertices
+    uint32_t BuildMeshlets;   // Options::BuildMeshlets
+    uint32_t WeldVertices;    // Options::WeldVertices
+    uint32_t GenerateTangents; // Options::GenerateTangents
+
+    uint32_t VertexCount;     // Number of Mesh::VertexData or Mesh::PackedVertexData entries
+    uint32_t TriangleCount;   // Number of Mesh::Triangle entries, every level of detail
+    uint32_t LodCount;        // Number of Mesh::LevelOfDetail entries
+    uint32_t MeshletCount;    // Number of Mesh::Meshlet entries
+    uint32_t SubmeshCount;    // Number of materials, submeshes per level of detail
+    uint32_t SubmeshRangeCount; // Number of Mesh::Submesh entries, every level of detail
+    uint32_t NameBytes;       // Size of the material names, the library then each submesh's, all null terminated
+    float Bounds[6];          // Mesh::BoundingBox after processing
+    float Sphere[4];          // Mesh::BoundingSphere center and radius
+    float OrientedBox[15];    // Mesh::OrientedBox center, axes and half extents
+    float Origin[3];          // Mesh origin after processing
+
+    uint64_t VertexOffset;    // Byte offset of the vertex data
+    uint64_t TangentOffset;   // Byte offset of the tangent stream, VertexCount entries if GenerateTangents
+    uint64_t TriangleOffset;  // Byte offset of the triangles
+    uint64_t LodOffset;       // Byte offset of the levels of detail
+    uint64_t MeshletOffset;   // Byte offset of the meshlets
+    uint64_t SubmeshOffset;   // Byte offset of the submeshes
+    uint64_t NameOffset;      // Byte offset of the material names
+  };
+
+  static string cachePath(const string& fileName, const Options& options) noexcept;
+  static size_t vertexStride(bool isQuantized) noexcept;
+  static bool readSourceStamp(const string& sourcePath, uint64_t& size, int64_t& time) noexcept;
+  static uint64_t hashFile(const string& sourcePath) noexcept;
+
+  MappedFile m_File;        // The mapped cache file
+  const Header* m_Header;   // Header at the start of the mapped file
+};
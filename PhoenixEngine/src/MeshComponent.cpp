@@ -8,12 +8,45 @@
 #include "MeshComponent.h"
 
 MeshComponent::MeshComponent(GameObject& parent) noexcept :
-  Component(parent)
+  Component(parent),
+  m_Mesh(),
+  m_Registry(),
+  m_SubmeshMaterials()
 {
 }
 
+MeshComponent::~MeshComponent()
+{
+  SetMesh(nullptr, MeshHandle());
+}
+
 void MeshComponent::SetMeshFileName(const string& fileName) noexcept
 {
   m_MeshFileName = fileName;
-  m_MeshID = Error::INVALID_INDEX;
+  m_SubmeshMaterials.clear();
+  SetMesh(nullptr, MeshHandle());
+}
+
+void MeshComponent::SetSubmeshMaterial(const unsigned submesh, const Material& material) noexcept
+{
+  m_SubmeshMaterials.insert_or_assign(submesh, material);
+}
+
+const Material* MeshComponent::GetSubmeshMaterial(const unsigned submesh) const noexcept
+{
+  const auto material = m_SubmeshMaterials.find(submesh);
+  return material != m_SubmeshMaterials.end() ? &material->second : nullptr;
+}
+
+void MeshComponent::SetMesh(const shared_ptr<MeshRegistry>& registry, const MeshHandle& handle) noexcept
+{
+  // Take the new reference first in case the handle is unchanged
+  if (registry)
+    registry->AddReference(handle);
+
+  if (const shared_ptr<MeshRegistry> previous = m_Registry.lock())
+    previous->Release(m_Mesh);
+
+  m_Registry = registry;
+  m_Mesh = handle;
 }
\ No newline at end of file
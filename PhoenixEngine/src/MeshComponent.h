@@ -7,13 +7,15 @@
 #pragma once
 #include "Component.h"
 #include "Material.h"
+#include "MeshRegistry.h"
+#include <map>
 
 class MeshComponent : public Component
 {
   public:
 
   MeshComponent(GameObject& parent) noexcept;
-  ~MeshComponent() = default;
+  ~MeshComponent();
   MeshComponent(const MeshComponent&) = delete;
   MeshComponent& operator=(const MeshComponent&) = delete;
   MeshComponent(MeshComponent&&) = delete;
@@ -26,11 +28,35 @@ class MeshComponent : public Component
 
   inline void SetMaterial(const Material& material) noexcept { m_Material = material; }
   inline const Material& GetMaterial() noexcept { return m_Material; }
-  inline unsigned GetMeshID() const noexcept { return m_MeshID; }
-  inline void SetMeshID(unsigned MeshID) noexcept { m_MeshID = MeshID; }
+  inline const MeshHandle& GetMeshHandle() const noexcept { return m_Mesh; }
+
+  /// <summary>
+  /// Overrides the material of one submesh of the mesh, in place of the one
+  /// from its material library. Changing the mesh file clears the overrides.
+  /// </summary>
+  /// <param name="submesh">Index of the submesh, in the mesh's material order</param>
+  /// <param name="material">[Const Ref] The material to draw it with</param>
+  void SetSubmeshMaterial(unsigned submesh, const Material& material) noexcept;
+
+  /// <summary>
+  /// Gets the material overriding a submesh
+  /// </summary>
+  /// <param name="submesh">Index of the submesh</param>
+  /// <returns>The override, nullptr if the submesh has none</returns>
+  const Material* GetSubmeshMaterial(unsigned submesh) const noexcept;
+
+  /// <summary>
+  /// Points the component at a loaded mesh, holding a reference to it in the
+  /// registry and releasing the previous one
+  /// </summary>
+  /// <param name="registry">Registry the handle belongs to</param>
+  /// <param name="handle">Handle of the mesh</param>
+  void SetMesh(const shared_ptr<MeshRegistry>& registry, const MeshHandle& handle) noexcept;
 
   private:
-  unsigned m_MeshID;
+  MeshHandle m_Mesh;
+  weak_ptr<MeshRegistry> m_Registry;  // Outlives the component only if the renderer does
   string m_MeshFileName;
   Material m_Material;
+  std::map<unsigned, Material> m_SubmeshMaterials; // Overrides by submesh, few meshes have many
 };
@@ -0,0 +1,627 @@
+//------------------------------------------------------------------------------
+// File:    MeshKernels.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Vectorized (SSE/AVX) sweeps over mesh position streams
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MeshKernels.h"
+
+#include <atomic>
+#include <cfloat>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define PE_SIMD_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC accepts AVX intrinsics anywhere, other compilers need them enabled per function
+#define PE_TARGET_AVX
+#else
+#define PE_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+// Positions are packed xyzxyz..., so a stream of vec3 is read as plain floats.
+// Every 3 registers of W lanes hold W whole positions, lane i of register k
+// holding component (k * W + i) % 3. The min/max accumulators keep that layout
+// and are only folded back into x, y and z at the end.
+static_assert(sizeof(vec3) == 3u * sizeof(float), "Kernels expect tightly packed positions");
+static_assert(sizeof(vec2) == 2u * sizeof(float), "Kernels expect tightly packed UVs");
+
+namespace
+{
+  MeshKernels::InstructionSet detectInstructionSet() noexcept
+  {
+#ifdef PE_SIMD_X64
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 0x6u) == 0x6u);
+    const bool hasAvx = (info[2] & (1 << 28)) != 0;
+    if (osSavesYmm && hasAvx)
+      return MeshKernels::InstructionSet::AVX;
+#else
+    if (__builtin_cpu_supports("avx"))
+      return MeshKernels::InstructionSet::AVX;
+#endif
+    return MeshKernels::InstructionSet::SSE2;
+#else
+    return MeshKernels::InstructionSet::SCALAR;
+#endif
+  }
+
+  const MeshKernels::InstructionSet s_Supported = detectInstructionSet();
+  std::atomic<MeshKernels::InstructionSet> s_Active{ s_Supported };
+
+  void foldLanes(const float* lanes, const size_t laneCount, vec3& min, vec3& max, const bool isMax) noexcept
+  {
+    for (size_t i = 0u; i < 3u * laneCount; ++i)
+    {
+      const size_t component = i % 3u;
+      if (isMax)
+        max[static_cast<glm::length_t>(component)] = std::max(max[static_cast<glm::length_t>(component)], lanes[i]);
+      else
+        min[static_cast<glm::length_t>(component)] = std::min(min[static_cast<glm::length_t>(component)], lanes[i]);
+    }
+  }
+
+  // Written so a NaN in the data never replaces the running value, like _mm_min_ps(v, acc)
+  void boundsScalar(const float* data, const size_t count, vec3& min, vec3& max) noexcept
+  {
+    for (size_t i = 0u; i < count; ++i)
+    {
+      for (glm::length_t c = 0; c < 3; ++c)
+      {
+        const float v = data[i * 3u + static_cast<size_t>(c)];
+        min[c] = v < min[c] ? v : min[c];
+        max[c] = v > max[c] ? v : max[c];
+      }
+    }
+  }
+
+  void scaleTranslateScalar(float* data, const size_t count, const float scale, const vec3& translation) noexcept
+  {
+    for (size_t i = 0u; i < count; ++i)
+    {
+      data[i * 3u + 0u] = data[i * 3u + 0u] * scale + translation.x;
+      data[i * 3u + 1u] = data[i * 3u + 1u] * scale + translation.y;
+      data[i * 3u + 2u] = data[i * 3u + 2u] * scale + translation.z;
+    }
+  }
+
+  // Arctangent on [0, 1] as an odd polynomial, Abramowitz and Stegun 4.4.49
+  constexpr float Atan1 = 0.9998660f;
+  constexpr float Atan3 = -0.3302995f;
+  constexpr float Atan5 = 0.1801410f;
+  constexpr float Atan7 = -0.0851330f;
+  constexpr float Atan9 = 0.0208351f;
+
+  constexpr float Pi = 3.14159265f;
+  constexpr float HalfPi = 1.57079633f;
+  constexpr float TwoPi = 6.28318531f;
+
+  // The projection, with everything taken from the bounds
+  struct Projection
+  {
+    UV::Generation Generation;
+    vec3 Min;
+    vec3 Center;
+    vec3 InverseSize;
+  };
+
+  // Folds the angle into the first octant, where the polynomial holds, and back out
+  float fastAtan2(const float y, const float x) noexcept
+  {
+    const float ax = std::abs(x);
+    const float ay = std::abs(y);
+    const float a = std::min(ax, ay) / std::max(std::max(ax, ay), FLT_MIN);
+    const float s = a * a;
+    float r = a * (Atan1 + s * (Atan3 + s * (Atan5 + s * (Atan7 + s * Atan9))));
+    r = ay > ax ? HalfPi - r : r;
+    r = x < 0.f ? Pi - r : r;
+    return y < 0.f ? -r : r;
+  }
+
+  void projectScalar(const float* data, const size_t count, const Projection& p, float* out) noexcept
+  {
+    for (size_t i = 0u; i < count; ++i)
+    {
+      const float x = data[i * 3u + 0u];
+      const float y = data[i * 3u + 1u];
+      const float z = data[i * 3u + 2u];
+      float u = 0.f, v = 0.f;
+      switch (p.Generation)
+      {
+      case UV::Generation::PLANAR:
+      {
+        // Stretch the X/Y extents of the box over the texture
+        u = (x - p.Min.x) * p.InverseSize.x;
+        v = (y - p.Min.y) * p.InverseSize.y;
+        break;
+      }
+      case UV::Generation::SPHERICAL:
+      case UV::Generation::CYLINDRICAL:
+      {
+        // U goes once around the Y axis, starting along +X
+        const float dx = x - p.Center.x;
+        const float dy = y - p.Center.y;
+        const float dz = z - p.Center.z;
+        const float theta = fastAtan2(dz, dx);
+        u = (theta < 0.f ? theta + TwoPi : theta) * (1.f / TwoPi);
+
+        // acos(dy / length) is the angle from the pole, taken as an arctangent
+        if (p.Generation == UV::Generation::SPHERICAL)
+          v = 1.f - fastAtan2(std::sqrt(dx * dx + dz * dz), dy) * (1.f / Pi);
+        else
+          v = (y - p.Min.y) * p.InverseSize.y;
+        break;
+      }
+      case UV::Generation::CUBE_MAP:
+      {
+        // Across the box, so every face of it fills its tile
+        const float dx = (x - p.Center.x) * p.InverseSize.x;
+        const float dy = (y - p.Center.y) * p.InverseSize.y;
+        const float dz = (z - p.Center.z) * p.InverseSize.z;
+        const float ax = std::abs(dx), ay = std::abs(dy), az = std::abs(dz);
+
+        float major, s, t, column, row;
+        if (ax >= ay && ax >= az)
+        {
+          major = ax; s = dx >= 0.f ? -dz : dz; t = dy;
+          column = dx >= 0.f ? 0.f : 1.f; row = 0.f;
+        }
+        else if (ay >= az)
+        {
+          major = ay; s = dx; t = dy >= 0.f ? -dz : dz;
+          column = dy >= 0.f ? 2.f : 0.f; row = dy >= 0.f ? 0.f : 1.f;
+        }
+        else
+        {
+          major = az; s = dz >= 0.f ? dx : -dx; t = dy;
+          column = dz >= 0.f ? 1.f : 2.f; row = 1.f;
+        }
+        const float scale = 0.5f / std::max(major, FLT_MIN);
+        u = (column + 0.5f + s * scale) * (1.f / 3.f);
+        v = (row + 0.5f + t * scale) * 0.5f;
+        break;
+      }
+      case UV::Generation::CUSTOM:
+      default:
+        break;
+      }
+      out[i * 2u + 0u] = u;
+      out[i * 2u + 1u] = v;
+    }
+  }
+
+#ifdef PE_SIMD_X64
+  // 4 positions per iteration, returns how many were handled
+  size_t boundsSSE2(const float* data, const size_t count, vec3& min, vec3& max) noexcept
+  {
+    const size_t blocks = count / 4u;
+    __m128 min0 = _mm_set1_ps(FLT_MAX), min1 = min0, min2 = min0;
+    __m128 max0 = _mm_set1_ps(-FLT_MAX), max1 = max0, max2 = max0;
+    for (size_t b = 0u; b < blocks; ++b)
+    {
+      const float* p = data + b * 12u;
+      const __m128 v0 = _mm_loadu_ps(p);
+      const __m128 v1 = _mm_loadu_ps(p + 4);
+      const __m128 v2 = _mm_loadu_ps(p + 8);
+      min0 = _mm_min_ps(v0, min0); max0 = _mm_max_ps(v0, max0);
+      min1 = _mm_min_ps(v1, min1); max1 = _mm_max_ps(v1, max1);
+      min2 = _mm_min_ps(v2, min2); max2 = _mm_max_ps(v2, max2);
+    }
+
+    alignas(16) float lanes[12];
+    _mm_store_ps(lanes, min0); _mm_store_ps(lanes + 4, min1); _mm_store_ps(lanes + 8, min2);
+    foldLanes(lanes, 4u, min, max, false);
+    _mm_store_ps(lanes, max0); _mm_store_ps(lanes + 4, max1); _mm_store_ps(lanes + 8, max2);
+    foldLanes(lanes, 4u, min, max, true);
+    return blocks * 4u;
+  }
+
+  size_t scaleTranslateSSE2(float* data, const size_t count, const float scale, const vec3& translation) noexcept
+  {
+    const size_t blocks = count / 4u;
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 t0 = _mm_setr_ps(translation.x, translation.y, translation.z, translation.x);
+    const __m128 t1 = _mm_setr_ps(translation.y, translation.z, translation.x, translation.y);
+    const __m128 t2 = _mm_setr_ps(translation.z, translation.x, translation.y, translation.z);
+    for (size_t b = 0u; b < blocks; ++b)
+    {
+      float* p = data + b * 12u;
+      _mm_storeu_ps(p, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p), s), t0));
+      _mm_storeu_ps(p + 4, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p + 4), s), t1));
+      _mm_storeu_ps(p + 8, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p + 8), s), t2));
+    }
+    return blocks * 4u;
+  }
+
+  // 8 positions per iteration, returns how many were handled
+  PE_TARGET_AVX size_t boundsAVX(const float* data, const size_t count, vec3& min, vec3& max) noexcept
+  {
+    const size_t blocks = count / 8u;
+    __m256 min0 = _mm256_set1_ps(FLT_MAX), min1 = min0, min2 = min0;
+    __m256 max0 = _mm256_set1_ps(-FLT_MAX), max1 = max0, max2 = max0;
+    for (size_t b = 0u; b < blocks; ++b)
+    {
+      const float* p = data + b * 24u;
+      const __m256 v0 = _mm256_loadu_ps(p);
+      const __m256 v1 = _mm256_loadu_ps(p + 8);
+      const __m256 v2 = _mm256_loadu_ps(p + 16);
+      min0 = _mm256_min_ps(v0, min0); max0 = _mm256_max_ps(v0, max0);
+      min1 = _mm256_min_ps(v1, min1); max1 = _mm256_max_ps(v1, max1);
+      min2 = _mm256_min_ps(v2, min2); max2 = _mm256_max_ps(v2, max2);
+    }
+
+    alignas(32) float lanes[24];
+    _mm256_store_ps(lanes, min0); _mm256_store_ps(lanes + 8, min1); _mm256_store_ps(lanes + 16, min2);
+    foldLanes(lanes, 8u, min, max, false);
+    _mm256_store_ps(lanes, max0); _mm256_store_ps(lanes + 8, max1); _mm256_store_ps(lanes + 16, max2);
+    foldLanes(lanes, 8u, min, max, true);
+    _mm256_zeroupper();
+    return blocks * 8u;
+  }
+
+  PE_TARGET_AVX size_t scaleTranslateAVX(float* data, const size_t count, const float scale, const vec3& translation) noexcept
+  {
+    const size_t blocks = count / 8u;
+
+    // The translation repeated over 8 positions, split across the 3 registers
+    alignas(32) float pattern[24];
+    for (size_t i = 0u; i < 24u; ++i)
+      pattern[i] = translation[static_cast<glm::length_t>(i % 3u)];
+
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 t0 = _mm256_load_ps(pattern);
+    const __m256 t1 = _mm256_load_ps(pattern + 8);
+    const __m256 t2 = _mm256_load_ps(pattern + 16);
+    for (size_t b = 0u; b < blocks; ++b)
+    {
+      float* p = data + b * 24u;
+      _mm256_storeu_ps(p, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(p), s), t0));
+      _mm256_storeu_ps(p + 8, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(p + 8), s), t1));
+      _mm256_storeu_ps(p + 16, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(p + 16), s), t2));
+    }
+    _mm256_zeroupper();
+    return blocks * 8u;
+  }
+
+  // SSE2 has no blend, so selects are built from masks. The AVX path does the
+  // same, since some compilers split blendv into integer ops without AVX2.
+  inline __m128 selectSSE2(const __m128 mask, const __m128 a, const __m128 b) noexcept
+  {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+  }
+
+  inline __m128 atan2SSE2(const __m128 y, const __m128 x) noexcept
+  {
+    const __m128 sign = _mm_set1_ps(-0.f);
+    const __m128 ax = _mm_andnot_ps(sign, x);
+    const __m128 ay = _mm_andnot_ps(sign, y);
+    const __m128 a = _mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(FLT_MIN)));
+    const __m128 s = _mm_mul_ps(a, a);
+    __m128 r = _mm_add_ps(_mm_set1_ps(Atan7), _mm_mul_ps(s, _mm_set1_ps(Atan9)));
+    r = _mm_add_ps(_mm_set1_ps(Atan5), _mm_mul_ps(s, r));
+    r = _mm_add_ps(_mm_set1_ps(Atan3), _mm_mul_ps(s, r));
+    r = _mm_add_ps(_mm_set1_ps(Atan1), _mm_mul_ps(s, r));
+    r = _mm_mul_ps(a, r);
+    r = selectSSE2(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(HalfPi), r), r);
+    r = selectSSE2(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(Pi), r), r);
+    return _mm_xor_ps(r, _mm_and_ps(_mm_cmplt_ps(y, _mm_setzero_ps()), sign));
+  }
+
+  // 4 positions per iteration, the same math as projectScalar a lane at a time
+  size_t projectSSE2(const float* data, const size_t count, const Projection& p, float* out) noexcept
+  {
+    const size_t blocks = count / 4u;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 sign = _mm_set1_ps(-0.f);
+    const __m128 minX = _mm_set1_ps(p.Min.x), minY = _mm_set1_ps(p.Min.y);
+    const __m128 centerX = _mm_set1_ps(p.Center.x), centerY = _mm_set1_ps(p.Center.y), centerZ = _mm_set1_ps(p.Center.z);
+    const __m128 inverseX = _mm_set1_ps(p.InverseSize.x), inverseY = _mm_set1_ps(p.InverseSize.y), inverseZ = _mm_set1_ps(p.InverseSize.z);
+
+    for (size_t b = 0u; b < blocks; ++b)
+    {
+      // xyzx yzxy zxyz into xxxx yyyy zzzz
+      const float* in = data + b * 12u;
+      const __m128 v0 = _mm_loadu_ps(in);
+      const __m128 v1 = _mm_loadu_ps(in + 4);
+      const __m128 v2 = _mm_loadu_ps(in + 8);
+      const __m128 x = _mm_shuffle_ps(v0, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+      const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1)),
+        _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+      const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2)), v2, _MM_SHUFFLE(3, 0, 2, 0));
+
+      __m128 u = zero, v = zero;
+      switch (p.Generation)
+      {
+      case UV::Generation::PLANAR:
+      {
+        u = _mm_mul_ps(_mm_sub_ps(x, minX), inverseX);
+        v = _mm_mul_ps(_mm_sub_ps(y, minY), inverseY);
+        break;
+      }
+      case UV::Generation::SPHERICAL:
+      case UV::Generation::CYLINDRICAL:
+      {
+        const __m128 dx = _mm_sub_ps(x, centerX);
+        const __m128 dy = _mm_sub_ps(y, centerY);
+        const __m128 dz = _mm_sub_ps(z, centerZ);
+        __m128 theta = atan2SSE2(dz, dx);
+        theta = _mm_add_ps(theta, _mm_and_ps(_mm_cmplt_ps(theta, zero), _mm_set1_ps(TwoPi)));
+        u = _mm_mul_ps(theta, _mm_set1_ps(1.f / TwoPi));
+
+        if (p.Generation == UV::Generation::SPHERICAL)
+        {
+          const __m128 radial = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)));
+          v = _mm_sub_ps(one, _mm_mul_ps(atan2SSE2(radial, dy), _mm_set1_ps(1.f / Pi)));
+        }
+        else
+        {
+          v = _mm_mul_ps(_mm_sub_ps(y, minY), inverseY);
+        }
+        break;
+      }
+      case UV::Generation::CUBE_MAP:
+      {
+        const __m128 dx = _mm_mul_ps(_mm_sub_ps(x, centerX), inverseX);
+        const __m128 dy = _mm_mul_ps(_mm_sub_ps(y, centerY), inverseY);
+        const __m128 dz = _mm_mul_ps(_mm_sub_ps(z, centerZ), inverseZ);
+        const __m128 ax = _mm_andnot_ps(sign, dx), ay = _mm_andnot_ps(sign, dy), az = _mm_andnot_ps(sign, dz);
+        const __m128 isX = _mm_and_ps(_mm_cmpge_ps(ax, ay), _mm_cmpge_ps(ax, az));
+        const __m128 isY = _mm_andnot_ps(isX, _mm_cmpge_ps(ay, az));
+        const __m128 positiveX = _mm_cmpge_ps(dx, zero);
+        const __m128 positiveY = _mm_cmpge_ps(dy, zero);
+        const __m128 positiveZ = _mm_cmpge_ps(dz, zero);
+        const __m128 negativeX = _mm_xor_ps(dx, sign);
+        const __m128 negativeZ = _mm_xor_ps(dz, sign);
+
+        const __m128 major = selectSSE2(isX, ax, selectSSE2(isY, ay, az));
+        const __m128 s = selectSSE2(isX, selectSSE2(positiveX, negativeZ, dz),
+          selectSSE2(isY, dx, selectSSE2(positiveZ, dx, negativeX)));
+        const __m128 t = selectSSE2(isY, selectSSE2(positiveY, negativeZ, dz), dy);
+        const __m128 column = selectSSE2(isX, _mm_andnot_ps(positiveX, one),
+          selectSSE2(isY, _mm_and_ps(positiveY, _mm_set1_ps(2.f)), selectSSE2(positiveZ, one, _mm_set1_ps(2.f))));
+        const __m128 row = selectSSE2(isX, zero, selectSSE2(isY, _mm_andnot_ps(positiveY, one), one));
+
+        const __m128 scale = _mm_div_ps(half, _mm_max_ps(major, _mm_set1_ps(FLT_MIN)));
+        u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(column, half), _mm_mul_ps(s, scale)), _mm_set1_ps(1.f / 3.f));
+        v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(row, half), _mm_mul_ps(t, scale)), half);
+        break;
+      }
+      case UV::Generation::CUSTOM:
+      default:
+        break;
+      }
+
+      float* uv = out + b * 8u;
+      _mm_storeu_ps(uv, _mm_unpacklo_ps(u, v));
+      _mm_storeu_ps(uv + 4, _mm_unpackhi_ps(u, v));
+    }
+    return blocks * 4u;
+  }
+
+  PE_TARGET_AVX inline __m256 selectAVX(const __m256 mask, const __m256 a, const __m256 b) noexcept
+  {
+    return _mm256_or_ps(_mm256_and_ps(mask, a), _mm256_andnot_ps(mask, b));
+  }
+
+  PE_TARGET_AVX inline __m256 atan2AVX(const __m256 y, const __m256 x) noexcept
+  {
+    const __m256 sign = _mm256_set1_ps(-0.f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 ax = _mm256_andnot_ps(sign, x);
+    const __m256 ay = _mm256_andnot_ps(sign, y);
+    const __m256 a = _mm256_div_ps(_mm256_min_ps(ax, ay), _mm256_max_ps(_mm256_max_ps(ax, ay), _mm256_set1_ps(FLT_MIN)));
+    const __m256 s = _mm256_mul_ps(a, a);
+    __m256 r = _mm256_add_ps(_mm256_set1_ps(Atan7), _mm256_mul_ps(s, _mm256_set1_ps(Atan9)));
+    r = _mm256_add_ps(_mm256_set1_ps(Atan5), _mm256_mul_ps(s, r));
+    r = _mm256_add_ps(_mm256_set1_ps(Atan3), _mm256_mul_ps(s, r));
+    r = _mm256_add_ps(_mm256_set1_ps(Atan1), _mm256_mul_ps(s, r));
+    r = _mm256_mul_ps(a, r);
+    r = selectAVX(_mm256_cmp_ps(ay, ax, _CMP_GT_OQ), _mm256_sub_ps(_mm256_set1_ps(HalfPi), r), r);
+    r = selectAVX(_mm256_cmp_ps(x, zero, _CMP_LT_OQ), _mm256_sub_ps(_mm256_set1_ps(Pi), r), r);
+    return _mm256_xor_ps(r, _mm256_and_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), sign));
+  }
+
+  // 4 floats into each 128-bit half, 4 positions apart
+  PE_TARGET_AVX inline __m256 loadHalvesAVX(const float* low) noexcept
+  {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(low + 12), 1);
+  }
+
+  // 8 positions per iteration. Each 128-bit half takes 4 consecutive positions,
+  // so the SSE2 shuffles apply to both halves unchanged.
+  PE_TARGET_AVX size_t projectAVX(const float* data, const size_t count, const Projection& p, float* out) noexcept
+  {
+    const size_t blocks = count / 8u;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 sign = _mm256_set1_ps(-0.f);
+    const __m256 minX = _mm256_set1_ps(p.Min.x), minY = _mm256_set1_ps(p.Min.y);
+    const __m256 centerX = _mm256_set1_ps(p.Center.x), centerY = _mm256_set1_ps(p.Center.y), centerZ = _mm256_set1_ps(p.Center.z);
+    const __m256 inverseX = _mm256_set1_ps(p.InverseSize.x), inverseY = _mm256_set1_ps(p.InverseSize.y), inverseZ = _mm256_set1_ps(p.InverseSize.z);
+
+    for (size_t b = 0u; b < blocks; ++b)
+    {
+      const float* in = data + b * 24u;
+      const __m256 v0 = loadHalvesAVX(in);
+      const __m256 v1 = loadHalvesAVX(in + 4);
+      const __m256 v2 = loadHalvesAVX(in + 8);
+      const __m256 x = _mm256_shuffle_ps(v0, _mm256_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+      const __m256 y = _mm256_shuffle_ps(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1)),
+        _mm256_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+      const __m256 z = _mm256_shuffle_ps(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2)), v2, _MM_SHUFFLE(3, 0, 2, 0));
+
+      __m256 u = zero, v = zero;
+      switch (p.Generation)
+      {
+      case UV::Generation::PLANAR:
+      {
+        u = _mm256_mul_ps(_mm256_sub_ps(x, minX), inverseX);
+        v = _mm256_mul_ps(_mm256_sub_ps(y, minY), inverseY);
+        break;
+      }
+      case UV::Generation::SPHERICAL:
+      case UV::Generation::CYLINDRICAL:
+      {
+        const __m256 dx = _mm256_sub_ps(x, centerX);
+        const __m256 dy = _mm256_sub_ps(y, centerY);
+        const __m256 dz = _mm256_sub_ps(z, centerZ);
+        __m256 theta = atan2AVX(dz, dx);
+        theta = _mm256_add_ps(theta, _mm256_and_ps(_mm256_cmp_ps(theta, zero, _CMP_LT_OQ), _mm256_set1_ps(TwoPi)));
+        u = _mm256_mul_ps(theta, _mm256_set1_ps(1.f / TwoPi));
+
+        if (p.Generation == UV::Generation::SPHERICAL)
+        {
+          const __m256 radial = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz)));
+          v = _mm256_sub_ps(one, _mm256_mul_ps(atan2AVX(radial, dy), _mm256_set1_ps(1.f / Pi)));
+        }
+        else
+        {
+          v = _mm256_mul_ps(_mm256_sub_ps(y, minY), inverseY);
+        }
+        break;
+      }
+      case UV::Generation::CUBE_MAP:
+      {
+        const __m256 dx = _mm256_mul_ps(_mm256_sub_ps(x, centerX), inverseX);
+        const __m256 dy = _mm256_mul_ps(_mm256_sub_ps(y, centerY), inverseY);
+        const __m256 dz = _mm256_mul_ps(_mm256_sub_ps(z, centerZ), inverseZ);
+        const __m256 ax = _mm256_andnot_ps(sign, dx), ay = _mm256_andnot_ps(sign, dy), az = _mm256_andnot_ps(sign, dz);
+        const __m256 isX = _mm256_and_ps(_mm256_cmp_ps(ax, ay, _CMP_GE_OQ), _mm256_cmp_ps(ax, az, _CMP_GE_OQ));
+        const __m256 isY = _mm256_andnot_ps(isX, _mm256_cmp_ps(ay, az, _CMP_GE_OQ));
+        const __m256 positiveX = _mm256_cmp_ps(dx, zero, _CMP_GE_OQ);
+        const __m256 positiveY = _mm256_cmp_ps(dy, zero, _CMP_GE_OQ);
+        const __m256 positiveZ = _mm256_cmp_ps(dz, zero, _CMP_GE_OQ);
+        const __m256 negativeX = _mm256_xor_ps(dx, sign);
+        const __m256 negativeZ = _mm256_xor_ps(dz, sign);
+
+        const __m256 major = selectAVX(isX, ax, selectAVX(isY, ay, az));
+        const __m256 s = selectAVX(isX, selectAVX(positiveX, negativeZ, dz),
+          selectAVX(isY, dx, selectAVX(positiveZ, dx, negativeX)));
+        const __m256 t = selectAVX(isY, selectAVX(positiveY, negativeZ, dz), dy);
+        const __m256 column = selectAVX(isX, _mm256_andnot_ps(positiveX, one),
+          selectAVX(isY, _mm256_and_ps(positiveY, _mm256_set1_ps(2.f)), selectAVX(positiveZ, one, _mm256_set1_ps(2.f))));
+        const __m256 row = selectAVX(isX, zero, selectAVX(isY, _mm256_andnot_ps(positiveY, one), one));
+
+        const __m256 scale = _mm256_div_ps(half, _mm256_max_ps(major, _mm256_set1_ps(FLT_MIN)));
+        u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(column, half), _mm256_mul_ps(s, scale)), _mm256_set1_ps(1.f / 3.f));
+        v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(row, half), _mm256_mul_ps(t, scale)), half);
+        break;
+      }
+      case UV::Generation::CUSTOM:
+      default:
+        break;
+      }
+
+      // The low halves hold the first 4 UVs and the high halves the last 4
+      const __m256 low = _mm256_unpacklo_ps(u, v);
+      const __m256 high = _mm256_unpackhi_ps(u, v);
+      float* uv = out + b * 16u;
+      _mm256_storeu_ps(uv, _mm256_permute2f128_ps(low, high, 0x20));
+      _mm256_storeu_ps(uv + 8, _mm256_permute2f128_ps(low, high, 0x31));
+    }
+    _mm256_zeroupper();
+    return blocks * 8u;
+  }
+#endif
+}
+
+MeshKernels::InstructionSet MeshKernels::GetInstructionSet() noexcept
+{
+  return s_Active.load(std::memory_order_relaxed);
+}
+
+void MeshKernels::SetInstructionSet(const InstructionSet set) noexcept
+{
+  s_Active.store(std::min(set, s_Supported), std::memory_order_relaxed);
+}
+
+const char* MeshKernels::GetInstructionSetName(const InstructionSet set) noexcept
+{
+  switch (set)
+  {
+  case InstructionSet::SSE2:  return "SSE2";
+  case InstructionSet::AVX:   return "AVX";
+  case InstructionSet::SCALAR:
+  default:                    return "SCALAR";
+  }
+}
+
+void MeshKernels::CalculateBounds(const vec3* positions, const size_t count, vec3& min, vec3& max) noexcept
+{
+  min = vec3(FLT_MAX);
+  max = vec3(-FLT_MAX);
+  const float* data = reinterpret_cast<const float*>(positions);
+
+  size_t done = 0u;
+#ifdef PE_SIMD_X64
+  switch (GetInstructionSet())
+  {
+  case InstructionSet::AVX:
+    done = boundsAVX(data, count, min, max);
+    break;
+  case InstructionSet::SSE2:
+    done = boundsSSE2(data, count, min, max);
+    break;
+  default:
+    break;
+  }
+#endif
+
+  // Whatever didn't fill a whole block
+  boundsScalar(data + done * 3u, count - done, min, max);
+}
+
+void MeshKernels::ScaleTranslate(vec3* positions, const size_t count, const float scale, const vec3& translation) noexcept
+{
+  float* data = reinterpret_cast<float*>(positions);
+
+  size_t done = 0u;
+#ifdef PE_SIMD_X64
+  switch (GetInstructionSet())
+  {
+  case InstructionSet::AVX:
+    done = scaleTranslateAVX(data, count, scale, translation);
+    break;
+  case InstructionSet::SSE2:
+    done = scaleTranslateSSE2(data, count, scale, translation);
+    break;
+  default:
+    break;
+  }
+#endif
+
+  scaleTranslateScalar(data + done * 3u, count - done, scale, translation);
+}
+
+void MeshKernels::ProjectTexcoords(const vec3* positions, const size_t count, const UV::Generation generation,
+  const vec3& min, const vec3& center, const vec3& inverseSize, vec2* texcoords) noexcept
+{
+  const float* data = reinterpret_cast<const float*>(positions);
+  float* out = reinterpret_cast<float*>(texcoords);
+  const Projection projection{ generation, min, center, inverseSize };
+
+  size_t done = 0u;
+#ifdef PE_SIMD_X64
+  switch (GetInstructionSet())
+  {
+  case InstructionSet::AVX:
+    done = projectAVX(data, count, projection, out);
+    break;
+  case InstructionSet::SSE2:
+    done = projectSSE2(data, count, projection, out);
+    break;
+  default:
+    break;
+  }
+#endif
+
+  projectScalar(data + done * 3u, count - done, projection, out + done * 2u);
+}
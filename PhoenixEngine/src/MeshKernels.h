@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+// File:    MeshKernels.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Vectorized (SSE/AVX) sweeps over mesh position streams
+//------------------------------------------------------------------------------
+#pragma once
+#include "GraphicsCommon.h"
+
+namespace MeshKernels
+{
+  // Largest difference between ProjectTexcoords and the exact projections, in
+  // UV units. Dominated by the arctangent polynomial (Abramowitz and Stegun
+  // 4.4.49, within 1e-5 radians) spread over pi for spherical V.
+  constexpr float TEXCOORD_PROJECTION_ERROR = 5e-6f;
+
+  /// <summary>
+  /// The widest instruction set the kernels use. AVX is picked at runtime if
+  /// the CPU and OS support it, x64 always has SSE2, anything else is scalar.
+  /// </summary>
+  enum class InstructionSet
+  {
+    SCALAR,
+    SSE2,
+    AVX
+  };
+
+  /// <summary>
+  /// Gets the instruction set the kernels currently run with
+  /// </summary>
+  InstructionSet GetInstructionSet() noexcept;
+
+  /// <summary>
+  /// Limits the kernels to an instruction set, e.g. to compare against the
+  /// scalar path. Requests above what the CPU supports are clamped.
+  /// </summary>
+  /// <param name="set">The widest instruction set to use</param>
+  void SetInstructionSet(InstructionSet set) noexcept;
+
+  /// <summary>
+  /// Gets the name an instruction set is reported under
+  /// </summary>
+  const char* GetInstructionSetName(InstructionSet set) noexcept;
+
+  /// <summary>
+  /// Finds the component-wise min and max of a stream of positions. NaNs are skipped.
+  /// </summary>
+  /// <param name="positions">The positions to scan</param>
+  /// <param name="count">Number of positions</param>
+  /// <param name="min">[Out] Smallest x, y and z, FLT_MAX if count is 0</param>
+  /// <param name="max">[Out] Largest x, y and z, -FLT_MAX if count is 0</param>
+  void CalculateBounds(const vec3* positions, size_t count, vec3& min, vec3& max) noexcept;
+
+  /// <summary>
+  /// Applies p = p * scale + translation to a stream of positions in place
+  /// </summary>
+  /// <param name="positions">The positions to transform</param>
+  /// <param name="count">Number of positions</param>
+  /// <param name="scale">Uniform scale</param>
+  /// <param name="translation">Translation applied after the scale</param>
+  void ScaleTranslate(vec3* positions, size_t count, float scale, const vec3& translation) noexcept;
+
+  /// <summary>
+  /// Projects a stream of positions to UV coordinates. Spherical and
+  /// cylindrical U and spherical V use a polynomial arctangent instead of
+  /// atan and acos, within TEXCOORD_PROJECTION_ERROR of the exact angles.
+  /// The cube map lays the six faces of the bounding box out in a 3x2 atlas,
+  /// +X -X +Y along the bottom row and -Y +Z -Z along the top.
+  /// </summary>
+  /// <param name="positions">The positions to project</param>
+  /// <param name="count">Number of positions</param>
+  /// <param name="generation">The projection, CUSTOM writes zeros</param>
+  /// <param name="min">Bounding box minimum</param>
+  /// <param name="center">Bounding box center</param>
+  /// <param name="inverseSize">Reciprocal of the bounding box size, 0 for flat axes</param>
+  /// <param name="texcoords">[Out] Receives one UV per position</param>
+  void ProjectTexcoords(const vec3* positions, size_t count, UV::Generation generation,
+    const vec3& min, const vec3& center, const vec3& inverseSize, vec2* texcoords) noexcept;
+}
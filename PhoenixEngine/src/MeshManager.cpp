@@ -9,6 +9,13 @@
 #include "Transform.h"
 #include "glm/ext/scalar_constants.inl"
 #include "DebugRenderer.h"
+#include "MemoryStats.h"
+#include "AssetLoader.h"
+#include "MeshPostProcess.h"
+#include "MeshletBuilder.h"
+#include "MaterialLibrary.h"
+
+#include <filesystem>
 
 #pragma region ImGui
 
@@ -20,209 +27,1043 @@
 
 #pragma endregion
 
-MeshManager::MeshManager() noexcept
+MeshManager::MeshManager() noexcept :
+  m_Registry(make_shared<MeshRegistry>()),
+  m_Placeholder(),
+  m_DefaultResidency(Residency::FULL),
+  m_StopWorkers(false),
+  m_UploadBudget(DEFAULT_UPLOAD_BUDGET),
+  m_BindTangents(false),
+  m_DrawCounts(),
+  m_DrawOffsets(),
+  m_DrawBaseVertices()
 {
-  //TODO: This can probably be circumvented
-  // Probably remove this after AssImp
-  m_ObjReader.initData();
+  m_Workers.reserve(WORKER_COUNT);
+  for (unsigned i = 0u; i < WORKER_COUNT; ++i)
+    m_Workers.emplace_back(&MeshManager::WorkerLoop, this);
 }
 
 MeshManager::~MeshManager()
 {
+  {
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+    m_StopWorkers = true;
+  }
+  m_JobSignal.notify_all();
+  for (std::thread& worker : m_Workers)
+    worker.join();
+
   UnloadMeshes();
 }
 
-unsigned MeshManager::LoadMesh(
+MeshHandle MeshManager::LoadMesh(
   const string& FileName,
   const bool ScaleToUnitSize,
   const bool ResetOrigin,
-  const UV::Generation UvGeneration) noexcept
+  const UV::Generation UvGeneration,
+  const bool OptimizeVertexCache,
+  const bool GenerateLods,
+  const bool QuantizeVertices,
+  const bool BuildMeshlets,
+  const bool WeldVertices,
+  const bool GenerateTangents) noexcept
 {
-  // Check if this mesh has already been loaded
-  for (unsigned i = 0u; i < m_MeshArray.size(); ++i)
+  const MeshCache::Options cacheOptions = { ScaleToUnitSize, ResetOrigin, UvGeneration, OptimizeVertexCache,
+    GenerateLods, QuantizeVertices, BuildMeshlets, WeldVertices, GenerateTangents };
+
+  // Check if this mesh has already been loaded with these options
+  const MeshHandle existing = m_Registry->Find(FileName, cacheOptions);
+  if (existing.Index != Error::INVALID_INDEX)
+    return existing;
+
+  ScaleToUnitSize ? Log::Trace("Loading mesh: " + FileName) : Log::Trace("Loading [Unit] mesh: " + FileName);
+
+  // Claim the slot now so the handle can be given out straight away
+  const MeshHandle handle = m_Registry->Insert(FileName, cacheOptions);
+  const unsigned index = handle.Index;
+  if (index >= m_MeshArray.size())
+  {
+    m_MeshArray.resize(index + 1u);
+    m_MeshDataArray.resize(index + 1u);
+  }
+  m_MeshDataArray[index] = MeshData(FileName);
+  m_MeshDataArray[index].Options = cacheOptions;
+  m_MeshDataArray[index].Policy = m_DefaultResidency;
+
+  // The procedural sphere is cheap enough to build in place
+  if (FileName == "sphere")
   {
-    if (m_MeshDataArray[i].FileName == FileName)
+    Mesh& mesh = m_MeshArray[index];
+    BuildSphere(mesh);
+    MeshPostProcess::Apply(mesh, cacheOptions);
+
+    // A few hundred vertices, always within 16 bit indices
+    IndexBuffer::ShortIndices indices;
+    IndexBuffer::AppendShort(mesh.m_TriangleArray.data(), mesh.m_TriangleArray.size(), mesh.GetVertexCount(), indices);
+    IndexBuffer::AppendShort(mesh.m_LodTriangleArray.data(), mesh.m_LodTriangleArray.size(), mesh.GetVertexCount(), indices);
+    const size_t indexSize = indices.Indices.size() * sizeof(uint16_t);
+    m_MeshDataArray[index].IndexType = GL_UNSIGNED_SHORT;
+    m_MeshDataArray[index].IndexRanges = std::move(indices.Ranges);
+
+    m_MeshDataArray[index].IsQuantized = mesh.VertexDataIsQuantized();
+    const size_t tangentSize = mesh.m_TangentData.size() * sizeof(uint32_t);
+    if (mesh.VertexDataIsQuantized())
+      CreateMeshBuffers(index, mesh.m_PackedVertexData.data(), mesh.m_PackedVertexData.size() * sizeof(Mesh::PackedVertexData),
+        indices.Indices.data(), indexSize, mesh.m_TangentData.data(), tangentSize);
+    else
+      CreateMeshBuffers(index, mesh.m_VertexData.data(), mesh.m_VertexData.size() * sizeof(Mesh::VertexData),
+        indices.Indices.data(), indexSize, mesh.m_TangentData.data(), tangentSize);
+    CreateVertexArray(index);
+    SetDrawData(index, mesh);
+    m_MeshDataArray[index].Held = Residency::FULL;
+    ApplyResidency(index);
+    m_MeshDataArray[index].State = LoadState::LOADED;
+    Log::Trace("Mesh: " + FileName + " loaded.");
+    return handle;
+  }
+
+  auto job = make_unique<LoadJob>();
+  job->Id = index;
+  job->Generation = handle.Generation;
+  job->FileName = FileName;
+  job->Options = cacheOptions;
+  {
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+    m_QueuedJobs.push_back(std::move(job));
+  }
+  m_JobSignal.notify_one();
+
+  return handle;
+}
+
+void MeshManager::WorkerLoop() noexcept
+{
+  while (true)
+  {
+    unique_ptr<LoadJob> job;
     {
-      return i;
+      std::unique_lock<std::mutex> lock(m_JobMutex);
+      m_JobSignal.wait(lock, [this] { return m_StopWorkers || !m_QueuedJobs.empty(); });
+      if (m_StopWorkers)
+        return;
+      job = std::move(m_QueuedJobs.front());
+      m_QueuedJobs.pop_front();
     }
+
+    ProcessJob(*job);
+
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+    m_CompletedJobs.push_back(std::move(job));
   }
-  ScaleToUnitSize ? Log::Trace("Loading mesh: " + FileName) : Log::Trace("Loading [Unit] mesh: " + FileName);
+}
 
-  unsigned index = numeric_limits<unsigned>::max();
-  if (FileName == "sphere")
+void MeshManager::ProcessJob(LoadJob& Job) noexcept
+{
+  // Processed before with these options, upload straight from the cache.
+  // The cache only has the GPU data, so reloads of the arrays skip it.
+  if (!Job.IsReload && Job.Cache.Open(Job.FileName, Job.Options))
+  {
+    Job.IsCached = true;
+    Job.IsQuantized = Job.Cache.IsQuantized();
+    Job.Succeeded = true;
+    if (Job.IsQuantized)
+    {
+      Job.VertexBytes = reinterpret_cast<const char*>(Job.Cache.GetPackedVertexData());
+      Job.VertexSize = Job.Cache.GetVertexCount() * sizeof(Mesh::PackedVertexData);
+    }
+    else
+    {
+      Job.VertexBytes = reinterpret_cast<const char*>(Job.Cache.GetVertexData());
+      Job.VertexSize = Job.Cache.GetVertexCount() * sizeof(Mesh::VertexData);
+    }
+    if (Job.Cache.HasTangents())
+    {
+      Job.TangentBytes = reinterpret_cast<const char*>(Job.Cache.GetTangents());
+      Job.TangentSize = Job.Cache.GetVertexCount() * sizeof(uint32_t);
+    }
+    Job.TriangleBytes = reinterpret_cast<const char*>(Job.Cache.GetTriangles());
+    Job.TriangleSize = Job.Cache.GetTriangleCount() * sizeof(Mesh::Triangle);
+    PackIndices(Job, Job.Cache.GetVertexCount());
+    ReadMaterialLibrary(Job, Job.Cache.GetMaterialLibrary());
+    Log::Trace("Mesh: " + Job.FileName + " loaded from cache.");
+    return;
+  }
+
+  // Hasn't been loaded. OBJ has its own reader, everything else goes through Assimp
+  const bool isOBJ = std::filesystem::path(Job.FileName).extension() == ".obj";
+  if (isOBJ ? !LoadMeshFromOBJ(Job.FileName, Job.Result) : !AssetLoader::LoadMesh(Job.FileName, Job.Result))
+  {
+    Log::Error("Could not load mesh file: " + Job.FileName);
+    return;
+  }
+
+  MeshPostProcess::Apply(Job.Result, Job.Options);
+  if (Job.IsReload)
+  {
+    Job.Succeeded = true;
+    return;
+  }
+
+  // Save the processed result so the next load skips all of the above
+  MeshCache::Write(Job.FileName, Job.Options, Job.Result);
+
+  Job.Succeeded = true;
+  Job.IsQuantized = Job.Result.VertexDataIsQuantized();
+  if (Job.IsQuantized)
   {
-    // Load procedural sphere
-    index = LoadSphere();
+    Job.VertexBytes = reinterpret_cast<const char*>(Job.Result.m_PackedVertexData.data());
+    Job.VertexSize = Job.Result.m_PackedVertexData.size() * sizeof(Mesh::PackedVertexData);
   }
   else
   {
-    // Hasn't been loaded. Load from OBJ
-    index = LoadMeshFromOBJ(FileName);
-    if (index == Error::INVALID_INDEX)
+    Job.VertexBytes = reinterpret_cast<const char*>(Job.Result.m_VertexData.data());
+    Job.VertexSize = Job.Result.m_VertexData.size() * sizeof(Mesh::VertexData);
+  }
+  Job.TangentBytes = reinterpret_cast<const char*>(Job.Result.m_TangentData.data());
+  Job.TangentSize = Job.Result.m_TangentData.size() * sizeof(uint32_t);
+  Job.TriangleBytes = reinterpret_cast<const char*>(Job.Result.m_TriangleArray.data());
+  Job.TriangleSize = Job.Result.m_TriangleArray.size() * sizeof(Mesh::Triangle);
+  Job.LodTriangleBytes = reinterpret_cast<const char*>(Job.Result.m_LodTriangleArray.data());
+  Job.LodTriangleSize = Job.Result.m_LodTriangleArray.size() * sizeof(Mesh::Triangle);
+  PackIndices(Job, Job.Result.GetVertexCount());
+  ReadMaterialLibrary(Job, Job.Result.GetMaterialLibrary());
+}
+
+void MeshManager::ReadMaterialLibrary(LoadJob& Job, const string& Library) noexcept
+{
+  // The library is small next to the mesh, but it is still a file to read off the render thread
+  if (!Library.empty() && !MaterialLibrary::Read(Library, Job.Materials))
+    Log::Warn("Could not read material library: " + Library + " of mesh: " + Job.FileName);
+}
+
+void MeshManager::PackIndices(LoadJob& Job, const size_t VertexCount) noexcept
+{
+  const auto* triangles = reinterpret_cast<const Mesh::Triangle*>(Job.TriangleBytes);
+  const auto* lodTriangles = reinterpret_cast<const Mesh::Triangle*>(Job.LodTriangleBytes);
+  const size_t triangleCount = Job.TriangleSize / sizeof(Mesh::Triangle);
+  const size_t lodTriangleCount = Job.LodTriangleSize / sizeof(Mesh::Triangle);
+
+  // The levels of detail index the same vertices, so they follow in the same buffer
+  IndexBuffer::ShortIndices& packed = Job.ShortIndices;
+  if (!IndexBuffer::AppendShort(triangles, triangleCount, VertexCount, packed) ||
+    !IndexBuffer::AppendShort(lodTriangles, lodTriangleCount, VertexCount, packed) ||
+    IndexBuffer::IsFragmented(packed))
+  {
+    // Uploaded as 32 bit indices, straight from the triangles
+    packed = IndexBuffer::ShortIndices();
+    return;
+  }
+
+  if (packed.Ranges.size() > 1u)
+    Log::Trace("Mesh: " + Job.FileName + " split into " + std::to_string(packed.Ranges.size()) + " 16 bit index ranges.");
+
+  Job.TriangleBytes = reinterpret_cast<const char*>(packed.Indices.data());
+  Job.TriangleSize = 3u * triangleCount * sizeof(uint16_t);
+  Job.LodTriangleBytes = Job.TriangleBytes + Job.TriangleSize;
+  Job.LodTriangleSize = 3u * lodTriangleCount * sizeof(uint16_t);
+}
+
+void MeshManager::ProcessUploads() noexcept
+{
+  size_t budget = m_UploadBudget;
+  while (budget > 0u)
+  {
+    if (!m_CurrentUpload)
     {
-      Log::Error("Could not load from OBJ file: " + FileName);
-      return Error::INVALID_INDEX;
+      {
+        std::lock_guard<std::mutex> lock(m_JobMutex);
+        if (m_CompletedJobs.empty())
+          return;
+        m_CurrentUpload = std::move(m_CompletedJobs.front());
+        m_CompletedJobs.pop_front();
+      }
+
+      LoadJob& job = *m_CurrentUpload;
+      // The mesh was freed while it was being processed
+      if (!m_Registry->IsValid(MeshHandle{ job.Id, job.Generation }))
+      {
+        m_CurrentUpload.reset();
+        continue;
+      }
+      if (job.IsReload)
+      {
+        FinishReload(job);
+        m_CurrentUpload.reset();
+        continue;
+      }
+      if (!job.Succeeded)
+      {
+        m_MeshDataArray[job.Id].State = LoadState::FAILED;
+        m_CurrentUpload.reset();
+        continue;
+      }
+
+      // Allocate the GPU storage now, the contents follow as the budget allows
+      m_MeshDataArray[job.Id].IsQuantized = job.IsQuantized;
+      if (!job.ShortIndices.Indices.empty())
+      {
+        m_MeshDataArray[job.Id].IndexType = GL_UNSIGNED_SHORT;
+        m_MeshDataArray[job.Id].IndexRanges = job.ShortIndices.Ranges;
+      }
+      CreateMeshBuffers(job.Id, nullptr, job.VertexSize, nullptr, job.TriangleSize + job.LodTriangleSize, nullptr, job.TangentSize);
+      m_MeshDataArray[job.Id].State = LoadState::UPLOADING;
+    }
+
+    budget -= UploadJobRange(*m_CurrentUpload, budget);
+
+    const LoadJob& upload = *m_CurrentUpload;
+    if (upload.UploadedSize == upload.VertexSize + upload.TangentSize + upload.TriangleSize + upload.LodTriangleSize)
+    {
+      FinishUpload(*m_CurrentUpload);
+      m_CurrentUpload.reset();
     }
   }
+}
 
-  // Set up reference for legibility
-  Mesh& mesh = m_MeshArray[index];
+size_t MeshManager::UploadJobRange(LoadJob& Job, const size_t Budget) noexcept
+{
+  const MeshData& meshData = m_MeshDataArray[Job.Id];
+  size_t uploaded = 0u;
 
-  // Scale to unit size (1x1x1 cube)
-  if (ScaleToUnitSize)
+  // The sources in upload order: the vertex buffer, the tangent stream, then
+  // the index buffer, whose levels of detail follow the full detail triangles
+  struct Segment
   {
-    mesh.ScaleToUnitSize();
+    GLenum Target;
+    GLuint BufferId;
+    const char* Bytes;
+    size_t Size;
+    size_t BufferOffset;
+  };
+  const Segment segments[] =
+  {
+    { GL_ARRAY_BUFFER, meshData.PositionBufferId, Job.VertexBytes, Job.VertexSize, 0u },
+    { GL_ARRAY_BUFFER, meshData.TangentBufferId, Job.TangentBytes, Job.TangentSize, 0u },
+    { GL_ELEMENT_ARRAY_BUFFER, meshData.TriangleBufferId, Job.TriangleBytes, Job.TriangleSize, 0u },
+    { GL_ELEMENT_ARRAY_BUFFER, meshData.TriangleBufferId, Job.LodTriangleBytes, Job.LodTriangleSize, Job.TriangleSize }
+  };
+
+  size_t segmentStart = 0u;
+  for (const Segment& segment : segments)
+  {
+    const size_t segmentEnd = segmentStart + segment.Size;
+    if (Job.UploadedSize < segmentEnd && uploaded < Budget)
+    {
+      const size_t offset = Job.UploadedSize - segmentStart;
+      const size_t size = std::min(segment.Size - offset, Budget - uploaded);
+      glBindBuffer(segment.Target, segment.BufferId);
+      glBufferSubData(segment.Target, static_cast<GLintptr>(segment.BufferOffset + offset),
+        static_cast<GLsizeiptr>(size), segment.Bytes + offset);
+      glBindBuffer(segment.Target, 0u);
+      uploaded += size;
+      Job.UploadedSize += size;
+    }
+    segmentStart = segmentEnd;
   }
 
-  // Reset the origin to the centroid
-  if (ResetOrigin)
+  return uploaded;
+}
+
+void MeshManager::FinishUpload(LoadJob& Job) noexcept
+{
+  CreateVertexArray(Job.Id);
+
+  MeshData& meshData = m_MeshDataArray[Job.Id];
+  if (Job.IsCached)
   {
-    mesh.ResetOriginToCentroid();
+    // The processed data only lives on the GPU, the collision copy is all
+    // that can be had from it without reading the source again
+    Mesh& mesh = m_MeshArray[Job.Id];
+    mesh = Mesh(Job.Cache.GetOrigin());
+    mesh.SetNormalsAreCalculated(true);
+    if (meshData.Policy >= Residency::COLLISION)
+    {
+      CopyCollisionData(Job.Cache, mesh);
+      meshData.Held = Residency::COLLISION;
+    }
+    mesh.SetBoundingBox(Job.Cache.GetBounds());
+    mesh.m_BoundingVolumes = Job.Cache.GetBoundingVolumes();
+    SetDrawData(Job.Id, Job.Cache);
+    SetMaterials(Job.Id, Job.Cache.GetMaterialNames(), Job.Materials);
+  }
+  else
+  {
+    m_MeshArray[Job.Id] = std::move(Job.Result);
+    SetDrawData(Job.Id, m_MeshArray[Job.Id]);
+    SetMaterials(Job.Id, m_MeshArray[Job.Id].GetMaterialNames(), Job.Materials);
+    meshData.Held = Residency::FULL;
+    ApplyResidency(Job.Id);
   }
 
-  // If the normals weren't calculated, calculate them now
-  if (!mesh.NormalsAreCalculated())
-    mesh.CalculateNormals();
+  meshData.State = LoadState::LOADED;
+  Log::Trace("Mesh: " + Job.FileName + " loaded.");
+}
 
-  // Generate the UVs
-  mesh.GenerateTexcoords(UvGeneration);
+void MeshManager::FinishReload(LoadJob& Job) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Job.Id];
+  meshData.ReloadQueued = false;
+  if (!Job.Succeeded)
+  {
+    meshData.ReloadFailed = true;
+    Log::Error("Could not reload the arrays of mesh: " + Job.FileName);
+    return;
+  }
 
-  // Assemble the Vertex Data for the GPU
-  mesh.AssembleVertexData();
+  // Processing is deterministic, so the arrays match what is on the GPU
+  m_MeshArray[Job.Id] = std::move(Job.Result);
+  meshData.Held = Residency::FULL;
+  Log::Trace("Mesh: " + Job.FileName + " arrays reloaded.");
+}
 
-  // The Vertex buffer
-  glGenBuffers(1, &m_MeshDataArray[index].PositionBufferId);
-  glBindBuffer(GL_ARRAY_BUFFER, m_MeshDataArray[index].PositionBufferId);
-  glBufferData(GL_ARRAY_BUFFER, mesh.GetVertexCount() * sizeof(Mesh::VertexData),
-    mesh.m_VertexData.data(), GL_STATIC_DRAW);
+bool MeshManager::RequireArrays(const unsigned Id, const Residency Needed) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
+  if (meshData.Held >= Needed)
+    return true;
+  if (meshData.State != LoadState::LOADED || meshData.ReloadQueued || meshData.ReloadFailed)
+    return false;
+
+  // The procedural sphere is rebuilt from scratch, like when it was loaded. The
+  // kept arrays and origin would otherwise feed into the rebuild.
+  if (meshData.FileName == "sphere")
+  {
+    Mesh& mesh = m_MeshArray[Id];
+    mesh = Mesh();
+    BuildSphere(mesh);
+    MeshPostProcess::Apply(mesh, meshData.Options);
+    meshData.Held = Residency::FULL;
+    return true;
+  }
+
+  // Everything is read back, the next trim drops what isn't needed
+  auto job = make_unique<LoadJob>();
+  job->Id = Id;
+  job->Generation = m_Registry->GetGeneration(Id);
+  job->FileName = meshData.FileName;
+  job->Options = meshData.Options;
+  job->IsReload = true;
+  {
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+    m_QueuedJobs.push_back(std::move(job));
+  }
+  m_JobSignal.notify_one();
+  meshData.ReloadQueued = true;
+  return false;
+}
+
+void MeshManager::ApplyResidency(const unsigned Id) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
+  if (meshData.Held <= meshData.Policy)
+    return;
+
+  m_MeshArray[Id].ReleaseArrays(meshData.Policy == Residency::COLLISION);
+  meshData.Held = meshData.Policy;
+}
+
+void MeshManager::CopyCollisionData(const MeshCache& Cache, Mesh& Result) noexcept
+{
+  const unsigned vertexCount = Cache.GetVertexCount();
+  Result.m_PositionArray.resize(vertexCount);
+  if (Cache.IsQuantized())
+  {
+    vec3 offset, scale;
+    Mesh::GetPositionDequantization(Cache.GetBounds(), offset, scale);
+    const Mesh::PackedVertexData* packed = Cache.GetPackedVertexData();
+    for (unsigned i = 0u; i < vertexCount; ++i)
+    {
+      const vec3 position(packed[i].Position[0], packed[i].Position[1], packed[i].Position[2]);
+      Result.m_PositionArray[i] = offset + position * (1.f / 65535.f) * scale;
+    }
+  }
+  else
+  {
+    const Mesh::VertexData* vertices = Cache.GetVertexData();
+    for (unsigned i = 0u; i < vertexCount; ++i)
+      Result.m_PositionArray[i] = vertices[i].Position;
+  }
+
+  // Only the full detail triangles, the levels of detail follow them
+  const unsigned triangleCount = Cache.GetLodCount() > 0u ?
+    Cache.GetLevelsOfDetail()[0].TriangleCount : Cache.GetTriangleCount();
+  Result.m_TriangleArray.assign(Cache.GetTriangles(), Cache.GetTriangles() + triangleCount);
+}
+
+void MeshManager::SetDrawData(const unsigned Id, const Mesh& Source) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
+  meshData.Lods = Source.GetLevelsOfDetail();
+  meshData.Meshlets = Source.GetMeshlets();
+  meshData.Submeshes = Source.GetSubmeshes();
+  meshData.SubmeshCount = Source.GetSubmeshCount();
+  SetBounds(Id, Source.GetBoundingVolumes());
+}
+
+void MeshManager::SetDrawData(const unsigned Id, const MeshCache& Cache) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
+  meshData.Lods.assign(Cache.GetLevelsOfDetail(), Cache.GetLevelsOfDetail() + Cache.GetLodCount());
+  meshData.Meshlets.assign(Cache.GetMeshlets(), Cache.GetMeshlets() + Cache.GetMeshletCount());
+  meshData.Submeshes.assign(Cache.GetSubmeshes(), Cache.GetSubmeshes() + Cache.GetSubmeshRangeCount());
+  meshData.SubmeshCount = Cache.GetSubmeshCount();
+  SetBounds(Id, Cache.GetBoundingVolumes());
+}
+
+void MeshManager::SetBounds(const unsigned Id, const Mesh::BoundingVolumes& Bounds) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
+  meshData.Bounds = Bounds;
+
+  // Packed positions were quantized across the same box
+  if (meshData.IsQuantized)
+    Mesh::GetPositionDequantization(Bounds.Aabb, meshData.PositionOffset, meshData.PositionScale);
+}
+
+void MeshManager::SetMaterials(const unsigned Id, const vector<string>& Names,
+  const std::map<string, Material>& Library) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
+  const Material basic(Material::Type::BASIC);
+  meshData.Materials.clear();
+  meshData.MaterialFound.clear();
+  meshData.Materials.reserve(Names.size());
+  for (const string& name : Names)
+  {
+    const auto material = Library.find(name);
+    meshData.Materials.push_back(material != Library.end() ? material->second : basic);
+    meshData.MaterialFound.push_back(material != Library.end());
+  }
+}
+
+void MeshManager::CreateMeshBuffers(
+  const unsigned Id,
+  const void* Vertices,
+  const size_t VertexSize,
+  const void* Triangles,
+  const size_t TriangleSize,
+  const void* Tangents,
+  const size_t TangentSize) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
+  meshData.VertexCount = static_cast<unsigned>(VertexSize /
+    (meshData.IsQuantized ? sizeof(Mesh::PackedVertexData) : sizeof(Mesh::VertexData)));
+  meshData.TriangleCount = static_cast<unsigned>(TriangleSize / (3u * meshData.IndexSize()));
+
+  // The Vertex buffer, contents may follow with glBufferSubData
+  glGenBuffers(1, &meshData.PositionBufferId);
+  glBindBuffer(GL_ARRAY_BUFFER, meshData.PositionBufferId);
+  glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(VertexSize), Vertices, GL_STATIC_DRAW);
 
   // The Triangle buffer
-  glGenBuffers(1, &m_MeshDataArray[index].TriangleBufferId);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_MeshDataArray[index].TriangleBufferId);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.GetTriangleCount() * sizeof(Mesh::Triangle),
-    mesh.m_TriangleArray.data(), GL_STATIC_DRAW);
+  glGenBuffers(1, &meshData.TriangleBufferId);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshData.TriangleBufferId);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(TriangleSize), Triangles, GL_STATIC_DRAW);
+
+  // The Tangent buffer, a separate stream so contexts without normal maps never fetch it
+  if (TangentSize > 0u)
+  {
+    glGenBuffers(1, &meshData.TangentBufferId);
+    glBindBuffer(GL_ARRAY_BUFFER, meshData.TangentBufferId);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(TangentSize), Tangents, GL_STATIC_DRAW);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0u);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0u);
+}
+
+void MeshManager::CreateVertexArray(const unsigned Id) noexcept
+{
+  MeshData& meshData = m_MeshDataArray[Id];
 
-  glGenVertexArrays(1, &m_MeshDataArray[index].VertexArrayId);
-  glBindVertexArray(m_MeshDataArray[index].VertexArrayId);
+  glGenVertexArrays(1, &meshData.VertexArrayId);
+  glBindVertexArray(meshData.VertexArrayId);
+  glBindBuffer(GL_ARRAY_BUFFER, meshData.PositionBufferId);
 
-  // Position
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), 0);
+  if (meshData.IsQuantized)
+  {
+    // Position, 0 to 1 across the bounds, the vertex shader scales it back
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Mesh::PackedVertexData),
+      reinterpret_cast<void*>(offsetof(Mesh::PackedVertexData, Position)));
+    // Normal, the unused fourth component is dropped by the shader
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(Mesh::PackedVertexData),
+      reinterpret_cast<void*>(offsetof(Mesh::PackedVertexData, Normal)));
+    // Texcoord
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(Mesh::PackedVertexData),
+      reinterpret_cast<void*>(offsetof(Mesh::PackedVertexData, Texcoord)));
+  }
+  else
+  {
+    // Position
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), 0);
+    // Normal
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), reinterpret_cast<void*>(sizeof(vec3)));
+    // Texcoord
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), reinterpret_cast<void*>(sizeof(vec3) * 2));
+  }
   glEnableVertexAttribArray(0);
-  // Normal
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), reinterpret_cast<void*>(sizeof(vec3)));
   glEnableVertexAttribArray(1);
-  // Texcoord
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), reinterpret_cast<void*>(sizeof(vec3) * 2));
   glEnableVertexAttribArray(2);
 
+  // Tangent, the sign of the bitangent in w. Left disabled, BindDrawState enables
+  // it for the contexts that read it.
+  if (meshData.TangentBufferId != Error::INVALID_INDEX)
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, meshData.TangentBufferId);
+    glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(uint32_t), 0);
+  }
+
   glBindVertexArray(0u);
+  glBindBuffer(GL_ARRAY_BUFFER, 0u);
+}
 
-  Log::Trace("Mesh: " + FileName + " loaded.");
+void MeshManager::UnloadMeshes() noexcept
+{
+  // Loads still in flight target slots that are about to disappear
+  {
+    std::lock_guard<std::mutex> lock(m_JobMutex);
+    m_QueuedJobs.clear();
+  }
 
-  return index;
+  for (const unsigned index : m_Registry->Clear())
+    FreeMesh(index);
 }
 
-void MeshManager::UnloadMeshes() noexcept
+void MeshManager::ReleaseUnusedMeshes() noexcept
 {
-  for (auto& i : m_MeshDataArray)
+  for (const unsigned index : m_Registry->CollectUnused())
+    FreeMesh(index);
+
+  // Reloaded arrays go again once nothing has drawn from them for a frame
+  for (unsigned index = 0u; index < m_MeshDataArray.size(); ++index)
   {
-    glDeleteVertexArrays(1, &i.VertexArrayId);
+    MeshData& meshData = m_MeshDataArray[index];
+    if (meshData.State == LoadState::LOADED && !meshData.ArraysWanted)
+      ApplyResidency(index);
+    meshData.ArraysWanted = false;
+  }
+}
+
+void MeshManager::SetResidency(const MeshHandle& Handle, const Residency Policy) noexcept
+{
+  if (!m_Registry->IsValid(Handle))
+    return;
+
+  MeshData& meshData = m_MeshDataArray[Handle.Index];
+  meshData.Policy = Policy;
+  if (meshData.State != LoadState::LOADED)
+    return;
+  if (meshData.Held > Policy)
+    ApplyResidency(Handle.Index);
+  else
+    RequireArrays(Handle.Index, Policy);
+}
+
+MeshManager::Residency MeshManager::GetResidency(const MeshHandle& Handle) const noexcept
+{
+  if (!m_Registry->IsValid(Handle))
+    return Residency::BOUNDS;
+  return m_MeshDataArray[Handle.Index].Held;
+}
+
+void MeshManager::FreeMesh(const unsigned Id) noexcept
+{
+  // Stop uploading into buffers that are about to be deleted
+  if (m_CurrentUpload && m_CurrentUpload->Id == Id)
+    m_CurrentUpload.reset();
+
+  MeshData& meshData = m_MeshDataArray[Id];
+  if (meshData.VertexArrayId != Error::INVALID_INDEX)
+    glDeleteVertexArrays(1, &meshData.VertexArrayId);
+  if (meshData.PositionBufferId != Error::INVALID_INDEX)
+    glDeleteBuffers(1, &meshData.PositionBufferId);
+  if (meshData.TriangleBufferId != Error::INVALID_INDEX)
+    glDeleteBuffers(1, &meshData.TriangleBufferId);
+  if (meshData.TangentBufferId != Error::INVALID_INDEX)
+    glDeleteBuffers(1, &meshData.TangentBufferId);
+
+  Log::Trace("Mesh '" + meshData.FileName + "' destroyed.");
+
+  // Assigning fresh objects releases the CPU side arrays as well
+  m_MeshArray[Id] = Mesh();
+  meshData = MeshData();
+}
+
+MeshManager::LoadState MeshManager::GetLoadState(const MeshHandle& Handle) const noexcept
+{
+  if (!m_Registry->IsValid(Handle))
+    return LoadState::FAILED;
+  return m_MeshDataArray[Handle.Index].State;
+}
+
+const Mesh::BoundingVolumes& MeshManager::GetBoundingVolumes(const MeshHandle& Handle) const noexcept
+{
+  static const Mesh::BoundingVolumes empty;
+  if (!m_Registry->IsValid(Handle) || m_MeshDataArray[Handle.Index].State != LoadState::LOADED)
+    return empty;
+  return m_MeshDataArray[Handle.Index].Bounds;
+}
+
+unsigned MeshManager::GetSubmeshCount(const MeshHandle& Handle) const noexcept
+{
+  if (!m_Registry->IsValid(Handle) || m_MeshDataArray[Handle.Index].State != LoadState::LOADED)
+    return 0u;
+  return m_MeshDataArray[Handle.Index].SubmeshCount;
+}
 
-    glDeleteBuffers(1, &i.PositionBufferId);
-    //glDeleteBuffers(1, &m_MeshDataArray[i].NormalBufferID);
-    //glDeleteBuffers(1, &m_MeshDataArray[i].TexcoordBufferID);
-    glDeleteBuffers(1, &i.TriangleBufferId);
+const Material* MeshManager::GetSubmeshMaterial(const MeshHandle& Handle, const unsigned Submesh) const noexcept
+{
+  if (!m_Registry->IsValid(Handle))
+    return nullptr;
+  const MeshData& meshData = m_MeshDataArray[Handle.Index];
+  if (Submesh >= meshData.MaterialFound.size() || !meshData.MaterialFound[Submesh])
+    return nullptr;
+  return &meshData.Materials[Submesh];
+}
+
+unsigned MeshManager::SelectLevelOfDetail(const MeshHandle& Handle, const mat4& Model, const vec3& Eye,
+  const float ProjectionScale) const noexcept
+{
+  if (!m_Registry->IsValid(Handle))
+    return 0u;
+  const MeshData& meshData = m_MeshDataArray[Handle.Index];
+  if (meshData.State != LoadState::LOADED || meshData.Lods.size() < 2u)
+    return 0u;
 
-    Log::Trace("Mesh '" + i.FileName + "' destroyed.");
+  // Bounding sphere in world space, scaled by the largest axis
+  const Mesh::BoundingSphere& sphere = meshData.Bounds.Sphere;
+  const vec3 center = vec3(Model * vec4(sphere.Center, 1.f));
+  const float scale = std::max({ glm::length(vec3(Model[0])), glm::length(vec3(Model[1])), glm::length(vec3(Model[2])) });
+  const float distance = glm::length(center - Eye);
+  if (distance <= sphere.Radius * scale)
+    return 0u;
+
+  // The errors are relative to half the box's diagonal, so scale them by its size on screen
+  const Mesh::BoundingBox& box = meshData.Bounds.Aabb;
+  const float boxRadius = 0.5f * glm::length(vec3(box.xMax - box.xMin, box.yMax - box.yMin, box.zMax - box.zMin));
+  const float radiusInPixels = boxRadius * scale * ProjectionScale / distance;
+  unsigned lod = 0u;
+  for (unsigned i = 1u; i < meshData.Lods.size(); ++i)
+  {
+    if (meshData.Lods[i].Error * radiusInPixels > LOD_PIXEL_ERROR)
+      break;
+    lod = i;
   }
-  m_MeshArray.clear();
-  m_MeshDataArray.clear();
+  return lod;
 }
 
-void MeshManager::RenderMesh(const unsigned Id) const noexcept
+void MeshManager::RenderMeshlets(const MeshHandle& Handle, const mat4& Model, const mat4& ViewProjection,
+  const vec3& Eye, const bool CullBackFacing, const SubmeshCallback& OnSubmesh) noexcept
 {
-  if (Id == Error::INVALID_INDEX)
+  if (!m_Registry->IsValid(Handle))
+  {
+    Log::Error("[RenderMeshlets] Mesh not loaded!");
+    return;
+  }
+
+  const MeshData& meshData = m_MeshDataArray[Handle.Index];
+  if (meshData.State != LoadState::LOADED || meshData.Meshlets.empty())
+  {
+    RenderMesh(Handle, 0u, OnSubmesh);
+    return;
+  }
+
+  // The frustum planes of the model view projection are already in object
+  // space, so the meshlet bounds are tested as stored
+  const mat4 modelViewProjection = ViewProjection * Model;
+  const vec4 row0(modelViewProjection[0][0], modelViewProjection[1][0], modelViewProjection[2][0], modelViewProjection[3][0]);
+  const vec4 row1(modelViewProjection[0][1], modelViewProjection[1][1], modelViewProjection[2][1], modelViewProjection[3][1]);
+  const vec4 row2(modelViewProjection[0][2], modelViewProjection[1][2], modelViewProjection[2][2], modelViewProjection[3][2]);
+  const vec4 row3(modelViewProjection[0][3], modelViewProjection[1][3], modelViewProjection[2][3], modelViewProjection[3][3]);
+  std::array<vec4, 6> planes = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2 };
+  for (vec4& plane : planes)
+  {
+    const float length = glm::length(vec3(plane));
+    if (length > 0.f)
+      plane /= length;
+  }
+
+  // The whole mesh first, its box is usually tighter than the meshlet spheres together
+  const Mesh::OrientedBox& box = meshData.Bounds.Obb;
+  const auto boxIsOutside = [&](const vec4& plane)
+  {
+    const vec3 normal(plane);
+    const float extent = box.HalfExtents.x * std::abs(dot(normal, box.Axes[0])) +
+      box.HalfExtents.y * std::abs(dot(normal, box.Axes[1])) + box.HalfExtents.z * std::abs(dot(normal, box.Axes[2]));
+    return dot(normal, box.Center) + plane.w < -extent;
+  };
+  if (std::any_of(planes.begin(), planes.end(), boxIsOutside))
+    return;
+
+  // Facing is kept by the model transform, so the cones are tested against the eye in object space
+  const vec3 eye = vec3(glm::inverse(Model) * vec4(Eye, 1.f));
+
+  // Neighbouring visible meshlets are consecutive in the index buffer, so they
+  // merge into one range. No meshlet crosses a submesh and they are in index
+  // buffer order, so each submesh's visible meshlets go out together.
+  const bool perSubmesh = OnSubmesh && meshData.SubmeshCount > 0u;
+  unsigned submesh = 0u;
+  const auto flush = [&]
+  {
+    if (m_DrawCounts.empty())
+      return;
+    if (perSubmesh)
+      OnSubmesh(submesh);
+    SubmitDraws(meshData);
+  };
+
+  m_DrawCounts.clear();
+  m_DrawOffsets.clear();
+  m_DrawBaseVertices.clear();
+  BindDrawState(meshData);
+  for (const Mesh::Meshlet& meshlet : meshData.Meshlets)
+  {
+    if (perSubmesh)
+    {
+      for (; submesh + 1u < meshData.SubmeshCount &&
+        meshlet.FirstTriangle >= meshData.Submeshes[submesh].FirstTriangle + meshData.Submeshes[submesh].TriangleCount; ++submesh)
+        flush();
+    }
+
+    const auto isOutside = [&](const vec4& plane) { return dot(vec3(plane), meshlet.Center) + plane.w < -meshlet.Radius; };
+    if (std::any_of(planes.begin(), planes.end(), isOutside))
+      continue;
+    if (CullBackFacing && MeshletBuilder::IsBackFacing(meshlet, eye))
+      continue;
+
+    AddDrawRange(meshData, meshlet.FirstTriangle, meshlet.TriangleCount);
+  }
+
+  flush();
+  glBindVertexArray(0u);
+}
+
+void MeshManager::GetPositionDequantization(const MeshHandle& Handle, vec3& Offset, vec3& Scale) const noexcept
+{
+  Offset = vec3(0.f);
+  Scale = vec3(1.f);
+  if (!m_Registry->IsValid(Handle))
+    return;
+
+  const MeshData& meshData = m_MeshDataArray[Handle.Index];
+  if (meshData.State == LoadState::LOADED && meshData.IsQuantized)
+  {
+    Offset = meshData.PositionOffset;
+    Scale = meshData.PositionScale;
+  }
+}
+
+void MeshManager::RenderMesh(const MeshHandle& Handle, const unsigned Lod, const SubmeshCallback& OnSubmesh) noexcept
+{
+  if (!m_Registry->IsValid(Handle))
   {
     Log::Error("[RenderMesh] Mesh not loaded!");
     return;
   }
 
-  glBindVertexArray(m_MeshDataArray[Id].VertexArrayId);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_MeshDataArray[Id].TriangleBufferId);
+  unsigned drawId = Handle.Index;
+  switch (m_MeshDataArray[drawId].State)
+  {
+  case LoadState::LOADED:
+    break;
+  case LoadState::FAILED:
+    return;
+  default:
+    // Still loading, stand in with the procedural sphere
+    if (!m_Registry->IsValid(m_Placeholder))
+    {
+      m_Placeholder = LoadMesh("sphere", true);
+      m_Registry->AddReference(m_Placeholder);
+    }
+    drawId = m_Placeholder.Index;
+    break;
+  }
 
-  glDrawElements(GL_TRIANGLES, 3u * m_MeshArray[Id].GetTriangleCount(), GL_UNSIGNED_INT, nullptr);
+  const MeshData& meshData = m_MeshDataArray[drawId];
+
+  // Every level of detail is a range of the one index buffer
+  unsigned firstTriangle = 0u;
+  unsigned triangleCount = meshData.TriangleCount;
+  const unsigned lod = meshData.Lods.empty() ? 0u : std::min<unsigned>(Lod, static_cast<unsigned>(meshData.Lods.size()) - 1u);
+  if (drawId == Handle.Index && !meshData.Lods.empty())
+  {
+    firstTriangle = meshData.Lods[lod].FirstTriangle;
+    triangleCount = meshData.Lods[lod].TriangleCount;
+  }
+
+  m_DrawCounts.clear();
+  m_DrawOffsets.clear();
+  m_DrawBaseVertices.clear();
+  BindDrawState(meshData);
+
+  // So are the submeshes of each level, only the material changes between their draws
+  const bool perSubmesh = OnSubmesh && drawId == Handle.Index && meshData.SubmeshCount > 0u &&
+    meshData.Submeshes.size() >= (lod + 1u) * meshData.SubmeshCount;
+  if (!perSubmesh)
+  {
+    AddDrawRange(meshData, firstTriangle, triangleCount);
+    SubmitDraws(meshData);
+  }
+  else
+  {
+    for (unsigned submesh = 0u; submesh < meshData.SubmeshCount; ++submesh)
+    {
+      const Mesh::Submesh& range = meshData.Submeshes[lod * meshData.SubmeshCount + submesh];
+      if (range.TriangleCount == 0u)
+        continue;
+      AddDrawRange(meshData, range.FirstTriangle, range.TriangleCount);
+      OnSubmesh(submesh);
+      SubmitDraws(meshData);
+    }
+  }
   glBindVertexArray(0u);
 }
 
-void MeshManager::RenderSurfaceNormals(const unsigned Id, const float Length) const noexcept
+void MeshManager::AddDrawRange(const MeshData& Data, const unsigned FirstTriangle, const unsigned TriangleCount) noexcept
 {
-  if (Id == Error::INVALID_INDEX)
+  const size_t indexSize = Data.IndexSize();
+  const auto add = [&](const unsigned first, const unsigned count, const GLint baseVertex)
+  {
+    const size_t offset = size_t(first) * 3u * indexSize;
+    if (!m_DrawCounts.empty() && m_DrawBaseVertices.back() == baseVertex &&
+      reinterpret_cast<size_t>(m_DrawOffsets.back()) + size_t(m_DrawCounts.back()) * indexSize == offset)
+    {
+      m_DrawCounts.back() += static_cast<GLsizei>(3u * count);
+      return;
+    }
+    m_DrawCounts.push_back(static_cast<GLsizei>(3u * count));
+    m_DrawOffsets.push_back(reinterpret_cast<const void*>(offset));
+    m_DrawBaseVertices.push_back(baseVertex);
+  };
+
+  // 32 bit indices are all relative to the first vertex
+  if (Data.IndexRanges.empty())
+  {
+    add(FirstTriangle, TriangleCount, 0);
+    return;
+  }
+
+  // Split where the triangles cross from one 16 bit range into the next
+  const unsigned end = FirstTriangle + TriangleCount;
+  for (size_t r = IndexBuffer::FindRange(Data.IndexRanges, FirstTriangle); r < Data.IndexRanges.size(); ++r)
+  {
+    const IndexBuffer::Range& range = Data.IndexRanges[r];
+    if (range.FirstTriangle >= end)
+      break;
+    const unsigned first = std::max(FirstTriangle, range.FirstTriangle);
+    const unsigned last = std::min(end, range.FirstTriangle + range.TriangleCount);
+    add(first, last - first, range.BaseVertex);
+  }
+}
+
+void MeshManager::BindDrawState(const MeshData& Data) noexcept
+{
+  glBindVertexArray(Data.VertexArrayId);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Data.TriangleBufferId);
+  if (Data.TangentBufferId != Error::INVALID_INDEX)
+    m_BindTangents ? glEnableVertexAttribArray(3) : glDisableVertexAttribArray(3);
+}
+
+void MeshManager::SubmitDraws(const MeshData& Data) noexcept
+{
+  if (m_DrawCounts.empty())
+    return;
+
+  // The vertex array is already bound, so consecutive submits only change the ranges
+  if (m_DrawCounts.size() == 1u)
+  {
+    glDrawElementsBaseVertex(GL_TRIANGLES, m_DrawCounts[0], Data.IndexType,
+      const_cast<void*>(m_DrawOffsets[0]), m_DrawBaseVertices[0]);
+  }
+  else
+  {
+    // GLEW declares the arrays without const, GL only reads them
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_DrawCounts.data(), Data.IndexType,
+      const_cast<void**>(m_DrawOffsets.data()), static_cast<GLsizei>(m_DrawCounts.size()), m_DrawBaseVertices.data());
+  }
+  m_DrawCounts.clear();
+  m_DrawOffsets.clear();
+  m_DrawBaseVertices.clear();
+}
+
+void MeshManager::RenderSurfaceNormals(const MeshHandle& Handle, const float Length) noexcept
+{
+  if (!m_Registry->IsValid(Handle))
   {
     Log::Error("[RenderSurfaceNormals] Mesh not loaded!");
     return;
   }
 
-  for (size_t i = 0; i < m_MeshArray[Id].m_SurfaceNormalArray.size(); ++i)
+  m_MeshDataArray[Handle.Index].ArraysWanted = true;
+  if (!RequireArrays(Handle.Index, Residency::FULL))
+    return;
+
+  const Mesh& mesh = m_MeshArray[Handle.Index];
+  for (size_t i = 0; i < mesh.m_SurfaceNormalArray.size(); ++i)
   {
     DebugRenderer::I().AddLine(
-      m_MeshArray[Id].m_SurfaceNormalPositionArray[i],
-      m_MeshArray[Id].m_SurfaceNormalPositionArray[i] + m_MeshArray[Id].m_SurfaceNormalArray[i] * Length);
+      mesh.m_SurfaceNormalPositionArray[i],
+      mesh.m_SurfaceNormalPositionArray[i] + mesh.m_SurfaceNormalArray[i] * Length);
   }
 
   DebugRenderer::I().RenderLines();
 }
 
-void MeshManager::RenderVertexNormals(const unsigned Id, const float Length) const noexcept
+void MeshManager::RenderVertexNormals(const MeshHandle& Handle, const float Length) noexcept
 {
-  if (Id == Error::INVALID_INDEX)
+  if (!m_Registry->IsValid(Handle))
   {
     Log::Error("[RenderVertexNormals] Mesh not loaded!");
     return;
   }
 
-  for (size_t i = 0; i < m_MeshArray[Id].m_VertexNormalArray.size(); ++i)
+  m_MeshDataArray[Handle.Index].ArraysWanted = true;
+  if (!RequireArrays(Handle.Index, Residency::FULL))
+    return;
+
+  const Mesh& mesh = m_MeshArray[Handle.Index];
+  for (size_t i = 0; i < mesh.m_VertexNormalArray.size(); ++i)
   {
     DebugRenderer::I().AddLine(
-      m_MeshArray[Id].m_PositionArray[i],
-      m_MeshArray[Id].m_PositionArray[i] + m_MeshArray[Id].m_VertexNormalArray[i] * Length);
+      mesh.m_PositionArray[i],
+      mesh.m_PositionArray[i] + mesh.m_VertexNormalArray[i] * Length);
   }
 
   DebugRenderer::I().RenderLines();
 }
 
-unsigned MeshManager::LoadMeshFromOBJ(const string& FileName) noexcept
+bool MeshManager::LoadMeshFromOBJ(const string& FileName, Mesh& Result) noexcept
 {
-  const auto i = static_cast<unsigned>(m_MeshArray.size());
-  m_MeshArray.emplace_back();
-  m_MeshDataArray.emplace_back();
-  m_MeshDataArray[i].FileName = FileName;
-
-  auto result = m_ObjReader.ReadOBJFile(FileName, &m_MeshArray[i], OBJReader::ReadMethod::LINE_BY_LINE, false);
-  return i;
-}
+  // Files this large are streamed so the raw records never all sit in memory
+  constexpr uintmax_t StreamingThreshold = 1024u * 1024u * 1024u;
+  std::error_code error;
+  const uintmax_t fileSize = std::filesystem::file_size(Paths::MODEL_PATH + FileName, error);
+  if (error)
+    return false;
+  const OBJReader::ReadMethod method = (fileSize >= StreamingThreshold) ?
+    OBJReader::ReadMethod::STREAMING : OBJReader::ReadMethod::PARALLEL;
 
-const Mesh& MeshManager::GetMeshByID(unsigned Id) const noexcept
-{
-  return m_MeshArray[Id];
+  // The reader keeps per-file state, so each load gets its own
+  OBJReader reader;
+  // Counted per thread, other loads and the render thread allocate meanwhile
+  const size_t allocationsBefore = MemoryStats::GetThreadAllocationCount();
+  const double readTime = reader.ReadOBJFile(FileName, &Result, method, false);
+  const size_t allocations = MemoryStats::GetThreadAllocationCount() - allocationsBefore;
+  const size_t peakMB = MemoryStats::GetPeakResidentBytes() / (1024u * 1024u);
+  Log::Trace("OBJ file: " + FileName + " read in " + std::to_string(readTime) + "ms, "
+    + std::to_string(allocations) + " allocations, peak RSS " + std::to_string(peakMB) + "MB.");
+  return Result.GetTriangleCount() > 0u;
 }
 
-unsigned MeshManager::LoadSphere(const float Radius, const int NumDivisions) noexcept
+void MeshManager::BuildSphere(Mesh& Result, const float Radius, const int NumDivisions) noexcept
 {
-  const auto index = static_cast<unsigned>(m_MeshArray.size());
-  m_MeshArray.emplace_back();
-  m_MeshDataArray.emplace_back();
-  m_MeshDataArray[index].FileName = "Procedural Sphere";
-
   const unsigned slices = NumDivisions;
   const unsigned stacks = 2 * NumDivisions;
   const unsigned topVertex = (stacks * (slices - 1));
   const unsigned bottomVertex = (stacks * (slices - 1) + 1);
 
-  // Reference for legibility
-  Mesh& mesh = m_MeshArray[index];
-
-  mesh.m_PositionArray.resize(static_cast<size_t>(stacks * (slices - 1) + 2));
-  mesh.m_VertexNormalArray.resize(static_cast<size_t>(stacks * (slices - 1) + 2));
+  Result.m_PositionArray.resize(static_cast<size_t>(stacks * (slices - 1) + 2));
+  Result.m_VertexNormalArray.resize(static_cast<size_t>(stacks * (slices - 1) + 2));
 
   for (unsigned i = 1; i < slices; ++i)
   {
@@ -232,16 +1073,16 @@ unsigned MeshManager::LoadSphere(const float Radius, const int NumDivisions) noe
       const unsigned y = stacks * (i - 1) + j;
       const float phi = 2 * glm::pi<float>() * j / stacks;
       const vec3 normal(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta));
-      mesh.m_VertexNormalArray[y] = normal;
+      Result.m_VertexNormalArray[y] = normal;
     }
   }
 
-  mesh.m_VertexNormalArray[topVertex] = vec3(0.0f, 0.0f, 1.0f);
-  mesh.m_VertexNormalArray[bottomVertex] = vec3(0.0f, 0.0f, -1.0f);
+  Result.m_VertexNormalArray[topVertex] = vec3(0.0f, 0.0f, 1.0f);
+  Result.m_VertexNormalArray[bottomVertex] = vec3(0.0f, 0.0f, -1.0f);
 
-  for (unsigned n = 0; n < mesh.m_VertexNormalArray.size(); ++n)
+  for (unsigned n = 0; n < Result.m_VertexNormalArray.size(); ++n)
   {
-    mesh.m_PositionArray[n] = Radius * mesh.m_VertexNormalArray[n];
+    Result.m_PositionArray[n] = Radius * Result.m_VertexNormalArray[n];
   }
 
   for (unsigned i = 2; i < slices; ++i)
@@ -253,10 +1094,10 @@ unsigned MeshManager::LoadSphere(const float Radius, const int NumDivisions) noe
       triangle.Index1 = stacks * (i - 2) + j;
       triangle.Index2 = stacks * (i - 1) + nextIndex;
       triangle.Index3 = stacks * (i - 2) + nextIndex;
-      mesh.m_TriangleArray.push_back(triangle);
+      Result.m_TriangleArray.push_back(triangle);
       triangle.Index2 = stacks * (i - 1) + j;
       triangle.Index3 = stacks * (i - 1) + nextIndex;
-      mesh.m_TriangleArray.push_back(triangle);
+      Result.m_TriangleArray.push_back(triangle);
     }
   }
 
@@ -267,12 +1108,10 @@ unsigned MeshManager::LoadSphere(const float Radius, const int NumDivisions) noe
     triangle.Index1 = j;
     triangle.Index2 = nextIndex;
     triangle.Index3 = topVertex;
-    mesh.m_TriangleArray.push_back(triangle);
+    Result.m_TriangleArray.push_back(triangle);
     triangle.Index1 = stacks * (slices - 2) + j;
     triangle.Index2 = bottomVertex;
     triangle.Index3 = stacks * (slices - 2) + nextIndex;
-    mesh.m_TriangleArray.push_back(triangle);
+    Result.m_TriangleArray.push_back(triangle);
   }
-
-  return index;
 }
\ No newline at end of file
@@ -8,9 +8,51 @@
 #include "Mesh.h"
 #include "GLEW/glew.h"
 #include "OBJReader.h"
+#include "MeshCache.h"
+#include "MeshRegistry.h"
+#include "IndexBuffer.h"
+#include "Material.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
 
 class MeshManager
 {
+public:
+  /// <summary>
+  /// Where a mesh is in its asynchronous load
+  /// </summary>
+  enum class LoadState
+  {
+    QUEUED,     // Waiting for or being processed by a worker thread
+    UPLOADING,  // Processed, being uploaded to the GPU over one or more frames
+    LOADED,     // Ready to render
+    FAILED      // Could not be loaded, nothing is drawn
+  };
+
+  /// <summary>
+  /// What a mesh keeps in RAM once it is on the GPU, from least to most
+  /// </summary>
+  enum class Residency
+  {
+    BOUNDS,     // Bounds, levels of detail and meshlets only
+    COLLISION,  // Also the positions and full detail triangles, for picking and physics
+    FULL        // Every array the import produced
+  };
+
+  // Bytes uploaded to the GPU per frame unless changed with SetUploadBudget
+  static constexpr size_t DEFAULT_UPLOAD_BUDGET = 8u * 1024u * 1024u;
+
+  // Screen space error, in pixels, a level of detail may add before a finer one is drawn
+  static constexpr float LOD_PIXEL_ERROR = 1.f;
+
+  // Called before the triangles of a submesh are drawn, to set up its material
+  using SubmeshCallback = std::function<void(unsigned Submesh)>;
+
 private:
   struct MeshData
   {
@@ -25,7 +67,29 @@ private:
       TriangleBufferId(TriangleBufferId),
       NormalBufferId(NormalBufferId),
       TexcoordBufferId(TexcoordBufferId),
-      VertexArrayId(VertexArrayId)
+      TangentBufferId(Error::INVALID_INDEX),
+      VertexArrayId(VertexArrayId),
+      VertexCount(0u),
+      TriangleCount(0u),
+      IndexType(GL_UNSIGNED_INT),
+      IndexRanges(),
+      Lods(),
+      Meshlets(),
+      Submeshes(),
+      SubmeshCount(0u),
+      Materials(),
+      MaterialFound(),
+      Bounds(),
+      IsQuantized(false),
+      PositionOffset(0.f),
+      PositionScale(1.f),
+      State(LoadState::QUEUED),
+      Options(),
+      Policy(Residency::FULL),
+      Held(Residency::BOUNDS),
+      ReloadQueued(false),
+      ReloadFailed(false),
+      ArraysWanted(false)
     {}
 
     string FileName;
@@ -33,7 +97,59 @@ private:
     GLuint TriangleBufferId;
     GLuint NormalBufferId;
     GLuint TexcoordBufferId;
+    GLuint TangentBufferId;  // Packed tangents, a stream beside the vertex buffer, if generated
     GLuint VertexArrayId;
+    unsigned VertexCount;   // Vertices uploaded to the GPU
+    unsigned TriangleCount; // Triangles uploaded to the GPU
+    GLenum IndexType;       // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    vector<IndexBuffer::Range> IndexRanges; // Base vertex of each run of 16 bit indices
+    vector<Mesh::LevelOfDetail> Lods; // Index buffer ranges, full detail first
+    vector<Mesh::Meshlet> Meshlets;   // Clusters of the full detail triangles, for culling
+    vector<Mesh::Submesh> Submeshes;  // Index buffer range of each material, SubmeshCount per level of detail
+    unsigned SubmeshCount;            // Materials the mesh is split by, 0 if it isn't
+    vector<Material> Materials;       // Material of each submesh from the library
+    vector<bool> MaterialFound;       // The library defines the submesh's material
+    Mesh::BoundingVolumes Bounds; // Fitted on import, for culling, picking the level of detail and picking
+    bool IsQuantized;       // The vertex buffer holds Mesh::PackedVertexData
+    vec3 PositionOffset;    // Dequantization the vertex shader applies to the positions
+    vec3 PositionScale;
+    LoadState State;
+    MeshCache::Options Options; // Import options, to reload the arrays with
+    Residency Policy;       // What the mesh keeps in RAM when nothing needs more
+    Residency Held;         // What the mesh has in RAM right now
+    bool ReloadQueued;      // The arrays are being read back from the source file
+    bool ReloadFailed;      // The source file could not be read again, don't retry
+    bool ArraysWanted;      // Something drew from the arrays since the last trim
+
+    inline size_t IndexSize() const noexcept { return IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned); }
+  };
+
+  // A mesh being read and processed off the render thread, then uploaded
+  struct LoadJob
+  {
+    unsigned Id;                  // Slot in the mesh arrays that receives the result
+    unsigned Generation;          // Generation of the slot when the load was queued
+    string FileName;
+    MeshCache::Options Options;
+
+    Mesh Result;                  // Processed mesh, when not loaded from the cache
+    MeshCache Cache;              // Mapped cache file, when loaded from it
+    IndexBuffer::ShortIndices ShortIndices; // The index buffer at 16 bits, empty when it stays 32
+    std::map<string, Material> Materials;   // The mesh's material library, read with the mesh
+    bool IsCached = false;
+    bool IsQuantized = false;     // The vertex bytes are Mesh::PackedVertexData
+    bool IsReload = false;        // Only refills the arrays of a loaded mesh, nothing is uploaded
+    bool Succeeded = false;
+
+    const char* VertexBytes = nullptr;    // Source of the vertex buffer
+    const char* TangentBytes = nullptr;   // Source of the tangent buffer, if generated
+    const char* TriangleBytes = nullptr;  // Source of the index buffer
+    const char* LodTriangleBytes = nullptr; // Source of the rest of the index buffer, the levels of detail
+    size_t VertexSize = 0u;
+    size_t TangentSize = 0u;
+    size_t TriangleSize = 0u;
+    size_t LodTriangleSize = 0u;
+    size_t UploadedSize = 0u;             // Bytes of all buffers sent so far
   };
 
 public:
@@ -44,27 +160,248 @@ public:
   MeshManager(MeshManager&&) = delete;
   MeshManager& operator=(MeshManager&&) = delete;
 
-  unsigned LoadMesh(
+  /// <summary>
+  /// Finds the mesh with these import options, or queues it to be read and
+  /// processed on a worker thread. The returned handle is valid immediately
+  /// and renders a placeholder until the mesh is ready. A mesh nobody holds a
+  /// reference to is freed by the next ReleaseUnusedMeshes.
+  /// </summary>
+  /// <param name="FileName">File name of the mesh in the models folder, or "sphere"</param>
+  /// <param name="ScaleToUnitSize">[T/F] Scale the mesh to fit a unit cube</param>
+  /// <param name="ResetOrigin">[T/F] Move the origin to the centroid</param>
+  /// <param name="UvGeneration">Projection used when the file has no UVs</param>
+  /// <param name="OptimizeVertexCache">[T/F] Reorder triangles and vertices for the vertex cache and fetch</param>
+  /// <param name="GenerateLods">[T/F] Simplify coarser levels of detail into the same buffers</param>
+  /// <param name="QuantizeVertices">[T/F] Upload the packed vertex format, half the size</param>
+  /// <param name="BuildMeshlets">[T/F] Cluster the triangles so RenderMeshlets can cull them</param>
+  /// <param name="WeldVertices">[T/F] Weld close vertices and drop degenerate and duplicate triangles</param>
+  /// <param name="GenerateTangents">[T/F] Build the tangent stream for normal mapping</param>
+  /// <returns>Handle to the mesh</returns>
+  MeshHandle LoadMesh(
     const string& FileName,
     bool ScaleToUnitSize = false,
     bool ResetOrigin = false,
-    UV::Generation UvGeneration = UV::Generation::PLANAR) noexcept;
+    UV::Generation UvGeneration = UV::Generation::PLANAR,
+    bool OptimizeVertexCache = false,
+    bool GenerateLods = false,
+    bool QuantizeVertices = false,
+    bool BuildMeshlets = false,
+    bool WeldVertices = false,
+    bool GenerateTangents = false) noexcept;
 
+  /// <summary>
+  /// Frees every mesh, invalidating all handles
+  /// </summary>
   void UnloadMeshes() noexcept;
 
-  void RenderMesh(unsigned Id) const noexcept;
+  /// <summary>
+  /// Frees the GPU buffers and CPU arrays of every mesh without references,
+  /// and drops arrays reloaded for something that no longer draws from them
+  /// back to the mesh's residency
+  /// </summary>
+  void ReleaseUnusedMeshes() noexcept;
+
+  /// <summary>
+  /// Sets the residency of meshes loaded from now on
+  /// </summary>
+  /// <param name="Policy">What new meshes keep in RAM after their upload</param>
+  inline void SetDefaultResidency(Residency Policy) noexcept { m_DefaultResidency = Policy; }
+
+  /// <summary>
+  /// Sets what a mesh keeps in RAM. Arrays it no longer needs are freed right
+  /// away, arrays it needs and has dropped are reloaded from the source file
+  /// on a worker thread.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Policy">What the mesh keeps in RAM</param>
+  void SetResidency(const MeshHandle& Handle, Residency Policy) noexcept;
 
-  void RenderSurfaceNormals(unsigned Id, float Length) const noexcept;
+  /// <summary>
+  /// Gets what a mesh has in RAM right now, which is more than its residency
+  /// while reloaded arrays are in use. Meshes loaded from the cache hold at
+  /// most the collision copy until their arrays are reloaded.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <returns>The arrays held, BOUNDS for a stale handle</returns>
+  Residency GetResidency(const MeshHandle& Handle) const noexcept;
 
-  void RenderVertexNormals(unsigned Id, float Length) const noexcept;
+  /// <summary>
+  /// Gets the registry that holds the reference counts, for the owners of handles
+  /// </summary>
+  /// <returns>The mesh registry</returns>
+  inline const shared_ptr<MeshRegistry>& GetRegistry() const noexcept { return m_Registry; }
 
-  const Mesh& GetMeshByID(unsigned Id) const noexcept;
+  /// <summary>
+  /// Checks that a handle refers to a mesh that hasn't been freed
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <returns>[T/F] The handle is valid</returns>
+  inline bool IsValid(const MeshHandle& Handle) const noexcept { return m_Registry->IsValid(Handle); }
+
+  /// <summary>
+  /// Uploads finished meshes to the GPU, at most the upload budget in bytes.
+  /// Call once per frame on the render thread.
+  /// </summary>
+  void ProcessUploads() noexcept;
+
+  /// <summary>
+  /// Sets whether the draws that follow feed the tangent stream to the vertex
+  /// shader, at attribute 3. Only contexts whose shaders read tangents need it.
+  /// </summary>
+  /// <param name="Bind">[T/F] Enable the tangent attribute for meshes that have one</param>
+  inline void SetBindTangents(bool Bind) noexcept { m_BindTangents = Bind; }
+
+  /// <summary>
+  /// Sets how many bytes of mesh data may be uploaded to the GPU each frame
+  /// </summary>
+  /// <param name="BytesPerFrame">Upload budget, larger meshes are spread over several frames</param>
+  inline void SetUploadBudget(size_t BytesPerFrame) noexcept { m_UploadBudget = std::max<size_t>(1u, BytesPerFrame); }
+
+  /// <summary>
+  /// Gets the load state of a mesh
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <returns>Where the mesh is in its load, FAILED for a stale handle</returns>
+  LoadState GetLoadState(const MeshHandle& Handle) const noexcept;
+
+  /// <summary>
+  /// Gets the bounding box, sphere and oriented box fitted when the mesh was
+  /// imported. They stay when the arrays are released, so culling and picking
+  /// can test them without the vertices.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <returns>[Const Ref] The volumes in object space, empty for a stale handle or a mesh still loading</returns>
+  const Mesh::BoundingVolumes& GetBoundingVolumes(const MeshHandle& Handle) const noexcept;
+
+  /// <summary>
+  /// Picks the coarsest level of detail whose simplification error stays under
+  /// LOD_PIXEL_ERROR on screen, from the mesh's bounding sphere
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Model">[Const Ref] Model to world transform of the instance</param>
+  /// <param name="Eye">[Const Ref] Camera position in world space</param>
+  /// <param name="ProjectionScale">Viewport height over 2 tan(FOV / 2), pixels per unit at distance 1</param>
+  /// <returns>Level of detail to pass to RenderMesh, 0 is full detail</returns>
+  unsigned SelectLevelOfDetail(const MeshHandle& Handle, const mat4& Model, const vec3& Eye,
+    float ProjectionScale) const noexcept;
+
+  /// <summary>
+  /// Renders the full detail mesh, skipping it whole if its oriented box is
+  /// outside the view frustum, else the meshlets outside it and, if back faces are culled, those facing away from the eye.
+  /// The visible ranges go out in one multi-draw. Meshes without meshlets
+  /// render whole, as RenderMesh.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Model">[Const Ref] Model to world transform of the instance</param>
+  /// <param name="ViewProjection">[Const Ref] The camera's view projection matrix</param>
+  /// <param name="Eye">[Const Ref] Camera position in world space</param>
+  /// <param name="CullBackFacing">[T/F] Skip meshlets whose triangles all face away</param>
+  /// <param name="OnSubmesh">[Optional] Called before each submesh with visible meshlets, see RenderMesh</param>
+  void RenderMeshlets(const MeshHandle& Handle, const mat4& Model, const mat4& ViewProjection,
+    const vec3& Eye, bool CullBackFacing, const SubmeshCallback& OnSubmesh = nullptr) noexcept;
+
+  /// <summary>
+  /// Gets how many materials the mesh is split by
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <returns>The submeshes per level of detail, 0 if the mesh has a single material or is still loading</returns>
+  unsigned GetSubmeshCount(const MeshHandle& Handle) const noexcept;
+
+  /// <summary>
+  /// Gets the material the mesh's material library gives a submesh
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Submesh">Index of the submesh</param>
+  /// <returns>The material, nullptr if the library doesn't define it</returns>
+  const Material* GetSubmeshMaterial(const MeshHandle& Handle, unsigned Submesh) const noexcept;
+
+  /// <summary>
+  /// Gets what the vertex shader must apply to the positions of the mesh:
+  /// position = Offset + position * Scale. Float meshes, and meshes still
+  /// drawn as the placeholder, get the identity.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Offset">[Out] Receives the position offset</param>
+  /// <param name="Scale">[Out] Receives the position scale</param>
+  void GetPositionDequantization(const MeshHandle& Handle, vec3& Offset, vec3& Scale) const noexcept;
+
+  /// <summary>
+  /// Renders the mesh, or the placeholder while it is still loading. With a
+  /// callback, a mesh split into submeshes is drawn one submesh at a time and
+  /// the callback runs before each, with the buffers bound once for all of them.
+  /// Without one, or for a single material mesh, it is drawn whole.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Lod">Level of detail to draw, clamped to the ones the mesh has</param>
+  /// <param name="OnSubmesh">[Optional] Called with the index of each submesh before it is drawn</param>
+  void RenderMesh(const MeshHandle& Handle, unsigned Lod = 0u, const SubmeshCallback& OnSubmesh = nullptr) noexcept;
+
+  /// <summary>
+  /// Draws the triangle normals as debug lines. Dropped arrays are reloaded
+  /// first, nothing is drawn until they are back.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Length">Length of the lines in object space</param>
+  void RenderSurfaceNormals(const MeshHandle& Handle, float Length) noexcept;
+
+  /// <summary>
+  /// Draws the vertex normals as debug lines. Dropped arrays are reloaded
+  /// first, nothing is drawn until they are back.
+  /// </summary>
+  /// <param name="Handle">Handle of the mesh</param>
+  /// <param name="Length">Length of the lines in object space</param>
+  void RenderVertexNormals(const MeshHandle& Handle, float Length) noexcept;
 
 private:
+  // Threads that read and process queued meshes
+  static constexpr unsigned WORKER_COUNT = 2u;
+
+  shared_ptr<MeshRegistry> m_Registry; // Handles and reference counts, indexes the arrays below
   vector<Mesh> m_MeshArray;
   vector<MeshData> m_MeshDataArray;
-  OBJReader m_ObjReader;
+  MeshHandle m_Placeholder;     // Drawn in place of meshes that aren't loaded yet
+  Residency m_DefaultResidency; // Residency given to newly loaded meshes
+
+  // Shared with the workers, guarded by m_JobMutex
+  std::mutex m_JobMutex;
+  std::condition_variable m_JobSignal;
+  std::deque<unique_ptr<LoadJob>> m_QueuedJobs;
+  std::deque<unique_ptr<LoadJob>> m_CompletedJobs;
+  bool m_StopWorkers;
+  vector<std::thread> m_Workers;
+
+  // Render thread only
+  unique_ptr<LoadJob> m_CurrentUpload;
+  size_t m_UploadBudget;
+  bool m_BindTangents;                // The current context reads the tangent stream
+  vector<GLsizei> m_DrawCounts;       // Index counts of the ranges the next draw submits, reused per call
+  vector<const void*> m_DrawOffsets;  // Byte offsets of the same ranges
+  vector<GLint> m_DrawBaseVertices;   // Base vertices of the same ranges
+
+  void WorkerLoop() noexcept;
+  static void ProcessJob(LoadJob& Job) noexcept;
+  static void PackIndices(LoadJob& Job, size_t VertexCount) noexcept;
+  static bool LoadMeshFromOBJ(const string& FileName, Mesh& Result) noexcept;
+  static void BuildSphere(Mesh& Result, float Radius = 1.f, int NumDivisions = 16) noexcept;
+  void FreeMesh(unsigned Id) noexcept;
+
+  size_t UploadJobRange(LoadJob& Job, size_t Budget) noexcept;
+  void FinishUpload(LoadJob& Job) noexcept;
+  void FinishReload(LoadJob& Job) noexcept;
+  bool RequireArrays(unsigned Id, Residency Needed) noexcept;
+  void ApplyResidency(unsigned Id) noexcept;
+  static void CopyCollisionData(const MeshCache& Cache, Mesh& Result) noexcept;
+  void SetDrawData(unsigned Id, const Mesh& Source) noexcept;
+  void SetDrawData(unsigned Id, const MeshCache& Cache) noexcept;
+  void SetBounds(unsigned Id, const Mesh::BoundingVolumes& Bounds) noexcept;
+  void SetMaterials(unsigned Id, const vector<string>& Names, const std::map<string, Material>& Library) noexcept;
+  static void ReadMaterialLibrary(LoadJob& Job, const string& Library) noexcept;
+
+  void CreateMeshBuffers(unsigned Id, const void* Vertices, size_t VertexSize,
+    const void* Triangles, size_t TriangleSize, const void* Tangents = nullptr, size_t TangentSize = 0u) noexcept;
+  void CreateVertexArray(unsigned Id) noexcept;
 
-  unsigned LoadMeshFromOBJ(const string& FileName) noexcept;
-  unsigned LoadSphere(float Radius = 1.f, int NumDivisions = 16) noexcept;
+  void AddDrawRange(const MeshData& Data, unsigned FirstTriangle, unsigned TriangleCount) noexcept;
+  void BindDrawState(const MeshData& Data) noexcept;
+  void SubmitDraws(const MeshData& Data) noexcept;
 };
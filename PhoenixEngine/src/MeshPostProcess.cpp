@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+// File:    MeshPostProcess.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    CPU processing that turns a freshly read mesh into GPU ready data
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MeshPostProcess.h"
+#include "MeshWelder.h"
+#include "VertexCacheOptimizer.h"
+
+#include <chrono>
+
+namespace
+{
+  // Runs a phase, adding its duration to the given counter if timings were requested
+  template<typename Phase>
+  void timePhase(MeshPostProcess::PhaseTimings* timings, double MeshPostProcess::PhaseTimings::* counter, Phase&& phase)
+  {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    phase();
+    if (timings)
+    {
+      timings->*counter += std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+  }
+}
+
+MeshPostProcess::Pipeline MeshPostProcess::Pipeline::FromOptions(const Mesh& mesh, const MeshCache::Options& options) noexcept
+{
+  Pipeline pipeline;
+  pipeline.ScaleToUnitSize = options.ScaleToUnitSize;
+  pipeline.ResetOrigin = options.ResetOrigin;
+  pipeline.WeldVertices = options.WeldVertices;
+  pipeline.OptimizeVertexCache = options.OptimizeVertexCache;
+  pipeline.BuildMeshlets = options.BuildMeshlets;
+  pipeline.QuantizeVertices = options.QuantizeVertices;
+  pipeline.CalculateTangents = options.GenerateTangents;
+  if (options.GenerateLods)
+    pipeline.LodRatios.assign(DEFAULT_LOD_RATIOS.begin(), DEFAULT_LOD_RATIOS.end());
+  // If the normals weren't imported, calculate them
+  pipeline.CalculateNormals = !mesh.NormalsAreCalculated();
+  // Generate the UVs, unless the file provided its own
+  pipeline.Texcoords = mesh.TexcoordsAreImported() ? UV::Generation::CUSTOM : options.UvGeneration;
+  return pipeline;
+}
+
+void MeshPostProcess::Pipeline::Run(Mesh& mesh, PhaseTimings* timings) const noexcept
+{
+  // Weld before anything counts or orders the vertices
+  if (WeldVertices)
+  {
+    const unsigned vertexCount = mesh.GetVertexCount();
+    Mesh::WeldReport report{};
+    timePhase(timings, &PhaseTimings::WeldMs, [&] { report = mesh.WeldVertices(MeshWelder::DEFAULT_EPSILON); });
+
+    stringstream message;
+    message.precision(3);
+    message << "Welded " << report.VerticesRemoved << " of " << vertexCount << " vertices ("
+      << (vertexCount > 0u ? 100.f * static_cast<float>(report.VerticesRemoved) / static_cast<float>(vertexCount) : 0.f)
+      << "%), removed " << report.DegenerateTrianglesRemoved << " degenerate and "
+      << report.DuplicateTrianglesRemoved << " duplicate triangles";
+    Log::Trace(message.str());
+  }
+
+  // Reorder next, so every array built after it is already in the new order
+  Mesh::VertexCacheReport cacheReport{};
+  if (OptimizeVertexCache)
+    timePhase(timings, &PhaseTimings::OptimizeMs, [&] { cacheReport = mesh.OptimizeVertexCache(); });
+
+  // Find the bounds once, they stay cached on the mesh for the UV projection
+  float scale = 1.f;
+  vec3 translation(0.f);
+  timePhase(timings, &PhaseTimings::BoundsMs, [&]
+    {
+      scale = mesh.prepareTransform(ScaleToUnitSize, ResetOrigin, translation);
+      if (Texcoords != UV::Generation::CUSTOM)
+        mesh.GetBoundingBox();
+    });
+
+  // A uniform scale and a move change neither the direction of the normals nor
+  // how they are weighed, so they are found first and the transform is left to
+  // the final sweep
+  if (CalculateNormals)
+    timePhase(timings, &PhaseTimings::NormalsMs, [&] { mesh.CalculateNormals(); });
+
+  // Transform, project the UVs and assemble the vertex data for the GPU in one sweep
+  timePhase(timings, &PhaseTimings::AssembleMs, [&] { mesh.transformAndAssemble(scale, translation, Texcoords); });
+
+  // Around the final positions, so culling and picking never need the vertices
+  timePhase(timings, &PhaseTimings::VolumesMs, [&] { mesh.CalculateBoundingVolumes(); });
+
+  // From the final normals and UVs. The transform is uniform, so nothing moves them after.
+  if (CalculateTangents)
+    timePhase(timings, &PhaseTimings::TangentMs, [&] { mesh.CalculateTangents(); });
+
+  // Clustered around the final positions. The triangles within each meshlet
+  // are ordered for the cache again, since clustering regroups them.
+  if (BuildMeshlets)
+  {
+    timePhase(timings, &PhaseTimings::MeshletMs, [&] { mesh.BuildMeshlets(OptimizeVertexCache); });
+    Log::Trace("Meshlets: " + std::to_string(mesh.GetMeshlets().size()));
+  }
+
+  // Measured on the order that is drawn, after the meshlets moved it
+  if (OptimizeVertexCache)
+  {
+    if (BuildMeshlets)
+      cacheReport.AcmrAfter = VertexCacheOptimizer::CalculateACMR(mesh.m_TriangleArray, mesh.m_PositionArray.size());
+
+    stringstream message;
+    message.precision(3);
+    message << "Vertex cache optimized, ACMR " << cacheReport.AcmrBefore << " -> " << cacheReport.AcmrAfter;
+    Log::Trace(message.str());
+  }
+
+  // Packed across the final bounds
+  if (QuantizeVertices)
+  {
+    Mesh::QuantizationReport report{};
+    timePhase(timings, &PhaseTimings::QuantizeMs, [&] { report = mesh.QuantizeVertexData(); });
+
+    stringstream message;
+    message.precision(3);
+    message << "Vertex data quantized, max error: position " << report.MaxPositionError
+      << ", normal " << report.MaxNormalError << " deg, UV " << report.MaxTexcoordError;
+    Log::Trace(message.str());
+  }
+
+  // The levels only add triangles over the same vertices, so they come last
+  if (!LodRatios.empty())
+  {
+    timePhase(timings, &PhaseTimings::LodMs, [&] { mesh.GenerateLevelsOfDetail(LodRatios, OptimizeVertexCache); });
+
+    stringstream message;
+    message.precision(3);
+    message << "Levels of detail:";
+    for (const Mesh::LevelOfDetail& lod : mesh.GetLevelsOfDetail())
+      message << ' ' << lod.TriangleCount << " (" << lod.Error << ')';
+    Log::Trace(message.str());
+  }
+}
+
+void MeshPostProcess::Apply(Mesh& Result, const MeshCache::Options& Options, PhaseTimings* Timings) noexcept
+{
+  Pipeline::FromOptions(Result, Options).Run(Result, Timings);
+}
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+// File:    MeshPostProcess.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    CPU processing that turns a freshly read mesh into GPU ready data
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+#include "MeshCache.h"
+
+namespace MeshPostProcess
+{
+  // Triangle counts of the levels of detail built on import, relative to full detail
+  constexpr std::array<float, 3> DEFAULT_LOD_RATIOS = { 0.5f, 0.25f, 0.125f };
+
+  /// <summary>
+  /// Time spent in each phase, in milliseconds. Skipped phases stay at 0.
+  /// </summary>
+  struct PhaseTimings
+  {
+    double WeldMs = 0.0;      // Welding vertices and dropping degenerate triangles
+    double OptimizeMs = 0.0;  // Vertex cache and fetch reordering
+    double BoundsMs = 0.0;    // Finding the bounds the transform and UVs are based on
+    double NormalsMs = 0.0;
+    double AssembleMs = 0.0;  // Transform, UV projection and vertex data, done together
+    double VolumesMs = 0.0;   // Fitting the bounding sphere and oriented box
+    double TangentMs = 0.0;   // Tangent frames for normal mapping
+    double MeshletMs = 0.0;   // Clustering the triangles into meshlets
+    double QuantizeMs = 0.0;  // Packing the vertex data and measuring its error
+    double LodMs = 0.0;       // Simplifying the levels of detail
+  };
+
+  /// <summary>
+  /// The processing steps a mesh needs. Run folds them into as few sweeps over
+  /// the vertices as it can: the welding and reordering if requested, one for the bounds,
+  /// one for the normals if they are needed, and one that transforms, projects
+  /// UVs and writes the vertex data. The bounding volumes are fitted to the result,
+  /// then tangents, clustering and packing follow if requested. Levels of detail are simplified last.
+  /// </summary>
+  struct Pipeline
+  {
+    bool ScaleToUnitSize = false;   // Fit the mesh into a 1x1x1 cube
+    bool ResetOrigin = false;       // Move the centroid to the origin
+    bool CalculateNormals = false;  // Generate vertex normals
+    bool WeldVertices = false;      // Weld close vertices and drop degenerate triangles, done first
+    bool OptimizeVertexCache = false; // Reorder for the vertex cache and fetch
+    UV::Generation Texcoords = UV::Generation::CUSTOM; // UV projection, CUSTOM keeps the mesh's own
+    bool CalculateTangents = false; // Build the tangent stream from the final normals and UVs
+    bool BuildMeshlets = false;     // Cluster the triangles for culling, after the reordering
+    bool QuantizeVertices = false;  // Also pack the vertex data into the compact format
+    vector<float> LodRatios;        // Levels of detail to build, none if empty
+
+    /// <summary>
+    /// Picks the steps for a freshly read mesh: the import options, plus normals
+    /// and UVs for whatever the file didn't provide
+    /// </summary>
+    /// <param name="mesh">[Const Ref] The mesh that will be processed</param>
+    /// <param name="options">[Const Ref] The import options to apply</param>
+    /// <returns>The steps to run</returns>
+    static Pipeline FromOptions(const Mesh& mesh, const MeshCache::Options& options) noexcept;
+
+    /// <summary>
+    /// Runs the steps and assembles the vertex data. Needs no GL context, so it
+    /// runs on the loader threads.
+    /// </summary>
+    /// <param name="mesh">The mesh to process</param>
+    /// <param name="timings">[Out, Optional] Receives the time spent per phase</param>
+    void Run(Mesh& mesh, PhaseTimings* timings = nullptr) const noexcept;
+  };
+
+  /// <summary>
+  /// Applies the import options, fills in missing normals and UVs and assembles
+  /// the vertex data
+  /// </summary>
+  /// <param name="Result">The mesh to process</param>
+  /// <param name="Options">The import options to apply</param>
+  /// <param name="Timings">[Out, Optional] Receives the time spent per phase</param>
+  void Apply(Mesh& Result, const MeshCache::Options& Options, PhaseTimings* Timings = nullptr) noexcept;
+}
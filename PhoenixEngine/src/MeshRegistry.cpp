@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+// File:    MeshRegistry.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Hash indexed, reference counted table of the loaded meshes
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MeshRegistry.h"
+
+size_t MeshRegistry::KeyHash::operator()(const Key& key) const noexcept
+{
+  size_t h = static_cast<size_t>(key.NameId) * 0x9E3779B97F4A7C15ull;
+  h ^= (static_cast<size_t>(key.UvGeneration) << 8) | (static_cast<size_t>(key.GenerateTangents) << 7) |
+    (static_cast<size_t>(key.WeldVertices) << 6) |
+    (static_cast<size_t>(key.BuildMeshlets) << 5) |
+    (static_cast<size_t>(key.QuantizeVertices) << 4) | (static_cast<size_t>(key.GenerateLods) << 3) |
+    (static_cast<size_t>(key.OptimizeVertexCache) << 2) |
+    (static_cast<size_t>(key.ResetOrigin) << 1) | static_cast<size_t>(key.ScaleToUnitSize);
+  return h;
+}
+
+MeshHandle MeshRegistry::Find(const string& name, const MeshCache::Options& options) const noexcept
+{
+  const auto nameIt = m_NameIds.find(name);
+  if (nameIt == m_NameIds.end())
+    return MeshHandle();
+
+  const Key key{ nameIt->second, options.ScaleToUnitSize, options.ResetOrigin, options.UvGeneration,
+    options.OptimizeVertexCache, options.GenerateLods, options.QuantizeVertices, options.BuildMeshlets,
+    options.WeldVertices, options.GenerateTangents };
+  const auto it = m_Lookup.find(key);
+  if (it == m_Lookup.end())
+    return MeshHandle();
+
+  return MeshHandle{ it->second, m_Slots[it->second].Generation };
+}
+
+MeshHandle MeshRegistry::Insert(const string& name, const MeshCache::Options& options) noexcept
+{
+  const auto [nameIt, isNewName] = m_NameIds.try_emplace(name, static_cast<unsigned>(m_Names.size()));
+  if (isNewName)
+    m_Names.push_back(name);
+
+  unsigned index;
+  if (!m_FreeSlots.empty())
+  {
+    index = m_FreeSlots.back();
+    m_FreeSlots.pop_back();
+  }
+  else
+  {
+    index = static_cast<unsigned>(m_Slots.size());
+    m_Slots.push_back(Slot{ Key{}, 0u, 0u, false });
+  }
+
+  Slot& slot = m_Slots[index];
+  slot.MeshKey = Key{ nameIt->second, options.ScaleToUnitSize, options.ResetOrigin, options.UvGeneration,
+    options.OptimizeVertexCache, options.GenerateLods, options.QuantizeVertices, options.BuildMeshlets,
+    options.WeldVertices, options.GenerateTangents };
+  slot.ReferenceCount = 0u;
+  slot.InUse = true;
+  m_Lookup[slot.MeshKey] = index;
+
+  // Nothing holds it yet, it goes unless someone references it before collection
+  m_Unreferenced.push_back(index);
+
+  return MeshHandle{ index, slot.Generation };
+}
+
+bool MeshRegistry::IsValid(const MeshHandle& handle) const noexcept
+{
+  return handle.Index < m_Slots.size() &&
+    m_Slots[handle.Index].InUse &&
+    m_Slots[handle.Index].Generation == handle.Generation;
+}
+
+void MeshRegistry::AddReference(const MeshHandle& handle) noexcept
+{
+  if (IsValid(handle))
+    ++m_Slots[handle.Index].ReferenceCount;
+}
+
+void MeshRegistry::Release(const MeshHandle& handle) noexcept
+{
+  if (!IsValid(handle) || m_Slots[handle.Index].ReferenceCount == 0u)
+    return;
+
+  if (--m_Slots[handle.Index].ReferenceCount == 0u)
+    m_Unreferenced.push_back(handle.Index);
+}
+
+unsigned MeshRegistry::GetReferenceCount(const MeshHandle& handle) const noexcept
+{
+  return IsValid(handle) ? m_Slots[handle.Index].ReferenceCount : 0u;
+}
+
+vector<unsigned> MeshRegistry::CollectUnused() noexcept
+{
+  vector<unsigned> freed;
+  for (const unsigned index : m_Unreferenced)
+  {
+    // Referenced again, or already freed through a duplicate entry
+    const Slot& slot = m_Slots[index];
+    if (!slot.InUse || slot.ReferenceCount != 0u)
+      continue;
+
+    freeSlot(index);
+    freed.push_back(index);
+  }
+  m_Unreferenced.clear();
+  return freed;
+}
+
+vector<unsigned> MeshRegistry::Clear() noexcept
+{
+  vector<unsigned> freed;
+  for (unsigned index = 0u; index < m_Slots.size(); ++index)
+  {
+    if (!m_Slots[index].InUse)
+      continue;
+
+    freeSlot(index);
+    freed.push_back(index);
+  }
+  m_Unreferenced.clear();
+  return freed;
+}
+
+const string& MeshRegistry::GetName(const unsigned index) const noexcept
+{
+  return m_Names[m_Slots[index].MeshKey.NameId];
+}
+
+void MeshRegistry::freeSlot(const unsigned index) noexcept
+{
+  Slot& slot = m_Slots[index];
+  m_Lookup.erase(slot.MeshKey);
+  slot.InUse = false;
+  slot.ReferenceCount = 0u;
+  ++slot.Generation;
+  m_FreeSlots.push_back(index);
+}
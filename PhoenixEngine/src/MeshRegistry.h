@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+// File:    MeshRegistry.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Hash indexed, reference counted table of the loaded meshes
+//------------------------------------------------------------------------------
+#pragma once
+#include "MeshCache.h"
+
+#include <unordered_map>
+
+/// <summary>
+/// Refers to one registry slot. The generation is bumped every time the slot
+/// is freed, so handles to an unloaded mesh stop resolving instead of aliasing
+/// whatever is loaded into the slot next.
+/// </summary>
+struct MeshHandle
+{
+  unsigned Index = Error::INVALID_INDEX;  // Slot in the registry and mesh arrays
+  unsigned Generation = 0u;               // Generation of the slot when the handle was made
+
+  inline bool operator==(const MeshHandle& rhs) const noexcept
+  {
+    return Index == rhs.Index && Generation == rhs.Generation;
+  }
+  inline bool operator!=(const MeshHandle& rhs) const noexcept { return !(*this == rhs); }
+};
+
+class MeshRegistry
+{
+public:
+  MeshRegistry() noexcept = default;
+  ~MeshRegistry() = default;
+  MeshRegistry(const MeshRegistry&) = delete;
+  MeshRegistry& operator=(const MeshRegistry&) = delete;
+  MeshRegistry(MeshRegistry&&) = delete;
+  MeshRegistry& operator=(MeshRegistry&&) = delete;
+
+  /// <summary>
+  /// Finds the mesh loaded from a file with the given import options
+  /// </summary>
+  /// <param name="name">File name of the mesh</param>
+  /// <param name="options">Import options the mesh was processed with</param>
+  /// <returns>Handle to the mesh, or an invalid handle if it isn't registered</returns>
+  MeshHandle Find(const string& name, const MeshCache::Options& options) const noexcept;
+
+  /// <summary>
+  /// Registers a new mesh, reusing the slot of a freed one if possible
+  /// </summary>
+  /// <param name="name">File name of the mesh</param>
+  /// <param name="options">Import options the mesh will be processed with</param>
+  /// <returns>Handle to the new entry, it starts with no references</returns>
+  MeshHandle Insert(const string& name, const MeshCache::Options& options) noexcept;
+
+  /// <summary>
+  /// Checks that a handle still refers to a registered mesh
+  /// </summary>
+  /// <param name="handle">Handle to check</param>
+  /// <returns>[T/F] The handle's slot has not been freed since it was made</returns>
+  bool IsValid(const MeshHandle& handle) const noexcept;
+
+  /// <summary>
+  /// Adds a reference to a mesh, stale handles are ignored
+  /// </summary>
+  /// <param name="handle">Handle of the mesh</param>
+  void AddReference(const MeshHandle& handle) noexcept;
+
+  /// <summary>
+  /// Removes a reference to a mesh, stale handles are ignored. A mesh without
+  /// references is freed by the next CollectUnused unless it is referenced again.
+  /// </summary>
+  /// <param name="handle">Handle of the mesh</param>
+  void Release(const MeshHandle& handle) noexcept;
+
+  /// <summary>
+  /// Gets the number of references to a mesh
+  /// </summary>
+  /// <param name="handle">Handle of the mesh</param>
+  /// <returns>The reference count, or 0 for a stale handle</returns>
+  unsigned GetReferenceCount(const MeshHandle& handle) const noexcept;
+
+  /// <summary>
+  /// Frees every mesh that has no references
+  /// </summary>
+  /// <returns>The slots that were freed, their resources can be released</returns>
+  vector<unsigned> CollectUnused() noexcept;
+
+  /// <summary>
+  /// Frees every mesh regardless of references, invalidating all handles
+  /// </summary>
+  /// <returns>The slots that were freed, their resources can be released</returns>
+  vector<unsigned> Clear() noexcept;
+
+  /// <summary>
+  /// Gets the file name of the mesh in a slot
+  /// </summary>
+  /// <param name="index">Slot of the mesh</param>
+  /// <returns>[Const Ref] The interned file name</returns>
+  const string& GetName(unsigned index) const noexcept;
+
+  /// <summary>
+  /// Gets the current generation of a slot
+  /// </summary>
+  /// <param name="index">Slot of the mesh</param>
+  /// <returns>The generation valid handles to the slot carry</returns>
+  inline unsigned GetGeneration(unsigned index) const noexcept { return m_Slots[index].Generation; }
+
+  /// <summary>
+  /// Gets the number of slots, used and free
+  /// </summary>
+  /// <returns>One past the highest slot index handed out</returns>
+  inline size_t GetSlotCount() const noexcept { return m_Slots.size(); }
+
+private:
+  // A mesh is identified by its file and every option that changes its processed data
+  struct Key
+  {
+    unsigned NameId;
+    bool ScaleToUnitSize;
+    bool ResetOrigin;
+    UV::Generation UvGeneration;
+    bool OptimizeVertexCache;
+    bool GenerateLods;
+    bool QuantizeVertices;
+    bool BuildMeshlets;
+    bool WeldVertices;
+    bool GenerateTangents;
+
+    inline bool operator==(const Key& rhs) const noexcept
+    {
+      return NameId == rhs.NameId && ScaleToUnitSize == rhs.ScaleToUnitSize &&
+        ResetOrigin == rhs.ResetOrigin && UvGeneration == rhs.UvGeneration &&
+        OptimizeVertexCache == rhs.OptimizeVertexCache && GenerateLods == rhs.GenerateLods &&
+        QuantizeVertices == rhs.QuantizeVertices && BuildMeshlets == rhs.BuildMeshlets &&
+        WeldVertices == rhs.WeldVertices && GenerateTangents == rhs.GenerateTangents;
+    }
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(const Key& key) const noexcept;
+  };
+
+  struct Slot
+  {
+    Key MeshKey;
+    unsigned Generation;
+    unsigned ReferenceCount;
+    bool InUse;
+  };
+
+  std::unordered_map<string, unsigned> m_NameIds;   // Interned file names
+  vector<string> m_Names;                           // File name of each name ID
+  std::unordered_map<Key, unsigned, KeyHash> m_Lookup; // Registered meshes by key
+  vector<Slot> m_Slots;
+  vector<unsigned> m_FreeSlots;                     // Slots that can be reused
+  vector<unsigned> m_Unreferenced;                  // Slots whose count reached 0, may be stale
+
+  void freeSlot(unsigned index) noexcept;
+};
@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+// File:    MeshSimplifier.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Quadric error metric mesh simplification for levels of detail
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MeshSimplifier.h"
+
+namespace
+{
+  // Sum of squared distances to a set of planes, weighted by triangle area.
+  // The symmetric 4x4 matrix is stored as its 10 unique entries.
+  struct Quadric
+  {
+    float A00 = 0.f, A11 = 0.f, A22 = 0.f;
+    float A01 = 0.f, A02 = 0.f, A12 = 0.f;
+    float B0 = 0.f, B1 = 0.f, B2 = 0.f;
+    float C = 0.f;
+    float Weight = 0.f;
+
+    // Adds the plane dot(normal, p) + distance = 0
+    void AddPlane(const vec3& normal, const float distance, const float weight) noexcept
+    {
+      A00 += weight * normal.x * normal.x;
+      A11 += weight * normal.y * normal.y;
+      A22 += weight * normal.z * normal.z;
+      A01 += weight * normal.x * normal.y;
+      A02 += weight * normal.x * normal.z;
+      A12 += weight * normal.y * normal.z;
+      B0 += weight * normal.x * distance;
+      B1 += weight * normal.y * distance;
+      B2 += weight * normal.z * distance;
+      C += weight * distance * distance;
+      Weight += weight;
+    }
+
+    void Add(const Quadric& other) noexcept
+    {
+      A00 += other.A00; A11 += other.A11; A22 += other.A22;
+      A01 += other.A01; A02 += other.A02; A12 += other.A12;
+      B0 += other.B0; B1 += other.B1; B2 += other.B2;
+      C += other.C;
+      Weight += other.Weight;
+    }
+
+    // Weighted sum of squared distances from p to the planes
+    float Evaluate(const vec3& p) const noexcept
+    {
+      const float result =
+        A00 * p.x * p.x + A11 * p.y * p.y + A22 * p.z * p.z +
+        2.f * (A01 * p.x * p.y + A02 * p.x * p.z + A12 * p.y * p.z) +
+        2.f * (B0 * p.x + B1 * p.y + B2 * p.z) + C;
+      // Rounding can take it just below zero
+      return std::abs(result);
+    }
+  };
+
+  struct Collapse
+  {
+    unsigned From;  // Vertex that is removed
+    unsigned To;    // Vertex it merges into
+    float Cost;     // Squared distance the surface moves
+  };
+
+  // Cost of moving vertex 'from' onto vertex 'to', as a squared distance
+  float collapseCost(const vector<Quadric>& quadrics, const vector<vec3>& positions, const unsigned from, const unsigned to) noexcept
+  {
+    const float weight = quadrics[from].Weight + quadrics[to].Weight;
+    const float error = quadrics[from].Evaluate(positions[to]) + quadrics[to].Evaluate(positions[to]);
+    return weight > 0.f ? error / weight : error;
+  }
+
+  // Checks whether moving 'from' onto 'to' would turn any surviving triangle
+  // around 'from' over. Corners are looked up through the collapses already
+  // made this pass.
+  bool flipsTriangles(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+    const Mesh::VertexAdjacency& adjacency, const vector<unsigned>& collapseTo, const unsigned from, const unsigned to) noexcept
+  {
+    for (unsigned k = adjacency.Offsets[from]; k < adjacency.Offsets[from + 1u]; ++k)
+    {
+      const Mesh::Triangle& tri = triangles[adjacency.Triangles[k]];
+      unsigned corners[3] = { collapseTo[tri.Index1], collapseTo[tri.Index2], collapseTo[tri.Index3] };
+
+      // Triangles on the collapsing edge disappear, and degenerate ones don't matter
+      if (corners[0] == to || corners[1] == to || corners[2] == to ||
+        corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2])
+        continue;
+
+      const vec3 before = cross(positions[corners[1]] - positions[corners[0]], positions[corners[2]] - positions[corners[0]]);
+      for (unsigned& corner : corners)
+      {
+        if (corner == from)
+          corner = to;
+      }
+      const vec3 after = cross(positions[corners[1]] - positions[corners[0]], positions[corners[2]] - positions[corners[0]]);
+
+      if (dot(before, after) <= 1e-2f * glm::length(before) * glm::length(after))
+        return true;
+    }
+    return false;
+  }
+}
+
+vector<Mesh::Triangle> MeshSimplifier::Simplify(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+  const size_t targetTriangleCount, float* resultError) noexcept
+{
+  const size_t vertexCount = positions.size();
+  float maxCost = 0.f;
+
+  // Work on a copy without degenerate triangles
+  vector<Mesh::Triangle> result;
+  result.reserve(triangles.size());
+  for (const Mesh::Triangle& tri : triangles)
+  {
+    if (tri.Index1 != tri.Index2 && tri.Index2 != tri.Index3 && tri.Index1 != tri.Index3)
+      result.push_back(tri);
+  }
+
+  // Each vertex starts with the planes of the triangles around it
+  vector<Quadric> quadrics(vertexCount);
+  for (const Mesh::Triangle& tri : result)
+  {
+    const vec3& p0 = positions[tri.Index1];
+    const vec3 normal = cross(positions[tri.Index2] - p0, positions[tri.Index3] - p0);
+    const float length = glm::length(normal);
+    if (length <= 0.f)
+      continue;
+
+    const vec3 unitNormal = normal / length;
+    const float distance = -dot(unitNormal, p0);
+    const float area = 0.5f * length;
+    quadrics[tri.Index1].AddPlane(unitNormal, distance, area);
+    quadrics[tri.Index2].AddPlane(unitNormal, distance, area);
+    quadrics[tri.Index3].AddPlane(unitNormal, distance, area);
+  }
+
+  vector<uint64_t> edges;
+  vector<Collapse> collapses;
+  vector<bool> isLocked(vertexCount);
+  vector<bool> isTouched(vertexCount);
+  vector<unsigned> collapseTo(vertexCount);
+  Mesh::VertexAdjacency adjacency;
+
+  // Each pass collapses a set of independent edges, cheapest first
+  while (result.size() > targetTriangleCount)
+  {
+    // Find every edge and how many triangles share it, packed as (low << 32 | high)
+    edges.clear();
+    for (const Mesh::Triangle& tri : result)
+    {
+      for (const auto& [a, b] : { std::pair{ tri.Index1, tri.Index2 }, std::pair{ tri.Index2, tri.Index3 }, std::pair{ tri.Index3, tri.Index1 } })
+        edges.push_back((uint64_t(std::min(a, b)) << 32u) | uint64_t(std::max(a, b)));
+    }
+    std::sort(edges.begin(), edges.end());
+
+    // Edges with one triangle are borders and seams, more than two are non-manifold.
+    // Their vertices can't move without tearing or folding the surface.
+    std::fill(isLocked.begin(), isLocked.end(), false);
+    for (size_t first = 0u; first < edges.size();)
+    {
+      size_t last = first + 1u;
+      while (last < edges.size() && edges[last] == edges[first])
+        ++last;
+      if (last - first != 2u)
+      {
+        isLocked[static_cast<unsigned>(edges[first] >> 32u)] = true;
+        isLocked[static_cast<unsigned>(edges[first])] = true;
+      }
+      first = last;
+    }
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    // Cheapest direction for every edge that can collapse at all
+    collapses.clear();
+    for (const uint64_t edge : edges)
+    {
+      const auto low = static_cast<unsigned>(edge >> 32u);
+      const auto high = static_cast<unsigned>(edge);
+      if (isLocked[low] && isLocked[high])
+        continue;
+
+      Collapse collapse{ low, high, std::numeric_limits<float>::max() };
+      if (!isLocked[low])
+        collapse.Cost = collapseCost(quadrics, positions, low, high);
+      if (!isLocked[high])
+      {
+        const float cost = collapseCost(quadrics, positions, high, low);
+        if (cost < collapse.Cost)
+          collapse = Collapse{ high, low, cost };
+      }
+      collapses.push_back(collapse);
+    }
+    if (collapses.empty())
+      break;
+    std::sort(collapses.begin(), collapses.end(),
+      [](const Collapse& lhs, const Collapse& rhs) { return lhs.Cost < rhs.Cost; });
+
+    Mesh::BuildVertexAdjacency(result, vertexCount, adjacency);
+    std::fill(isTouched.begin(), isTouched.end(), false);
+    for (unsigned v = 0u; v < vertexCount; ++v)
+      collapseTo[v] = v;
+
+    // Every collapse removes about two triangles. Vertices already involved in
+    // a collapse this pass sit out until the next, so each check sees a valid mesh.
+    const size_t wantedCollapses = (result.size() - targetTriangleCount) / 2u + 1u;
+    size_t madeCollapses = 0u;
+    for (const Collapse& collapse : collapses)
+    {
+      if (madeCollapses >= wantedCollapses)
+        break;
+      if (isTouched[collapse.From] || isTouched[collapse.To])
+        continue;
+      if (flipsTriangles(positions, result, adjacency, collapseTo, collapse.From, collapse.To))
+        continue;
+
+      collapseTo[collapse.From] = collapse.To;
+      isTouched[collapse.From] = true;
+      isTouched[collapse.To] = true;
+      quadrics[collapse.To].Add(quadrics[collapse.From]);
+      maxCost = std::max(maxCost, collapse.Cost);
+      ++madeCollapses;
+    }
+    if (madeCollapses == 0u)
+      break;
+
+    // Move the collapsed corners and drop the triangles that became degenerate
+    size_t kept = 0u;
+    for (const Mesh::Triangle& tri : result)
+    {
+      const Mesh::Triangle moved(collapseTo[tri.Index1], collapseTo[tri.Index2], collapseTo[tri.Index3]);
+      if (moved.Index1 != moved.Index2 && moved.Index2 != moved.Index3 && moved.Index1 != moved.Index3)
+        result[kept++] = moved;
+    }
+    result.resize(kept);
+  }
+
+  if (resultError)
+    *resultError = sqrtf(maxCost);
+  return result;
+}
@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------
+// File:    MeshSimplifier.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Quadric error metric mesh simplification for levels of detail
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+
+namespace MeshSimplifier
+{
+  /// <summary>
+  /// Reduces a triangle list with quadric error metrics (Garland and Heckbert
+  /// 1997). Edges collapse onto one of their endpoints rather than a new point,
+  /// so the result indexes the same vertices and every level of detail shares
+  /// one vertex buffer. Vertices on open borders and non-manifold edges stay
+  /// put, which includes UV and normal seams since those vertices are split.
+  /// </summary>
+  /// <param name="positions">[Const Ref] Vertex positions</param>
+  /// <param name="triangles">[Const Ref] Triangles to simplify</param>
+  /// <param name="targetTriangleCount">Triangle count to stop at, may not be reached if too much is locked</param>
+  /// <param name="resultError">[Out, Optional] Receives the largest distance a collapse moved the surface</param>
+  /// <returns>The simplified triangles</returns>
+  vector<Mesh::Triangle> Simplify(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+    size_t targetTriangleCount, float* resultError = nullptr) noexcept;
+}
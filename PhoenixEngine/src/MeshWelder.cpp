@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+// File:    MeshWelder.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Spatial hash vertex welding and degenerate triangle removal
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MeshWelder.h"
+
+namespace
+{
+  // Cell coordinates get 21 bits each so a cell packs into one 64 bit key
+  constexpr float MaxCellsPerAxis = float(1u << 20u);
+  constexpr uint64_t CoordinateMask = (uint64_t(1u) << 21u) - 1u;
+
+  uint64_t cellKey(const unsigned x, const unsigned y, const unsigned z) noexcept
+  {
+    return (uint64_t(x) << 42u) | (uint64_t(y) << 21u) | uint64_t(z);
+  }
+
+  // Fibonacci hashing into a power of two table
+  size_t hashSlot(const uint64_t key, const unsigned bits) noexcept
+  {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64u - bits));
+  }
+
+  // Smallest power of two exponent with at least twice as many slots as entries
+  unsigned tableBits(const size_t entries) noexcept
+  {
+    unsigned bits = 1u;
+    while ((size_t(1u) << bits) < 2u * entries)
+      ++bits;
+    return bits;
+  }
+}
+
+vector<unsigned> MeshWelder::WeldVertices(const vector<vec3>& positions, const vector<vec3>* normals,
+  const vector<vec2>* texcoords, const float epsilon, unsigned& keptCount) noexcept
+{
+  const size_t vertexCount = positions.size();
+  vector<unsigned> remap(vertexCount, Error::INVALID_INDEX);
+  keptCount = 0u;
+  if (vertexCount == 0u)
+    return remap;
+
+  vec3 min(std::numeric_limits<float>::max()), max(-std::numeric_limits<float>::max());
+  for (const vec3& p : positions)
+  {
+    min = glm::min(min, p);
+    max = glm::max(max, p);
+  }
+
+  // Cells two epsilons wide, unless that would need more cells than a key holds
+  const vec3 extent = max - min;
+  const float widest = std::max(std::max(extent.x, extent.y), extent.z);
+  float cellSize = std::max(2.f * epsilon, widest / MaxCellsPerAxis);
+  if (!(cellSize > 0.f))
+    cellSize = 1.f;
+  const float inverseCellSize = 1.f / cellSize;
+  const float epsilonSquared = epsilon * epsilon;
+
+  // Each occupied cell holds the head of a list of its kept vertices
+  const unsigned bits = tableBits(vertexCount);
+  const size_t mask = (size_t(1u) << bits) - 1u;
+  vector<uint64_t> slotKeys(mask + 1u);
+  vector<unsigned> slotHeads(mask + 1u, Error::INVALID_INDEX);
+  vector<unsigned> nextInCell(vertexCount, Error::INVALID_INDEX);
+
+  const auto findSlot = [&](const uint64_t key)
+  {
+    size_t slot = hashSlot(key, bits);
+    while (slotHeads[slot] != Error::INVALID_INDEX && slotKeys[slot] != key)
+      slot = (slot + 1u) & mask;
+    return slot;
+  };
+
+  const auto cellCoordinate = [&](const float value, const float origin)
+  {
+    const float cell = std::floor((value - origin) * inverseCellSize);
+    return static_cast<unsigned>(glm::clamp(cell, 0.f, float(CoordinateMask)));
+  };
+
+  const auto matches = [&](const unsigned kept, const unsigned v)
+  {
+    const vec3 offset = positions[kept] - positions[v];
+    if (dot(offset, offset) > epsilonSquared)
+      return false;
+    if (normals && glm::length((*normals)[kept] - (*normals)[v]) > NORMAL_TOLERANCE)
+      return false;
+    if (texcoords && glm::length((*texcoords)[kept] - (*texcoords)[v]) > TEXCOORD_TOLERANCE)
+      return false;
+    return true;
+  };
+
+  for (unsigned v = 0u; v < vertexCount; ++v)
+  {
+    const vec3& p = positions[v];
+
+    // NaNs and infinities can't be placed in the grid, they stay as they are
+    if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z))
+    {
+      remap[v] = keptCount++;
+      continue;
+    }
+
+    // Look through every cell the epsilon ball touches
+    const unsigned lowX = cellCoordinate(p.x - epsilon, min.x), highX = cellCoordinate(p.x + epsilon, min.x);
+    const unsigned lowY = cellCoordinate(p.y - epsilon, min.y), highY = cellCoordinate(p.y + epsilon, min.y);
+    const unsigned lowZ = cellCoordinate(p.z - epsilon, min.z), highZ = cellCoordinate(p.z + epsilon, min.z);
+    unsigned target = Error::INVALID_INDEX;
+    for (unsigned x = lowX; x <= highX && target == Error::INVALID_INDEX; ++x)
+    {
+      for (unsigned y = lowY; y <= highY && target == Error::INVALID_INDEX; ++y)
+      {
+        for (unsigned z = lowZ; z <= highZ && target == Error::INVALID_INDEX; ++z)
+        {
+          for (unsigned kept = slotHeads[findSlot(cellKey(x, y, z))]; kept != Error::INVALID_INDEX; kept = nextInCell[kept])
+          {
+            if (matches(kept, v))
+            {
+              target = kept;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    if (target != Error::INVALID_INDEX)
+    {
+      remap[v] = remap[target];
+      continue;
+    }
+
+    // Nothing close enough, so this one is kept and others may weld onto it
+    remap[v] = keptCount++;
+    const uint64_t key = cellKey(cellCoordinate(p.x, min.x), cellCoordinate(p.y, min.y), cellCoordinate(p.z, min.z));
+    const size_t slot = findSlot(key);
+    slotKeys[slot] = key;
+    nextInCell[v] = slotHeads[slot];
+    slotHeads[slot] = v;
+  }
+
+  return remap;
+}
+
+vector<unsigned> MeshWelder::CleanTriangles(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+  const float epsilon, unsigned& degenerateCount, unsigned& duplicateCount) noexcept
+{
+  degenerateCount = 0u;
+  duplicateCount = 0u;
+  vector<unsigned> kept;
+  kept.reserve(triangles.size());
+  if (triangles.empty())
+    return kept;
+
+  // Kept triangles by their vertices, rotated to start at the lowest index
+  const unsigned bits = tableBits(triangles.size());
+  const size_t mask = (size_t(1u) << bits) - 1u;
+  vector<Mesh::Triangle> slots(mask + 1u);
+
+  for (unsigned t = 0u; t < triangles.size(); ++t)
+  {
+    const Mesh::Triangle& tri = triangles[t];
+    if (tri.Index1 == tri.Index2 || tri.Index2 == tri.Index3 || tri.Index1 == tri.Index3)
+    {
+      ++degenerateCount;
+      continue;
+    }
+
+    // Twice the area over the longest edge is the smallest height
+    const vec3& p1 = positions[tri.Index1];
+    const vec3& p2 = positions[tri.Index2];
+    const vec3& p3 = positions[tri.Index3];
+    const float longest = std::max(std::max(glm::length(p2 - p1), glm::length(p3 - p2)), glm::length(p1 - p3));
+    if (!(glm::length(cross(p2 - p1, p3 - p1)) > epsilon * longest))
+    {
+      ++degenerateCount;
+      continue;
+    }
+
+    Mesh::Triangle key = tri;
+    if (tri.Index2 < tri.Index1 && tri.Index2 < tri.Index3)
+      key = Mesh::Triangle(tri.Index2, tri.Index3, tri.Index1);
+    else if (tri.Index3 < tri.Index1 && tri.Index3 < tri.Index2)
+      key = Mesh::Triangle(tri.Index3, tri.Index1, tri.Index2);
+
+    const uint64_t hash = (uint64_t(key.Index1) << 42u) ^ (uint64_t(key.Index2) << 21u) ^ uint64_t(key.Index3);
+    size_t slot = hashSlot(hash, bits);
+    bool isDuplicate = false;
+    while (slots[slot].Index1 != Error::INVALID_INDEX)
+    {
+      const Mesh::Triangle& other = slots[slot];
+      if (other.Index1 == key.Index1 && other.Index2 == key.Index2 && other.Index3 == key.Index3)
+      {
+        isDuplicate = true;
+        break;
+      }
+      slot = (slot + 1u) & mask;
+    }
+
+    if (isDuplicate)
+    {
+      ++duplicateCount;
+      continue;
+    }
+    slots[slot] = key;
+    kept.push_back(t);
+  }
+
+  return kept;
+}
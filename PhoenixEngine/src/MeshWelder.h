@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+// File:    MeshWelder.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Spatial hash vertex welding and degenerate triangle removal
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+
+namespace MeshWelder
+{
+  // Weld distance used on import, relative to the bounding box diagonal
+  constexpr float DEFAULT_EPSILON = 1e-5f;
+
+  // How far apart unit normals and UVs may be for their vertices to still weld
+  constexpr float NORMAL_TOLERANCE = 1e-3f;
+  constexpr float TEXCOORD_TOLERANCE = 1e-5f;
+
+  /// <summary>
+  /// Finds the vertices within epsilon of an earlier vertex that is kept, and
+  /// whose normals and UVs match it too if those are given. Kept vertices go
+  /// into a spatial hash grid with cells two epsilons wide, so each vertex
+  /// only looks through the 1 to 8 cells its epsilon ball overlaps.
+  /// </summary>
+  /// <param name="positions">[Const Ref] Vertex positions</param>
+  /// <param name="normals">[Optional] Normals that must match, nullptr to weld regardless</param>
+  /// <param name="texcoords">[Optional] UVs that must match, nullptr to weld regardless</param>
+  /// <param name="epsilon">Largest distance between welded positions</param>
+  /// <param name="keptCount">[Out] Receives the number of vertices left</param>
+  /// <returns>The new index of each vertex. Kept vertices keep their order and come before the ones welded onto them.</returns>
+  vector<unsigned> WeldVertices(const vector<vec3>& positions, const vector<vec3>* normals,
+    const vector<vec2>* texcoords, float epsilon, unsigned& keptCount) noexcept;
+
+  /// <summary>
+  /// Finds the triangles worth keeping. Triangles with a repeated vertex, or
+  /// thinner than epsilon, are degenerate. A triangle with the same vertices
+  /// and winding as an earlier one is a duplicate, the reverse winding is
+  /// kept as the back face.
+  /// </summary>
+  /// <param name="positions">[Const Ref] Vertex positions</param>
+  /// <param name="triangles">[Const Ref] The triangles, already indexing the welded vertices</param>
+  /// <param name="epsilon">Smallest height a triangle keeps</param>
+  /// <param name="degenerateCount">[Out] Receives the number of degenerate triangles</param>
+  /// <param name="duplicateCount">[Out] Receives the number of duplicate triangles</param>
+  /// <returns>The indices of the kept triangles, in order</returns>
+  vector<unsigned> CleanTriangles(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+    float epsilon, unsigned& degenerateCount, unsigned& duplicateCount) noexcept;
+}
@@ -0,0 +1,221 @@
+//------------------------------------------------------------------------------
+// File:    MeshletBuilder.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Splits triangle lists into meshlets with culling bounds
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "MeshletBuilder.h"
+
+namespace
+{
+  // Fills in the bounding sphere and normal cone of a meshlet, whose
+  // triangles are order[FirstTriangle] onwards
+  void calculateBounds(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+    const vector<unsigned>& order, Mesh::Meshlet& meshlet) noexcept
+  {
+    // Sphere around the center of the box, small enough for clusters this size
+    vec3 min(std::numeric_limits<float>::max());
+    vec3 max(std::numeric_limits<float>::lowest());
+    vec3 normalSum(0.f);
+    for (unsigned t = meshlet.FirstTriangle; t < meshlet.FirstTriangle + meshlet.TriangleCount; ++t)
+    {
+      const Mesh::Triangle& tri = triangles[order[t]];
+      for (const unsigned vertex : { tri.Index1, tri.Index2, tri.Index3 })
+      {
+        min = glm::min(min, positions[vertex]);
+        max = glm::max(max, positions[vertex]);
+      }
+
+      const vec3 normal = cross(positions[tri.Index2] - positions[tri.Index1], positions[tri.Index3] - positions[tri.Index1]);
+      const float length = glm::length(normal);
+      if (length > 0.f)
+        normalSum += normal / length;
+    }
+
+    meshlet.Center = 0.5f * (min + max);
+    meshlet.Radius = 0.f;
+    for (unsigned t = meshlet.FirstTriangle; t < meshlet.FirstTriangle + meshlet.TriangleCount; ++t)
+    {
+      const Mesh::Triangle& tri = triangles[order[t]];
+      for (const unsigned vertex : { tri.Index1, tri.Index2, tri.Index3 })
+        meshlet.Radius = std::max(meshlet.Radius, glm::length(positions[vertex] - meshlet.Center));
+    }
+
+    // The cone around the average normal that holds every triangle normal. A
+    // cutoff of 1 never culls, for clusters whose normals spread over a hemisphere.
+    meshlet.ConeApex = meshlet.Center;
+    meshlet.ConeAxis = vec3(0.f);
+    meshlet.ConeCutoff = 1.f;
+    const float sumLength = glm::length(normalSum);
+    if (sumLength <= 0.f)
+      return;
+
+    const vec3 axis = normalSum / sumLength;
+    float minDot = 1.f;
+    for (unsigned t = meshlet.FirstTriangle; t < meshlet.FirstTriangle + meshlet.TriangleCount; ++t)
+    {
+      const Mesh::Triangle& tri = triangles[order[t]];
+      const vec3 normal = cross(positions[tri.Index2] - positions[tri.Index1], positions[tri.Index3] - positions[tri.Index1]);
+      const float length = glm::length(normal);
+      if (length > 0.f)
+        minDot = std::min(minDot, dot(axis, normal) / length);
+    }
+    if (minDot <= 0.f)
+      return;
+
+    // Slide the apex back along the axis until it is behind every triangle's plane
+    float apexDistance = 0.f;
+    for (unsigned t = meshlet.FirstTriangle; t < meshlet.FirstTriangle + meshlet.TriangleCount; ++t)
+    {
+      const Mesh::Triangle& tri = triangles[order[t]];
+      const vec3& p0 = positions[tri.Index1];
+      const vec3 normal = cross(positions[tri.Index2] - p0, positions[tri.Index3] - p0);
+      const float alongAxis = dot(axis, normal);
+      if (alongAxis > 0.f)
+        apexDistance = std::max(apexDistance, dot(meshlet.Center - p0, normal) / alongAxis);
+    }
+
+    // Facing away needs the view direction within 90 degrees minus the cone's
+    // half angle of the axis, so the cutoff is the sine of the half angle
+    meshlet.ConeApex = meshlet.Center - axis * apexDistance;
+    meshlet.ConeAxis = axis;
+    meshlet.ConeCutoff = sqrtf(std::max(0.f, 1.f - minDot * minDot));
+  }
+}
+
+vector<Mesh::Meshlet> MeshletBuilder::Build(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+  const Mesh::VertexAdjacency& adjacency, vector<unsigned>& triangleOrder,
+  const unsigned maxVertices, const unsigned maxTriangles) noexcept
+{
+  vector<Mesh::Meshlet> meshlets;
+  triangleOrder.clear();
+  triangleOrder.reserve(triangles.size());
+  if (triangles.empty() || maxVertices < 3u || maxTriangles == 0u)
+    return meshlets;
+
+  // The meshlet each vertex was last added to, so a vertex is counted once per meshlet
+  vector<unsigned> vertexMeshlet(positions.size(), Error::INVALID_INDEX);
+  vector<bool> isEmitted(triangles.size(), false);
+  vector<unsigned> candidates;    // Triangles sharing a vertex with the open meshlet
+  size_t scanCursor = 0u;         // Everything before this has been emitted
+
+  Mesh::Meshlet current{ 0u, 0u, vec3(0.f), 0.f, vec3(0.f), vec3(0.f), 1.f };
+  unsigned vertexCount = 0u;
+  vec3 centroidSum(0.f);          // Sum of the triangle centroids, for the open meshlet's center
+
+  const auto centroid = [&](const Mesh::Triangle& tri)
+  {
+    return (positions[tri.Index1] + positions[tri.Index2] + positions[tri.Index3]) * (1.f / 3.f);
+  };
+
+  // Vertices of a triangle not yet in the open meshlet, a corner repeated
+  // within the triangle only counts once
+  const auto countNewVertices = [&](const Mesh::Triangle& tri)
+  {
+    const auto meshletId = static_cast<unsigned>(meshlets.size());
+    const unsigned corners[3] = { tri.Index1, tri.Index2, tri.Index3 };
+    unsigned count = 0u;
+    for (unsigned c = 0u; c < 3u; ++c)
+    {
+      const bool isRepeat = (c > 0u && corners[c] == corners[0]) || (c > 1u && corners[c] == corners[1]);
+      if (!isRepeat && vertexMeshlet[corners[c]] != meshletId)
+        ++count;
+    }
+    return count;
+  };
+
+  const auto closeMeshlet = [&]()
+  {
+    calculateBounds(positions, triangles, triangleOrder, current);
+    meshlets.push_back(current);
+    current.FirstTriangle = static_cast<unsigned>(triangleOrder.size());
+    current.TriangleCount = 0u;
+    vertexCount = 0u;
+    centroidSum = vec3(0.f);
+    candidates.clear();
+  };
+
+  while (triangleOrder.size() < triangles.size())
+  {
+    // Grow towards the neighbour that adds the fewest vertices, then the one
+    // closest to the meshlet, which keeps the clusters round and their normal cones tight
+    unsigned next = Error::INVALID_INDEX;
+    unsigned bestNew = 4u;
+    float bestDistance = std::numeric_limits<float>::max();
+    const vec3 center = current.TriangleCount > 0u ? centroidSum / static_cast<float>(current.TriangleCount) : vec3(0.f);
+    size_t kept = 0u;
+    for (const unsigned t : candidates)
+    {
+      if (isEmitted[t])
+        continue;
+      candidates[kept++] = t;
+
+      const unsigned newVertices = countNewVertices(triangles[t]);
+      if (vertexCount + newVertices > maxVertices || newVertices > bestNew)
+        continue;
+      const float distance = glm::length(centroid(triangles[t]) - center);
+      if (newVertices < bestNew || distance < bestDistance)
+      {
+        next = t;
+        bestNew = newVertices;
+        bestDistance = distance;
+      }
+    }
+    candidates.resize(kept);
+
+    if (next == Error::INVALID_INDEX)
+    {
+      // Nothing connected fits. Start the next meshlet beside this one, or at
+      // the first triangle left in the original order once this patch is done.
+      if (candidates.empty())
+      {
+        while (isEmitted[scanCursor])
+          ++scanCursor;
+        next = static_cast<unsigned>(scanCursor);
+      }
+      else
+      {
+        next = candidates.front();
+      }
+      if (current.TriangleCount > 0u)
+        closeMeshlet();
+    }
+
+    const Mesh::Triangle& tri = triangles[next];
+    const auto meshletId = static_cast<unsigned>(meshlets.size());
+    vertexCount += countNewVertices(tri);
+    for (const unsigned vertex : { tri.Index1, tri.Index2, tri.Index3 })
+    {
+      if (vertexMeshlet[vertex] == meshletId)
+        continue;
+      vertexMeshlet[vertex] = meshletId;
+      for (unsigned k = adjacency.Offsets[vertex]; k < adjacency.Offsets[vertex + 1u]; ++k)
+      {
+        if (!isEmitted[adjacency.Triangles[k]])
+          candidates.push_back(adjacency.Triangles[k]);
+      }
+    }
+
+    isEmitted[next] = true;
+    triangleOrder.push_back(next);
+    centroidSum += centroid(tri);
+    if (++current.TriangleCount == maxTriangles)
+      closeMeshlet();
+  }
+
+  if (current.TriangleCount > 0u)
+    closeMeshlet();
+  return meshlets;
+}
+
+bool MeshletBuilder::IsBackFacing(const Mesh::Meshlet& meshlet, const vec3& eye) noexcept
+{
+  if (meshlet.ConeCutoff >= 1.f)
+    return false;
+
+  // The apex is behind every triangle's plane, so seen from within the cutoff
+  // every triangle is seen from behind as well
+  const vec3 toApex = meshlet.ConeApex - eye;
+  return dot(toApex, meshlet.ConeAxis) >= meshlet.ConeCutoff * glm::length(toApex);
+}
@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+// File:    MeshletBuilder.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Splits triangle lists into meshlets with culling bounds
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+
+namespace MeshletBuilder
+{
+  // Limits of one meshlet, the sizes mesh shader pipelines are built around
+  constexpr unsigned MAX_VERTICES = 64u;
+  constexpr unsigned MAX_TRIANGLES = 124u;
+
+  /// <summary>
+  /// Groups the triangles into meshlets of at most maxVertices unique vertices
+  /// and maxTriangles triangles. Each meshlet grows across shared vertices
+  /// towards its center, so it stays compact and its normal cone narrow. The
+  /// triangles are reordered so that every meshlet is a range of the index buffer.
+  /// </summary>
+  /// <param name="positions">[Const Ref] Vertex positions</param>
+  /// <param name="triangles">[Const Ref] Triangles in their current order</param>
+  /// <param name="adjacency">[Const Ref] Triangles around each vertex, for these triangles</param>
+  /// <param name="triangleOrder">[Out] Receives the triangle indices in their new order</param>
+  /// <param name="maxVertices">Unique vertices allowed per meshlet</param>
+  /// <param name="maxTriangles">Triangles allowed per meshlet</param>
+  /// <returns>The meshlets, as ranges of the new order, with their bounding spheres and normal cones</returns>
+  vector<Mesh::Meshlet> Build(const vector<vec3>& positions, const vector<Mesh::Triangle>& triangles,
+    const Mesh::VertexAdjacency& adjacency, vector<unsigned>& triangleOrder,
+    unsigned maxVertices = MAX_VERTICES, unsigned maxTriangles = MAX_TRIANGLES) noexcept;
+
+  /// <summary>
+  /// Checks whether every triangle of a meshlet faces away from the eye.
+  /// Conservative: only returns true when that holds anywhere in the bounding sphere.
+  /// </summary>
+  /// <param name="meshlet">[Const Ref] The meshlet</param>
+  /// <param name="eye">[Const Ref] Eye position in the same space as the meshlet</param>
+  /// <returns>[T/F] The meshlet can be skipped when back faces are culled</returns>
+  bool IsBackFacing(const Mesh::Meshlet& meshlet, const vec3& eye) noexcept;
+}
@@ -8,9 +8,16 @@
 #include "GLEW/glew.h"
 #include <cfloat>
 #include <chrono>
+#include <charconv>
 #include <set>
+#include <future>
+#include <thread>
+#include <filesystem>
+#include <unordered_map>
 #include "OBJReader.h"
 #include "Mesh.h"
+#include "MappedFile.h"
+#include "MemoryStats.h"
 
 OBJReader::OBJReader()
 {
@@ -44,6 +51,9 @@ double OBJReader::ReadOBJFile(std::string filepath, Mesh* pMesh,
   else
     return rFlag;
 
+  // A library the mesh already had was resolved by the read that set it
+  const bool hadMaterialLibrary = !pMesh->GetMaterialLibrary().empty();
+
   auto startTime = std::chrono::high_resolution_clock::now();
 
   switch (r)
@@ -56,6 +66,18 @@ double OBJReader::ReadOBJFile(std::string filepath, Mesh* pMesh,
     rFlag = ReadOBJFile_BlockIO(filepath);
     break;
 
+  case OBJReader::ReadMethod::MEMORY_MAPPED:
+    rFlag = ReadOBJFile_MemoryMapped(filepath);
+    break;
+
+  case OBJReader::ReadMethod::PARALLEL:
+    rFlag = ReadOBJFile_Parallel(filepath);
+    break;
+
+  case OBJReader::ReadMethod::STREAMING:
+    rFlag = ReadOBJFile_Streaming(filepath);
+    break;
+
   default:
     std::cout << "Unknown value for OBJReader::ReadMethod in function ReadObjFile." << std::endl;
     std::cout << "Quitting ..." << std::endl;
@@ -63,6 +85,9 @@ double OBJReader::ReadOBJFile(std::string filepath, Mesh* pMesh,
     break;
   }
 
+  if (!hadMaterialLibrary)
+    ResolveMaterialLibrary(filepath, _currentMesh);
+
   auto endTime = std::chrono::high_resolution_clock::now();
 
   double timeDuration = std::chrono::duration< double, std::milli >(endTime -
@@ -76,216 +101,1059 @@ double OBJReader::ReadOBJFile(std::string filepath, Mesh* pMesh,
 /////////////////////////////////////////////
 int OBJReader::ReadOBJFile_LineByLine(std::string filepath)
 {
-  int rFlag = -1;
-  glm::vec3 min(FLT_MAX, FLT_MAX, FLT_MAX);
-  glm::vec3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+  std::ifstream inFile("res/models/" + filepath);
+  if (!inFile.is_open())
+    return -1;
+
+  // Each line goes through the same record parser and welding as the other
+  // readers, only the file access differs
+  OBJData data;
+  string line;
+  while (std::getline(inFile, line))
+    ParseOBJRecord(line.data(), line.data() + line.size(), data);
+  BuildMesh(data, _currentMesh);
+
+  return 0;
+}
 
-  std::ifstream  inFile;
-  inFile.open("res/models/" + filepath);
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+// Read the OBJ file in blocks -- works for files smaller than 1GB
+int OBJReader::ReadOBJFile_BlockIO(std::string filepath)
+{
+  const std::streamoff OneGBinBytes = 1024 * 1024 * 1024;
 
-  if (inFile.bad() || inFile.eof() || inFile.fail())
-    return rFlag;
+  std::ifstream inFile("res/models/" + filepath, std::ifstream::in | std::ifstream::binary);
+  if (!inFile.is_open())
+    return -1;
+
+  // get the file size
+  inFile.seekg(0, std::ifstream::end);
+  const std::streamoff count = inFile.tellg();
+  inFile.seekg(0, std::ifstream::beg);
+
+  if (count <= 0 || count >= OneGBinBytes)
+  {
+    std::cout << " Error reading file " << filepath << std::endl;
+    std::cout << "File size reported as : " << count << " bytes." << std::endl;
+    return -1;
+  }
+
+  vector<char> fileContents(static_cast<size_t>(count));
+  inFile.read(fileContents.data(), count);
+  const char* first = fileContents.data();
+  const char* last = first + inFile.gcount();
+
+  // Now parse the obj file where it lies in the buffer
+  OBJData data;
+  data.Reserve(CountOBJRecords(first, last));
+  ParseOBJBlock(first, last, data);
+  BuildMesh(data, _currentMesh);
+
+  return 0;
+}
+
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+// Map the OBJ file into memory and parse every record where it lies
+int OBJReader::ReadOBJFile_MemoryMapped(std::string filepath)
+{
+  MappedFile file;
+  if (!file.Open("res/models/" + filepath))
+    return -1;
+
+  OBJData data;
+  data.Reserve(CountOBJRecords(file.Begin(), file.End()));
+  ParseOBJBlock(file.Begin(), file.End(), data);
+  BuildMesh(data, _currentMesh);
+
+  return 0;
+}
+
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+// Map the OBJ file into memory and parse newline aligned chunks on all cores
+int OBJReader::ReadOBJFile_Parallel(std::string filepath)
+{
+  // Below this a chunk isn't worth the cost of a thread
+  constexpr size_t MinChunkSize = 256u * 1024u;
+
+  MappedFile file;
+  if (!file.Open("res/models/" + filepath))
+    return -1;
+
+  const size_t maxChunks = std::max<size_t>(1u, file.Size() / MinChunkSize);
+  const size_t chunkCount = std::min<size_t>(
+    std::max(1u, std::thread::hardware_concurrency()), maxChunks);
+
+  if (chunkCount == 1u)
+  {
+    OBJData data;
+    data.Reserve(CountOBJRecords(file.Begin(), file.End()));
+    ParseOBJBlock(file.Begin(), file.End(), data);
+    BuildMesh(data, _currentMesh);
+    return 0;
+  }
+
+  // Split the file into chunks that each start at the beginning of a record
+  vector<const char*> bounds(chunkCount + 1u);
+  bounds.front() = file.Begin();
+  bounds.back() = file.End();
+  for (size_t i = 1u; i < chunkCount; ++i)
+  {
+    const char* split = std::max(bounds[i - 1u], file.Begin() + file.Size() * i / chunkCount);
+    const char* eol = static_cast<const char*>(
+      memchr(split, '\n', static_cast<size_t>(file.End() - split)));
+    bounds[i] = eol ? eol + 1 : file.End();
+  }
 
-  while (!inFile.eof())
+  // Parse each chunk into its own thread-local streams
+  vector<OBJData> chunks(chunkCount);
   {
-    char buffer[256] = "\0";
-    inFile.getline(buffer, 256, '\n');
+    // The chunk streams are allocated on the workers, so their counts are
+    // handed back to this thread
+    vector<size_t> allocations(chunkCount, 0u);
+    vector<std::thread> workers;
+    workers.reserve(chunkCount);
+    for (size_t i = 0u; i < chunkCount; ++i)
+    {
+      workers.emplace_back([&, i]
+        {
+          const size_t allocationsBefore = MemoryStats::GetThreadAllocationCount();
+          chunks[i].Reserve(CountOBJRecords(bounds[i], bounds[i + 1u]));
+          ParseOBJBlock(bounds[i], bounds[i + 1u], chunks[i]);
+          allocations[i] = MemoryStats::GetThreadAllocationCount() - allocationsBefore;
+        });
+    }
+    for (std::thread& worker : workers)
+      worker.join();
+    for (const size_t workerAllocations : allocations)
+      MemoryStats::AddThreadAllocations(workerAllocations);
+  }
 
-    ParseOBJRecord(buffer, min, max);
+  // Prefix-sum the element counts to find where each chunk lands
+  struct Offsets { size_t Position, Texcoord, Normal, Corner; };
+  vector<Offsets> offsets(chunkCount + 1u, Offsets{ 0u, 0u, 0u, 0u });
+  for (size_t i = 0u; i < chunkCount; ++i)
+  {
+    offsets[i + 1u].Position = offsets[i].Position + chunks[i].Positions.size();
+    offsets[i + 1u].Texcoord = offsets[i].Texcoord + chunks[i].Texcoords.size();
+    offsets[i + 1u].Normal = offsets[i].Normal + chunks[i].Normals.size();
+    offsets[i + 1u].Corner = offsets[i].Corner + chunks[i].Corners.size();
   }
 
-  return rFlag;
+  OBJData data;
+  data.Positions.resize(offsets.back().Position);
+  for (size_t i = 0u; i < chunkCount; ++i)
+  {
+    // Switches are few, so they are merged in order here rather than on the workers
+    for (OBJData::MaterialSwitch& materialSwitch : chunks[i].MaterialSwitches)
+      data.MaterialSwitches.push_back(OBJData::MaterialSwitch{
+        materialSwitch.Triangle + offsets[i].Corner / 3u, std::move(materialSwitch.Name) });
+    data.SetMaterialLibrary(std::move(chunks[i].MaterialLibrary));
+  }
+  data.Texcoords.resize(offsets.back().Texcoord);
+  data.Normals.resize(offsets.back().Normal);
+  data.Corners.resize(offsets.back().Corner);
+
+  // Merge the chunks in parallel. Face indices are absolute, so only the ones
+  // that were relative to the end of a chunk's stream need that chunk's offset.
+  {
+    vector<std::thread> workers;
+    workers.reserve(chunkCount);
+    for (size_t i = 0u; i < chunkCount; ++i)
+    {
+      workers.emplace_back([&, i]
+        {
+          const OBJData& chunk = chunks[i];
+          const Offsets& offset = offsets[i];
+          std::copy(chunk.Positions.begin(), chunk.Positions.end(), data.Positions.begin() + offset.Position);
+          std::copy(chunk.Texcoords.begin(), chunk.Texcoords.end(), data.Texcoords.begin() + offset.Texcoord);
+          std::copy(chunk.Normals.begin(), chunk.Normals.end(), data.Normals.begin() + offset.Normal);
+
+          OBJData::Corner* corners = data.Corners.data() + offset.Corner;
+          std::copy(chunk.Corners.begin(), chunk.Corners.end(), corners);
+
+          // Relative indices were resolved against the chunk's own stream
+          // sizes, so the (modular) offset puts them back in file space
+          for (size_t c = 0u; c < chunk.Corners.size(); ++c)
+          {
+            OBJData::Corner& corner = corners[c];
+            if (corner.RelativeMask == 0u)
+              continue;
+            if (corner.RelativeMask & OBJData::RELATIVE_POSITION)
+              corner.Position += static_cast<GLuint>(offset.Position);
+            if (corner.RelativeMask & OBJData::RELATIVE_TEXCOORD)
+              corner.Texcoord += static_cast<GLuint>(offset.Texcoord);
+            if (corner.RelativeMask & OBJData::RELATIVE_NORMAL)
+              corner.Normal += static_cast<GLuint>(offset.Normal);
+          }
+        });
+    }
+    for (std::thread& worker : workers)
+      worker.join();
+  }
+
+  // Free the per-chunk streams before welding allocates the mesh
+  chunks.clear();
+  chunks.shrink_to_fit();
+
+  BuildMesh(data, _currentMesh);
+
+  return 0;
 }
 
 /////////////////////////////////////////////
 /////////////////////////////////////////////
 /////////////////////////////////////////////
-// Read the OBJ file in blocks -- works for files smaller than 1GB
-int OBJReader::ReadOBJFile_BlockIO(std::string filepath)
+template <typename Target>
+void OBJReader::ParseOBJBlock(const char* first, const char* last, Target& target)
 {
-  int rFlag = -1;
-  long int OneGBinBytes = 1024 * 1024 * 1024 * sizeof(char);
+  while (first < last)
+  {
+    const char* eol = static_cast<const char*>(
+      memchr(first, '\n', static_cast<size_t>(last - first)));
+    if (eol == nullptr)
+      eol = last;
 
-  glm::vec3 min(FLT_MAX, FLT_MAX, FLT_MAX);
-  glm::vec3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    ParseOBJRecord(first, eol, target);
 
+    first = eol + 1;
+  }
+}
 
-  // Check the file size, if > 1 GB, abort
-  std::ifstream inFile(filepath, std::ifstream::in | std::ifstream::binary);
+// Helpers for the in-place record parser. These never copy or terminate the
+// input and never consult the C locale.
+namespace
+{
+  inline bool isBlank(char c) noexcept
+  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+  }
 
-  if (inFile.bad() || inFile.eof())
-    return rFlag;
+  // Returns the first non-blank character in [first, last)
+  inline const char* skipBlanks(const char* first, const char* last) noexcept
+  {
+    while (first < last && isBlank(*first))
+      ++first;
+    return first;
+  }
 
-  char* fileContents = NULL;
-  long int count = 0;
+  // Returns one past the end of the token starting at first
+  inline const char* skipToken(const char* first, const char* last) noexcept
+  {
+    while (first < last && !isBlank(*first))
+      ++first;
+    return first;
+  }
 
-  // get the file size
-  inFile.seekg(0, std::ifstream::end);
-  count = static_cast<long>(inFile.tellg());
-  inFile.seekg(0, std::ifstream::beg);
+  // Returns the rest of the record without the blanks around it. Names may
+  // hold spaces, so they run to the end of the line.
+  inline std::string restOfRecord(const char* first, const char* last)
+  {
+    first = skipBlanks(first, last);
+    while (last > first && isBlank(last[-1]))
+      --last;
+    return std::string(first, last);
+  }
 
-  if (count <= 0 || count >= OneGBinBytes)
+  // Parses the next token as a float. Like atof, trailing junk after the
+  // number is ignored and an unreadable token yields 0.
+  // Returns one past the end of the token, or nullptr if there was no token.
+  inline const char* parseFloat(const char* first, const char* last, GLfloat& value) noexcept
   {
-    std::cout << " Error reading file " << filepath << std::endl;
-    std::cout << "File size reported as : " << count << " bytes." << std::endl;
+    first = skipBlanks(first, last);
+    if (first == last)
+      return nullptr;
+
+    const char* tokenEnd = skipToken(first, last);
+    // from_chars does not accept an explicit '+'
+    const char* numberStart = (*first == '+') ? first + 1 : first;
+    if (std::from_chars(numberStart, tokenEnd, value).ec != std::errc())
+      value = 0.f;
+
+    return tokenEnd;
   }
-  else if (count > 0)
+
+  // Parses one '/' separated field of a face token. An empty or unreadable
+  // field yields 0, which OBJ never uses as an index.
+  // Returns the position of the separator or the end of the token.
+  inline const char* parseIndexField(const char* first, const char* tokenEnd, long& index) noexcept
+  {
+    const char* fieldEnd = first;
+    while (fieldEnd < tokenEnd && *fieldEnd != '/')
+      ++fieldEnd;
+
+    const char* numberStart = (first < fieldEnd && *first == '+') ? first + 1 : first;
+    if (std::from_chars(numberStart, fieldEnd, index).ec != std::errc())
+      index = 0;
+
+    return fieldEnd;
+  }
+
+  // Converts a 1-based or negative (relative) OBJ index to a 0-based index
+  // into a stream that currently holds count elements
+  inline GLuint resolveIndex(long index, size_t count, bool& isRelative) noexcept
+  {
+    isRelative = index < 0;
+    if (index > 0)
+      return static_cast<GLuint>(index - 1);
+    if (index < 0)
+      return static_cast<GLuint>(static_cast<long>(count) + index);
+    return OBJReader::OBJData::NO_INDEX;
+  }
+
+  // Parses the next face token (v, v/vt, v//vn or v/vt/vn) into a corner.
+  // Returns one past the end of the token, or nullptr if there was no token.
+  template <typename Target>
+  inline const char* parseCorner(const char* first, const char* last,
+    const Target& target, OBJReader::OBJData::Corner& corner) noexcept
+  {
+    first = skipBlanks(first, last);
+    if (first == last)
+      return nullptr;
+
+    const char* tokenEnd = skipToken(first, last);
+    long position = 0, texcoord = 0, normal = 0;
+
+    const char* field = parseIndexField(first, tokenEnd, position);
+    if (field < tokenEnd)
+      field = parseIndexField(field + 1, tokenEnd, texcoord);
+    if (field < tokenEnd)
+      parseIndexField(field + 1, tokenEnd, normal);
+
+    bool isRelative = false;
+    corner.RelativeMask = 0u;
+    corner.Position = resolveIndex(position, target.PositionCount(), isRelative);
+    if (isRelative)
+      corner.RelativeMask |= OBJReader::OBJData::RELATIVE_POSITION;
+    corner.Texcoord = resolveIndex(texcoord, target.TexcoordCount(), isRelative);
+    if (isRelative)
+      corner.RelativeMask |= OBJReader::OBJData::RELATIVE_TEXCOORD;
+    corner.Normal = resolveIndex(normal, target.NormalCount(), isRelative);
+    if (isRelative)
+      corner.RelativeMask |= OBJReader::OBJData::RELATIVE_NORMAL;
+
+    return tokenEnd;
+  }
+
+  // Key of a welded vertex: the unique v/vt/vn combination
+  struct CornerKey
   {
-    const char* delims = "\n\r";
-    fileContents = (char*)malloc(sizeof(char) * (static_cast<size_t>(count) + 1));
-    assert(fileContents);
-    inFile.read(fileContents, count);
-    fileContents[count] = '\0';
+    GLuint Position, Texcoord, Normal;
 
-    rFlag = 0;
+    bool operator==(const CornerKey& rhs) const noexcept
+    {
+      return Position == rhs.Position && Texcoord == rhs.Texcoord && Normal == rhs.Normal;
+    }
+  };
 
-    // Now parse the obj file
-    char* currPtr = fileContents;
-    assert(currPtr);
-    char* token = strpbrk(currPtr, delims);
+  struct CornerKeyHash
+  {
+    size_t operator()(const CornerKey& key) const noexcept
+    {
+      uint64_t h = static_cast<uint64_t>(key.Position) * 0x9E3779B97F4A7C15ull;
+      h ^= static_cast<uint64_t>(key.Texcoord) * 0xC2B2AE3D27D4EB4Full;
+      h ^= static_cast<uint64_t>(key.Normal) * 0x165667B19E3779F9ull;
+      return static_cast<size_t>(h ^ (h >> 32));
+    }
+  };
+
+  // Open addressing map from a corner to its welded vertex. Unlike
+  // unordered_map it holds every entry in one flat array, so welding costs a
+  // handful of allocations instead of one per vertex.
+  class WeldTable
+  {
+  public:
+    explicit WeldTable(size_t expectedCount = 0u)
+    {
+      rehash(capacityFor(expectedCount));
+    }
 
-    while (token != nullptr)
+    // Returns the vertex of key, inserting vertex if the key is new
+    std::pair<GLuint, bool> Insert(const CornerKey& key, GLuint vertex)
     {
-      int numChars = static_cast<int>(token - currPtr);
-      char ObjLine[256];
-      assert(currPtr != nullptr);
-      strncpy_s(ObjLine, currPtr, numChars);
-      ObjLine[numChars] = '\0';
+      if (2u * (m_Count + 1u) > m_Slots.size())
+        rehash(2u * m_Slots.size());
 
-      ParseOBJRecord(ObjLine, min, max);
+      Slot& slot = find(key);
+      if (slot.Key.Position != EMPTY)
+        return { slot.Vertex, false };
 
-      currPtr = token + 1;
-      token = strpbrk(currPtr, delims);
+      slot.Key = key;
+      slot.Vertex = vertex;
+      ++m_Count;
+      return { vertex, true };
     }
 
-    free(fileContents);
-  }
+    size_t Size() const noexcept { return m_Count; }
+
+    // Calls visit(key, vertex) for every entry, in no particular order
+    template <typename Visitor>
+    void ForEach(Visitor visit) const
+    {
+      for (const Slot& slot : m_Slots)
+      {
+        if (slot.Key.Position != EMPTY)
+          visit(slot.Key, slot.Vertex);
+      }
+    }
+
+  private:
+    // No corner is stored with this position, resolved positions are always in range
+    static constexpr GLuint EMPTY = OBJReader::OBJData::NO_INDEX;
+
+    struct Slot
+    {
+      CornerKey Key;
+      GLuint Vertex;
+    };
+
+    vector<Slot> m_Slots;
+    size_t m_Count = 0u;
 
-  return rFlag;
+    // Power of two with room for count entries at half load
+    static size_t capacityFor(size_t count) noexcept
+    {
+      size_t capacity = 16u;
+      while (capacity < 2u * count)
+        capacity *= 2u;
+      return capacity;
+    }
+
+    Slot& find(const CornerKey& key)
+    {
+      const size_t mask = m_Slots.size() - 1u;
+      for (size_t i = CornerKeyHash()(key) & mask; ; i = (i + 1u) & mask)
+      {
+        Slot& slot = m_Slots[i];
+        if (slot.Key.Position == EMPTY || slot.Key == key)
+          return slot;
+      }
+    }
+
+    void rehash(size_t capacity)
+    {
+      vector<Slot> old(capacity, Slot{ { EMPTY, EMPTY, EMPTY }, 0u });
+      old.swap(m_Slots);
+      for (const Slot& slot : old)
+      {
+        if (slot.Key.Position != EMPTY)
+          find(slot.Key) = slot;
+      }
+    }
+  };
 }
 
 /////////////////////////////////////////////
 /////////////////////////////////////////////
 /////////////////////////////////////////////
-void OBJReader::ParseOBJRecord(char* buffer, glm::vec3& min, glm::vec3& max)
+OBJReader::OBJCounts OBJReader::CountOBJRecords(const char* first, const char* last)
 {
-  const char* delims = " \r\n\t";
-  GLfloat x, y, z;
+  OBJCounts counts;
+  while (first < last)
+  {
+    const char* eol = static_cast<const char*>(
+      memchr(first, '\n', static_cast<size_t>(last - first)));
+    if (eol == nullptr)
+      eol = last;
+
+    first = skipBlanks(first, eol);
+    const char* keyEnd = skipToken(first, eol);
+    const auto keyLength = keyEnd - first;
+
+    if (keyLength == 1 && first[0] == 'v')
+      ++counts.Positions;
+    else if (keyLength == 2 && first[0] == 'v' && first[1] == 't')
+      ++counts.Texcoords;
+    else if (keyLength == 2 && first[0] == 'v' && first[1] == 'n')
+      ++counts.Normals;
+    else if (keyLength == 1 && first[0] == 'f')
+    {
+      // A polygon of n corners is fanned into n - 2 triangles
+      size_t cornerCount = 0u;
+      for (const char* token = skipBlanks(keyEnd, eol); token < eol; token = skipBlanks(token, eol))
+      {
+        token = skipToken(token, eol);
+        ++cornerCount;
+      }
+      if (cornerCount >= 3u)
+        counts.Triangles += cornerCount - 2u;
+    }
+
+    first = eol + 1;
+  }
+  return counts;
+}
+
+// Collects the material of every triangle a mesh builder keeps and turns them
+// into submeshes once the mesh is built
+namespace
+{
+  class MaterialTracker
+  {
+  public:
+    // Every triangle from now on uses the material
+    void Use(const std::string& name)
+    {
+      const auto [entry, isNew] = m_Indices.try_emplace(name, static_cast<unsigned>(m_Names.size()));
+      if (isNew)
+        m_Names.push_back(name);
+      m_Current = entry->second;
+    }
 
-  GLfloat   temp;
-  GLuint    firstIndex, secondIndex, thirdIndex;
+    // Records the material of the next triangle
+    void AddTriangle()
+    {
+      // Most files never switch material, so nothing is stored until one does
+      if (m_Names.empty())
+        ++m_Pending;
+      else
+        m_Materials.push_back(m_Current);
+    }
 
-  char* token = NULL;
-  char* next_token = NULL;
-  token = strtok_s(buffer, delims, &next_token);
+    // Splits the triangles the file added after baseTriangle into submeshes.
+    // Triangles before the first 'usemtl' get a material with no name.
+    void Apply(Mesh& mesh, const size_t baseTriangle, const std::string& library)
+    {
+      if (!library.empty() && mesh.GetMaterialLibrary().empty())
+        mesh.SetMaterialLibrary(library);
+      if (m_Names.empty() && mesh.GetSubmeshCount() == 0u)
+        return;
+
+      // Triangles the mesh already had keep their submeshes
+      vector<string> names = mesh.GetMaterialNames();
+      vector<unsigned> materials(baseTriangle, Error::INVALID_INDEX);
+      for (unsigned s = 0u; s < mesh.GetSubmeshCount(); ++s)
+      {
+        const Mesh::Submesh& range = mesh.GetSubmeshes()[s];
+        std::fill(materials.begin() + range.FirstTriangle, materials.begin() + range.FirstTriangle + range.TriangleCount, s);
+      }
+      std::unordered_map<string, unsigned> indices;
+      for (unsigned m = 0u; m < names.size(); ++m)
+        indices.emplace(names[m], m);
+      auto indexOf = [&names, &indices](const string& name)
+      {
+        const auto [entry, isNew] = indices.try_emplace(name, static_cast<unsigned>(names.size()));
+        if (isNew)
+          names.push_back(name);
+        return entry->second;
+      };
+
+      const unsigned unnamed = indexOf(string());
+      for (unsigned& material : materials)
+      {
+        if (material == Error::INVALID_INDEX)
+          material = unnamed;
+      }
+      materials.insert(materials.end(), m_Pending, unnamed);
+      for (const unsigned material : m_Materials)
+        materials.push_back(indexOf(m_Names[material]));
+
+      mesh.SetSubmeshes(materials, std::move(names));
+    }
+
+  private:
+    std::unordered_map<std::string, unsigned> m_Indices; // Index of each name in m_Names
+    vector<std::string> m_Names;
+    vector<unsigned> m_Materials;   // Material of each triangle after the first switch
+    size_t m_Pending = 0u;          // Triangles before the first switch
+    unsigned m_Current = 0u;
+  };
+}
+
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+template <typename Target>
+void OBJReader::ParseOBJRecord(const char* first, const char* last, Target& target)
+{
+  first = skipBlanks(first, last);
 
   // account for empty lines
-  if (token == nullptr)
+  if (first == last)
     return;
 
-  bool foundNormals = false;
+  const char* keyEnd = skipToken(first, last);
+  const auto keyLength = keyEnd - first;
+  const char* currPtr = keyEnd;
+
+  // vertex coordinates
+  if (keyLength == 1 && first[0] == 'v')
+  {
+    glm::vec3 position(0.f);
+    for (int i = 0; i < 3; ++i)
+    {
+      if ((currPtr = parseFloat(currPtr, last, position[i])) == nullptr)
+        return;
+    }
+
+    target.AddPosition(position);
+  }
+  // texture coordinates, the optional w is ignored
+  else if (keyLength == 2 && first[0] == 'v' && first[1] == 't')
+  {
+    glm::vec2 texcoord(0.f);
+    if ((currPtr = parseFloat(currPtr, last, texcoord[0])) == nullptr)
+      return;
+    parseFloat(currPtr, last, texcoord[1]);
 
-  switch (token[0])
+    target.AddTexcoord(texcoord);
+  }
+  // vertex normals
+  else if (keyLength == 2 && first[0] == 'v' && first[1] == 'n')
   {
-  case 'v':
-    // vertex coordinates
-    if (token[1] == '\0')
+    glm::vec3 vNormal(0.f);
+    for (int i = 0; i < 3; ++i)
     {
-      token = strtok_s(nullptr, delims, &next_token);
-      temp = static_cast<GLfloat&&>(atof(token));
-      if (min.x > temp)
-        min.x = temp;
-      if (max.x <= temp)
-        max.x = temp;
-      x = temp;
-
-      token = strtok_s(nullptr, delims, &next_token);
-      temp = static_cast<GLfloat&&>(atof(token));
-      if (min.y > temp)
-        min.y = temp;
-      if (max.y <= temp)
-        max.y = temp;
-      y = temp;
-
-      token = strtok_s(nullptr, delims, &next_token);
-      temp = static_cast<GLfloat&&>(atof(token));
-      if (min.z > temp)
-        min.z = temp;
-      if (max.z <= temp)
-        max.z = temp;
-      z = temp;
-
-      _currentMesh->AddVertex(x, y, z);
+      if ((currPtr = parseFloat(currPtr, last, vNormal[i])) == nullptr)
+        return;
     }
-    // vertex normals
-    else if (token[1] == 'n')
+
+    target.AddNormal(glm::normalize(vNormal));
+  }
+  // faces, fan-triangulated
+  else if (keyLength == 1 && first[0] == 'f')
+  {
+    OBJData::Corner corner[3];
+    for (int i = 0; i < 3; ++i)
     {
-      foundNormals = true;
+      if ((currPtr = parseCorner(currPtr, last, target, corner[i])) == nullptr)
+        return;
+    }
+
+    // push back first triangle
+    target.AddTriangle(corner[0], corner[1], corner[2]);
+
+    corner[1] = corner[2];
+    while ((currPtr = parseCorner(currPtr, last, target, corner[2])) != nullptr)
+    {
+      target.AddTriangle(corner[0], corner[1], corner[2]);
+      corner[1] = corner[2];
+    }
+  }
+  // material for the faces that follow
+  else if (keyLength == 6 && memcmp(first, "usemtl", 6u) == 0)
+  {
+    target.UseMaterial(restOfRecord(currPtr, last));
+  }
+  // material library, only the first one is used
+  else if (keyLength == 6 && memcmp(first, "mtllib", 6u) == 0)
+  {
+    target.SetMaterialLibrary(restOfRecord(currPtr, last));
+  }
+  // 'o' and 'g' names and everything else are ignored, the submeshes follow
+  // the materials since those are what split the draws
+}
 
-      glm::vec3 vNormal(0.f);
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+void OBJReader::BuildMesh(const OBJData& data, Mesh* pMesh)
+{
+  Mesh& mesh = *pMesh;
+  const size_t positionCount = data.Positions.size();
+  const size_t cornerCount = data.Corners.size() - data.Corners.size() % 3u;
 
-      token = strtok_s(nullptr, delims, &next_token);
-      if (token == nullptr)
-        break;
+  bool usesTexcoords = false;
+  bool usesNormals = false;
+  for (size_t i = 0u; i < cornerCount; ++i)
+  {
+    usesTexcoords |= data.Corners[i].Texcoord < data.Texcoords.size();
+    usesNormals |= data.Corners[i].Normal < data.Normals.size();
+  }
 
-      vNormal[0] = static_cast<GLfloat&&>(atof(token));
+  const auto baseVertex = static_cast<GLuint>(mesh.m_PositionArray.size());
+  const size_t baseTriangle = mesh.m_TriangleArray.size();
+  mesh.m_MeshIsDirty = true;
 
-      token = strtok_s(nullptr, delims, &next_token);
-      if (token == nullptr)
-        break;
+  // Follows the material switches along the triangles, skipped ones included
+  MaterialTracker materials;
+  size_t nextSwitch = 0u;
+  auto useMaterials = [&](const size_t triangle)
+  {
+    for (; nextSwitch < data.MaterialSwitches.size() && data.MaterialSwitches[nextSwitch].Triangle <= triangle; ++nextSwitch)
+      materials.Use(data.MaterialSwitches[nextSwitch].Name);
+  };
 
-      vNormal[1] = static_cast<GLfloat&&>(atof(token));
+  // Position-only faces need no welding, the positions are the vertices
+  if (!usesTexcoords && !usesNormals)
+  {
+    mesh.Reserve(baseVertex + static_cast<unsigned>(positionCount),
+      static_cast<unsigned>(mesh.m_TriangleArray.size() + cornerCount / 3u), false);
+    mesh.m_PositionArray.insert(mesh.m_PositionArray.end(), data.Positions.begin(), data.Positions.end());
+    for (size_t i = 0u; i < cornerCount; i += 3u)
+    {
+      const OBJData::Corner* tri = &data.Corners[i];
+      if (tri[0].Position >= positionCount || tri[1].Position >= positionCount || tri[2].Position >= positionCount)
+        continue;
+
+      mesh.m_TriangleArray.emplace_back(
+        baseVertex + tri[0].Position, baseVertex + tri[1].Position, baseVertex + tri[2].Position);
+      useMaterials(i / 3u);
+      materials.AddTriangle();
+    }
+    materials.Apply(mesh, baseTriangle, data.MaterialLibrary);
+    return;
+  }
+
+  // Every unique v/vt/vn combination becomes one output vertex. The first pass
+  // only assigns indices so the vertex arrays can be sized exactly once.
+  WeldTable welded(positionCount + positionCount / 2u);
 
-      token = strtok_s(nullptr, delims, &next_token);
-      if (token == nullptr)
-        break;
+  mesh.m_TriangleArray.reserve(mesh.m_TriangleArray.size() + cornerCount / 3u);
+  GLuint nextVertex = baseVertex;
 
-      vNormal[2] = static_cast<GLfloat&&>(atof(token));
+  for (size_t i = 0u; i < cornerCount; i += 3u)
+  {
+    const OBJData::Corner* tri = &data.Corners[i];
+    if (tri[0].Position >= positionCount || tri[1].Position >= positionCount || tri[2].Position >= positionCount)
+      continue;
 
-      _currentMesh->AddVertexNormal(glm::normalize(vNormal));
+    GLuint index[3];
+    for (size_t c = 0u; c < 3u; ++c)
+    {
+      const CornerKey key{
+        tri[c].Position,
+        tri[c].Texcoord < data.Texcoords.size() ? tri[c].Texcoord : OBJData::NO_INDEX,
+        tri[c].Normal < data.Normals.size() ? tri[c].Normal : OBJData::NO_INDEX };
+
+      const auto [vertex, isNew] = welded.Insert(key, nextVertex);
+      if (isNew)
+        ++nextVertex;
+      index[c] = vertex;
     }
 
-    break;
+    mesh.m_TriangleArray.emplace_back(index[0], index[1], index[2]);
+    useMaterials(i / 3u);
+    materials.AddTriangle();
+  }
 
-  case 'f':
-    token = strtok_s(nullptr, delims, &next_token);
-    if (token == nullptr)
-      break;
-    firstIndex = static_cast<unsigned int&&>(atoi(token) - 1);
+  mesh.Reserve(nextVertex, static_cast<unsigned>(mesh.m_TriangleArray.size()));
+  mesh.m_PositionArray.resize(nextVertex);
+  mesh.m_VertexNormalArray.resize(nextVertex, glm::vec3(0.f));
+  mesh.m_TexcoordArray.resize(nextVertex, glm::vec2(0.f));
 
-    token = strtok_s(nullptr, delims, &next_token);
-    if (token == nullptr)
-      break;
-    secondIndex = static_cast<unsigned int&&>(atoi(token) - 1);
+  bool allTexcoords = true;
+  bool allNormals = true;
 
-    token = strtok_s(nullptr, delims, &next_token);
-    if (token == nullptr)
-      break;
-    thirdIndex = static_cast<unsigned int&&>(atoi(token) - 1);
+  welded.ForEach([&](const CornerKey& key, GLuint vertex)
+    {
+      mesh.m_PositionArray[vertex] = data.Positions[key.Position];
+      if (key.Texcoord != OBJData::NO_INDEX)
+        mesh.m_TexcoordArray[vertex] = data.Texcoords[key.Texcoord];
+      else
+        allTexcoords = false;
+      if (key.Normal != OBJData::NO_INDEX)
+        mesh.m_VertexNormalArray[vertex] = data.Normals[key.Normal];
+      else
+        allNormals = false;
+    });
+
+  // Partially specified attributes are regenerated for the whole mesh
+  mesh.SetNormalsAreCalculated(allNormals && usesNormals);
+  mesh.SetTexcoordsAreImported(allTexcoords && usesTexcoords);
+
+  materials.Apply(mesh, baseTriangle, data.MaterialLibrary);
+}
 
-    // push back first triangle
-    _currentMesh->AddTriangle(firstIndex, secondIndex, thirdIndex);
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+void OBJReader::ResolveMaterialLibrary(const std::string& filepath, Mesh* pMesh)
+{
+  const std::string& library = pMesh->GetMaterialLibrary();
+  if (library.empty())
+    return;
+
+  pMesh->SetMaterialLibrary((std::filesystem::path(filepath).parent_path() / library).generic_string());
+}
+
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+// Record sink that builds the mesh as the file streams past. Faces may only
+// reference records that came before them, so each corner is welded as soon
+// as it is parsed and no face corners are ever stored.
+class OBJReader::StreamBuilder
+{
+public:
+  StreamBuilder(Mesh& mesh, const OBJCounts& counts) :
+    m_Mesh(mesh),
+    m_Counts(counts),
+    m_BaseVertex(static_cast<GLuint>(mesh.m_PositionArray.size())),
+    m_BaseTriangle(mesh.m_TriangleArray.size()),
+    m_IsWelding(false),
+    m_AllTexcoords(true),
+    m_AllNormals(true)
+  {
+    m_Mesh.m_MeshIsDirty = true;
+    // Until a face needs welding the positions are the vertices
+    m_Mesh.Reserve(m_BaseVertex + static_cast<unsigned>(counts.Positions),
+      static_cast<unsigned>(m_BaseTriangle + counts.Triangles), false);
+    m_Texcoords.reserve(counts.Texcoords);
+    m_Normals.reserve(counts.Normals);
+  }
 
-    token = strtok_s(nullptr, delims, &next_token);
+  size_t PositionCount() const noexcept
+  {
+    return m_IsWelding ? m_Positions.size() : m_Mesh.m_PositionArray.size() - m_BaseVertex;
+  }
+  size_t TexcoordCount() const noexcept { return m_Texcoords.size(); }
+  size_t NormalCount() const noexcept { return m_Normals.size(); }
 
-    while (token != nullptr)
+  void AddPosition(const glm::vec3& position)
+  {
+    // Until a face needs welding the positions are the vertices
+    if (!m_IsWelding)
     {
-      secondIndex = thirdIndex;
-      thirdIndex = static_cast<unsigned int&&>(atoi(token) - 1);
+      m_Mesh.m_PositionArray.push_back(position);
+      return;
+    }
+    m_Positions.push_back(position);
+    m_PositionRemap.push_back(OBJData::NO_INDEX);
+  }
 
-      _currentMesh->AddTriangle(firstIndex, secondIndex, thirdIndex);
+  void AddTexcoord(const glm::vec2& texcoord) { m_Texcoords.push_back(texcoord); }
+  void AddNormal(const glm::vec3& normal) { m_Normals.push_back(normal); }
+  void UseMaterial(const std::string& name) { m_Materials.Use(name); }
+  void SetMaterialLibrary(std::string library)
+  {
+    if (m_MaterialLibrary.empty())
+      m_MaterialLibrary = std::move(library);
+  }
 
-      token = strtok_s(nullptr, delims, &next_token);
+  void AddTriangle(const OBJData::Corner& c0, const OBJData::Corner& c1, const OBJData::Corner& c2)
+  {
+    const size_t positionCount = PositionCount();
+    if (c0.Position >= positionCount || c1.Position >= positionCount || c2.Position >= positionCount)
+      return;
+
+    m_Materials.AddTriangle();
+    if (!m_IsWelding)
+    {
+      if (!hasAttributes(c0) && !hasAttributes(c1) && !hasAttributes(c2))
+      {
+        m_Mesh.m_TriangleArray.emplace_back(
+          m_BaseVertex + c0.Position, m_BaseVertex + c1.Position, m_BaseVertex + c2.Position);
+        return;
+      }
+      startWelding();
     }
 
-    break;
+    // Weld in corner order, argument evaluation order is unspecified
+    const GLuint i0 = weld(c0);
+    const GLuint i1 = weld(c1);
+    const GLuint i2 = weld(c2);
+    m_Mesh.m_TriangleArray.emplace_back(i0, i1, i2);
+  }
 
-  case '#':
-  default:
-    break;
+  // Releases the raw streams, flags which attributes were imported and splits the submeshes
+  void Finish()
+  {
+    m_Materials.Apply(m_Mesh, m_BaseTriangle, m_MaterialLibrary);
+    if (!m_IsWelding)
+      return;
+
+    const bool usesTexcoords = !m_Texcoords.empty();
+    const bool usesNormals = !m_Normals.empty();
+    vector<glm::vec3>().swap(m_Positions);
+    vector<glm::vec2>().swap(m_Texcoords);
+    vector<glm::vec3>().swap(m_Normals);
+    vector<GLuint>().swap(m_PositionRemap);
+    m_Welded = WeldTable();
+
+    // Partially specified attributes are regenerated for the whole mesh
+    m_Mesh.SetNormalsAreCalculated(m_AllNormals && usesNormals);
+    m_Mesh.SetTexcoordsAreImported(m_AllTexcoords && usesTexcoords);
+  }
+
+private:
+  Mesh& m_Mesh;
+  const OBJCounts m_Counts;       // Records in the whole file, from the counting pass
+  const GLuint m_BaseVertex;      // First vertex of the mesh that this file adds
+  const size_t m_BaseTriangle;    // First triangle of the mesh that this file adds
+  bool m_IsWelding;
+  bool m_AllTexcoords;
+  bool m_AllNormals;
+  MaterialTracker m_Materials;    // Material of each triangle added
+  std::string m_MaterialLibrary;
+
+  // Raw streams, only kept once faces reference vt or vn
+  vector<glm::vec3> m_Positions;
+  vector<glm::vec2> m_Texcoords;
+  vector<glm::vec3> m_Normals;
+  vector<GLuint> m_PositionRemap; // Output vertex of each position-only corner
+  WeldTable m_Welded;
+
+  bool hasAttributes(const OBJData::Corner& corner) const noexcept
+  {
+    return corner.Texcoord < m_Texcoords.size() || corner.Normal < m_Normals.size();
+  }
+
+  // Moves the positions read so far out of the mesh into the raw stream
+  void startWelding()
+  {
+    m_IsWelding = true;
+
+    vector<glm::vec3>& meshPositions = m_Mesh.m_PositionArray;
+    m_Positions.reserve(m_Counts.Positions);
+    m_Positions.assign(meshPositions.begin() + m_BaseVertex, meshPositions.end());
+    m_PositionRemap.reserve(m_Counts.Positions);
+    m_PositionRemap.assign(m_Positions.size(), OBJData::NO_INDEX);
+    m_Welded = WeldTable(m_Counts.Positions + m_Counts.Positions / 2u);
+
+    if (m_Mesh.m_TriangleArray.size() == m_BaseTriangle)
+    {
+      // Usual case: all faces reference attributes, start from an empty output
+      meshPositions.resize(m_BaseVertex);
+    }
+    else
+    {
+      // Earlier position-only faces keep indexing the positions in place
+      for (size_t i = 0u; i < m_PositionRemap.size(); ++i)
+        m_PositionRemap[i] = m_BaseVertex + static_cast<GLuint>(i);
+      m_AllTexcoords = false;
+      m_AllNormals = false;
+    }
+
+    // Welded vertices usually match the positions one to one, so the output
+    // keeps the capacity reserved for them
+    m_Mesh.Reserve(static_cast<unsigned>(meshPositions.capacity()),
+      static_cast<unsigned>(m_Mesh.m_TriangleArray.capacity()));
+    m_Mesh.m_VertexNormalArray.resize(meshPositions.size(), glm::vec3(0.f));
+    m_Mesh.m_TexcoordArray.resize(meshPositions.size(), glm::vec2(0.f));
+  }
+
+  // Returns the output vertex of a v/vt/vn combination, adding it if new
+  GLuint weld(const OBJData::Corner& corner)
+  {
+    const bool hasTexcoord = corner.Texcoord < m_Texcoords.size();
+    const bool hasNormal = corner.Normal < m_Normals.size();
+    const auto next = static_cast<GLuint>(m_Mesh.m_PositionArray.size());
+
+    if (!hasTexcoord && !hasNormal)
+    {
+      GLuint& index = m_PositionRemap[corner.Position];
+      if (index == OBJData::NO_INDEX)
+      {
+        index = next;
+        addVertex(corner, false, false);
+      }
+      return index;
+    }
+
+    const CornerKey key{
+      corner.Position,
+      hasTexcoord ? corner.Texcoord : OBJData::NO_INDEX,
+      hasNormal ? corner.Normal : OBJData::NO_INDEX };
+    const auto [vertex, isNew] = m_Welded.Insert(key, next);
+    if (isNew)
+      addVertex(corner, hasTexcoord, hasNormal);
+    return vertex;
+  }
+
+  void addVertex(const OBJData::Corner& corner, bool hasTexcoord, bool hasNormal)
+  {
+    m_Mesh.m_PositionArray.push_back(m_Positions[corner.Position]);
+    m_Mesh.m_TexcoordArray.push_back(hasTexcoord ? m_Texcoords[corner.Texcoord] : glm::vec2(0.f));
+    m_Mesh.m_VertexNormalArray.push_back(hasNormal ? m_Normals[corner.Normal] : glm::vec3(0.f));
+    m_AllTexcoords &= hasTexcoord;
+    m_AllNormals &= hasNormal;
+  }
+};
+
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+// Stream the OBJ file twice through the fixed size window: once to count the
+// records so the mesh is allocated exactly once, then to weld them into it
+int OBJReader::ReadOBJFile_Streaming(std::string filepath)
+{
+  OBJCounts counts;
+  const int rFlag = StreamOBJBlocks(filepath, [&counts](const char* first, const char* last)
+    {
+      counts += CountOBJRecords(first, last);
+    });
+  if (rFlag != 0)
+    return rFlag;
+
+  StreamBuilder builder(*_currentMesh, counts);
+  StreamOBJBlocks(filepath, [&builder](const char* first, const char* last)
+    {
+      ParseOBJBlock(first, last, builder);
+    });
+  builder.Finish();
+
+  return 0;
+}
+
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+/////////////////////////////////////////////
+// Read through two fixed size windows. One window is filled by a background
+// read while the other is handed out, and the partial record at the end of
+// each window is carried over to the next.
+int OBJReader::StreamOBJBlocks(const std::string& filepath,
+  const std::function<void(const char*, const char*)>& onBlock)
+{
+  constexpr size_t WindowSize = 4u * 1024u * 1024u;
+
+  std::ifstream inFile("res/models/" + filepath, std::ifstream::in | std::ifstream::binary);
+  if (!inFile.is_open())
+    return -1;
+
+  vector<char> windows[2] = { vector<char>(WindowSize), vector<char>(WindowSize) };
+  auto readWindow = [&inFile, &windows](size_t w)
+  {
+    inFile.read(windows[w].data(), static_cast<std::streamsize>(WindowSize));
+    return static_cast<size_t>(inFile.gcount());
+  };
+
+  // Record that started in a previous window, grows to fit any line length
+  string carry;
+
+  size_t current = 0u;
+  std::future<size_t> pending = std::async(std::launch::async, readWindow, current);
+  for (size_t bytes = pending.get(); bytes > 0u; bytes = pending.get())
+  {
+    // Only one read is ever in flight, so the stream is never shared
+    pending = std::async(std::launch::async, readWindow, current ^ 1u);
+
+    const char* first = windows[current].data();
+    const char* last = first + bytes;
+    current ^= 1u;
+
+    // Finish the record that crossed into this window
+    if (!carry.empty())
+    {
+      const char* eol = static_cast<const char*>(memchr(first, '\n', bytes));
+      if (eol == nullptr)
+      {
+        carry.append(first, last);
+        continue;
+      }
+      carry.append(first, eol);
+      onBlock(carry.data(), carry.data() + carry.size());
+      carry.clear();
+      first = eol + 1;
+    }
+
+    // Hand out the complete records and hold back the partial one at the end
+    const char* blockEnd = last;
+    while (blockEnd > first && blockEnd[-1] != '\n')
+      --blockEnd;
+    if (blockEnd > first)
+      onBlock(first, blockEnd);
+    carry.assign(blockEnd, last);
   }
 
-  _currentMesh->SetNormalsAreCalculated(foundNormals);
+  // The file may not end with a newline
+  if (!carry.empty())
+    onBlock(carry.data(), carry.data() + carry.size());
 
-  return;
+  return 0;
 }
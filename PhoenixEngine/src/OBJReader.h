@@ -8,6 +8,7 @@
 #include <string>
 #include <fstream>
 #include <vector>
+#include <functional>
 
 // for OpenGL datatypes
 #include <GLEW/glew.h>
@@ -25,23 +26,144 @@ public:
   // initialize the data
   void initData();
 
+  // Number of records of each kind in a block of OBJ text
+  struct OBJCounts
+  {
+    size_t Positions = 0u;    // 'v' records
+    size_t Texcoords = 0u;    // 'vt' records
+    size_t Normals = 0u;      // 'vn' records
+    size_t Triangles = 0u;    // Triangles of the fan-triangulated 'f' records
+
+    OBJCounts& operator+=(const OBJCounts& rhs) noexcept
+    {
+      Positions += rhs.Positions;
+      Texcoords += rhs.Texcoords;
+      Normals += rhs.Normals;
+      Triangles += rhs.Triangles;
+      return *this;
+    }
+  };
+
+  // Raw OBJ attribute streams and face corners, before vertices are welded
+  struct OBJData
+  {
+    static constexpr GLuint NO_INDEX = 0xFFFFFFFFu;
+
+    // Attribute bits of Corner::RelativeMask
+    static constexpr unsigned char RELATIVE_POSITION = 1u << 0;
+    static constexpr unsigned char RELATIVE_TEXCOORD = 1u << 1;
+    static constexpr unsigned char RELATIVE_NORMAL = 1u << 2;
+
+    // One v/vt/vn corner of a face, as 0-based indices into the raw streams
+    struct Corner
+    {
+      GLuint Position;            // Index into Positions
+      GLuint Texcoord;            // Index into Texcoords, or NO_INDEX
+      GLuint Normal;              // Index into Normals, or NO_INDEX
+      unsigned char RelativeMask; // Indices that were relative to the end of their stream
+    };
+
+    std::vector<glm::vec3> Positions;   // 'v' records
+    std::vector<glm::vec2> Texcoords;   // 'vt' records
+    std::vector<glm::vec3> Normals;     // 'vn' records
+    std::vector<Corner> Corners;        // Three per (fan-triangulated) face triangle
+
+    // A 'usemtl' record, the material of every triangle from Triangle onwards
+    struct MaterialSwitch
+    {
+      size_t Triangle;    // First triangle of Corners it applies to
+      std::string Name;   // Material name in the library
+    };
+
+    std::vector<MaterialSwitch> MaterialSwitches; // 'usemtl' records, in file order
+    std::string MaterialLibrary;                  // First 'mtllib' record, relative to the OBJ file
+
+    // Allocate every stream once for the records that will be parsed into it
+    void Reserve(const OBJCounts& counts)
+    {
+      Positions.reserve(Positions.size() + counts.Positions);
+      Texcoords.reserve(Texcoords.size() + counts.Texcoords);
+      Normals.reserve(Normals.size() + counts.Normals);
+      Corners.reserve(Corners.size() + 3u * counts.Triangles);
+    }
+
+    // Record sink used by ParseOBJRecord
+    size_t PositionCount() const noexcept { return Positions.size(); }
+    size_t TexcoordCount() const noexcept { return Texcoords.size(); }
+    size_t NormalCount() const noexcept { return Normals.size(); }
+    void AddPosition(const glm::vec3& position) { Positions.push_back(position); }
+    void AddTexcoord(const glm::vec2& texcoord) { Texcoords.push_back(texcoord); }
+    void AddNormal(const glm::vec3& normal) { Normals.push_back(normal); }
+    void AddTriangle(const Corner& c0, const Corner& c1, const Corner& c2)
+    {
+      Corners.push_back(c0);
+      Corners.push_back(c1);
+      Corners.push_back(c2);
+    }
+    void UseMaterial(std::string name) { MaterialSwitches.push_back(MaterialSwitch{ Corners.size() / 3u, std::move(name) }); }
+    void SetMaterialLibrary(std::string library)
+    {
+      if (MaterialLibrary.empty())
+        MaterialLibrary = std::move(library);
+    }
+  };
+
   // Read data from a file
-  enum class ReadMethod { LINE_BY_LINE, BLOCK_IO };
+  enum class ReadMethod { LINE_BY_LINE, BLOCK_IO, MEMORY_MAPPED, PARALLEL, STREAMING };
   double ReadOBJFile(std::string filepath,
     Mesh* pMesh,
-    ReadMethod r = ReadMethod::LINE_BY_LINE,
+    ReadMethod r = ReadMethod::MEMORY_MAPPED,
     GLboolean bFlipNormals = false);
 
 private:
 
-  // Read OBJ file line by line
+  // Read OBJ file line by line through the in-place record parser
   int ReadOBJFile_LineByLine(std::string filepath);
 
-  // Read the OBJ file in blocks -- works for files smaller than 1GB
+  // Read the OBJ file in one block and parse it in place -- works for files
+  // smaller than 1GB
   int ReadOBJFile_BlockIO(std::string filepath);
 
-  // Parse individual OBJ record (one line delimited by '\n')
-  void ParseOBJRecord(char* buffer, glm::vec3& min, glm::vec3& max);
+  // Read the OBJ file through a memory mapped view, parsing records in place
+  int ReadOBJFile_MemoryMapped(std::string filepath);
+
+  // Read the OBJ file through a memory mapped view, split into newline aligned
+  // chunks that are parsed concurrently and merged into the mesh
+  int ReadOBJFile_Parallel(std::string filepath);
+
+  // Read the OBJ file through a fixed size double buffered window, welding
+  // records into the mesh as they arrive -- memory use is bounded by the
+  // output mesh rather than the file size
+  int ReadOBJFile_Streaming(std::string filepath);
+
+  // Feed the file through the fixed size window, calling onBlock for runs of
+  // complete records in file order
+  static int StreamOBJBlocks(const std::string& filepath,
+    const std::function<void(const char*, const char*)>& onBlock);
+
+  // Count the records in [first, last) without parsing their values, so the
+  // streams can be allocated exactly once before they are filled
+  static OBJCounts CountOBJRecords(const char* first, const char* last);
+
+  // Parse individual OBJ record in place from [first, last) without copying.
+  // Target is OBJData or StreamBuilder.
+  template <typename Target>
+  static void ParseOBJRecord(const char* first, const char* last, Target& target);
+
+  // Parse every record in [first, last) in place
+  template <typename Target>
+  static void ParseOBJBlock(const char* first, const char* last, Target& target);
+
+  // Welds records straight into a mesh while they are being parsed
+  class StreamBuilder;
+
+  // Weld the v/vt/vn corners into unique mesh vertices and one index buffer,
+  // with a submesh per material
+  static void BuildMesh(const OBJData& data, Mesh* pMesh);
+
+  // Put the material library next to the OBJ file, as 'mtllib' paths are
+  // relative to the file that names them
+  static void ResolveMaterialLibrary(const std::string& filepath, Mesh* pMesh);
 
   // data members
   Mesh* _currentMesh;
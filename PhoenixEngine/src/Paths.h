@@ -3,4 +3,6 @@
 namespace Paths
 {
   static const char* SHADER_PATH = "res/shaders/";
+  static const char* MODEL_PATH = "res/models/";
+  static const char* MESH_CACHE_PATH = "res/cache/";
 }
\ No newline at end of file
@@ -37,6 +37,9 @@ Renderer::Renderer(bool depthBufferEnabled, bool backFaceCullEnabled) noexcept :
 
   LoadContexts();
 
+  // Nothing reads the CPU side arrays after the upload, the debug normals reload them when drawn
+  m_MeshManager.SetDefaultResidency(MeshManager::Residency::BOUNDS);
+
   Log::Trace("Renderer initialized.");
 }
 
@@ -135,6 +138,9 @@ void Renderer::OnEndFrame() noexcept
 
 void Renderer::RenderScene(vector<GameObject>& gameObjects, Camera& activeCamera)
 {
+  // Send any meshes the loader threads have finished to the GPU
+  m_MeshManager.ProcessUploads();
+
   //RenderFirstPass(gameObjects);
 
   RenderSecondPass(gameObjects, activeCamera);
@@ -198,6 +204,10 @@ void Renderer::RenderScene(vector<GameObject>& gameObjects, Camera& activeCamera
 #endif
 
 #pragma endregion
+
+  // Every object in the scene has claimed its mesh by now, so anything left
+  // unreferenced (e.g. by the previous scene) can go
+  m_MeshManager.ReleaseUnusedMeshes();
 }
 
 void Renderer::RenderFirstPass(vector<GameObject>& gameObjects)
@@ -287,7 +297,7 @@ void Renderer::RenderFirstPass(vector<GameObject>& gameObjects)
       glUniform1f(uniforms[8].ID, globalLighting.AttLinear);
       glUniform1f(uniforms[9].ID, globalLighting.AttQuadratic);
 
-      RenderGameObject(go);
+      RenderGameObject(go, activeCamera);
     }
 
     const vector<ContextManager::UniformAttribute>& uniforms = m_ContextManager.GetCurrentUniformAttributes();
@@ -340,7 +350,7 @@ void Renderer::RenderSecondPass(vector<GameObject>& gameObjects, Camera& activeC
     glUniform1f(uniforms[x++].ID, globalLighting.AttLinear);
     glUniform1f(uniforms[x++].ID, globalLighting.AttQuadratic);
 
-    RenderGameObject(go);
+    RenderGameObject(go, activeCamera);
   }
 
   //TODO: Don't render this first, and don't render it here
@@ -368,36 +378,42 @@ void Renderer::RenderSkybox(Camera& activeCamera)
   // Set View Matrix
   glUniformMatrix4fv(uniforms[1].ID, 1, GL_FALSE, &view[0][0]);
 
-  m_MeshManager.RenderMesh(SkyboxMeshID);
+  // Meshes can be rebuilt from the debug menu, which invalidates the handle
+  if (!m_MeshManager.IsValid(SkyboxMesh))
+  {
+    SkyboxMesh = m_MeshManager.LoadMesh("cube2.obj");
+    m_MeshManager.GetRegistry()->AddReference(SkyboxMesh);
+  }
+  m_MeshManager.RenderMesh(SkyboxMesh);
 
   glDepthFunc(GL_LESS);
   //glDepthMask(GL_TRUE);
 }
 
-void Renderer::RenderGameObject(GameObject& gameObject)
+void Renderer::RenderGameObject(GameObject& gameObject, Camera& activeCamera)
 {
   const auto meshComp = gameObject.GetFirstComponentByType(Component::Type::MESH);
   if (!meshComp.has_value())
     return;
   const shared_ptr<MeshComponent> meshCompPtr = dynamic_pointer_cast<MeshComponent>(meshComp.value());
-  unsigned MeshID = meshCompPtr->GetMeshID();
 
-  if (gameObject.m_bIsDirty)
+  // No mesh yet, or it was unloaded, look it up by file name
+  if (!m_MeshManager.IsValid(meshCompPtr->GetMeshHandle()))
   {
-    // Unknown Mesh ID, check for new id with file name
-    if (meshCompPtr->GetMeshID() == Error::INVALID_INDEX)
+    const string& meshFile = meshCompPtr->GetMeshFileName();
+    // No live context reads tangents yet, so the stream isn't generated
+    const MeshHandle handle = m_MeshManager.LoadMesh(meshFile, true, true, ImGui::GraphicsSelectedProjection, true, true, true, true, true, false);
+    if (!m_MeshManager.IsValid(handle))
     {
-      const string& meshFile = meshCompPtr->GetMeshFileName();
-      meshCompPtr->SetMeshID(m_MeshManager.LoadMesh(meshFile, true, true, ImGui::GraphicsSelectedProjection));
-      if (meshCompPtr->GetMeshID() == Error::INVALID_INDEX)
-      {
-        Log::Error("Could not load mesh: " + meshFile);
-        return;
-      }
-      MeshID = meshCompPtr->GetMeshID();
+      Log::Error("Could not load mesh: " + meshFile);
+      return;
     }
+    meshCompPtr->SetMesh(m_MeshManager.GetRegistry(), handle);
   }
 
+  // Only contexts whose shaders read tangents get the tangent stream
+  m_MeshManager.SetBindTangents(m_ContextManager.CurrentContextReadsTangents());
+
   const vector<ContextManager::UniformAttribute>& uniforms = m_ContextManager.GetCurrentUniformAttributes();
 
   int x = 9;
@@ -409,18 +425,64 @@ void Renderer::RenderGameObject(GameObject& gameObject)
     meshCompPtr->GetMaterial() :
     ImGui::LightingGlobalMaterial;
 
-  // Mat emissive
-  glUniform3fv(uniforms[x++].ID, 1, &mat.GetEmissive()[0]);
-  // Mat ambient
-  glUniform1f(uniforms[x++].ID, mat.GetAmbient());
-  // Mat diffuse
-  glUniform1f(uniforms[x++].ID, mat.GetDiffuse());
-  // Mat spec
-  glUniform1f(uniforms[x++].ID, mat.GetSpecular());
-  // Mat spec exp
-  glUniform1f(uniforms[x++].ID, mat.GetSpecularExp());
-
-  m_MeshManager.RenderMesh(MeshID);
+  const int materialUniform = x;
+  const auto setMaterial = [&uniforms, materialUniform](const Material& material)
+  {
+    int u = materialUniform;
+    // Mat emissive
+    glUniform3fv(uniforms[u++].ID, 1, &material.GetEmissive()[0]);
+    // Mat ambient
+    glUniform1f(uniforms[u++].ID, material.GetAmbient());
+    // Mat diffuse
+    glUniform1f(uniforms[u++].ID, material.GetDiffuse());
+    // Mat spec
+    glUniform1f(uniforms[u++].ID, material.GetSpecular());
+    // Mat spec exp
+    glUniform1f(uniforms[u++].ID, material.GetSpecularExp());
+  };
+  setMaterial(mat);
+  x += 5;
+
+  // Packed positions are scaled back across the mesh bounds
+  vec3 positionOffset, positionScale;
+  m_MeshManager.GetPositionDequantization(meshCompPtr->GetMeshHandle(), positionOffset, positionScale);
+  glUniform3fv(uniforms[x++].ID, 1, &positionOffset[0]);
+  glUniform3fv(uniforms[x++].ID, 1, &positionScale[0]);
+
+  // Coarser levels of detail as the mesh gets smaller on screen
+  const Camera::ViewData& viewData = activeCamera.GetViewData();
+  const float projectionScale = static_cast<float>(activeCamera.GetViewport().H) /
+    (2.f * tanf(glm::radians(viewData.FOV) * 0.5f));
+  const unsigned lod = m_MeshManager.SelectLevelOfDetail(
+    meshCompPtr->GetMeshHandle(), gameObject.GetMatrix(), activeCamera.GetPosition(), projectionScale);
+
+  // Meshes split by material draw each submesh with the component's override,
+  // else the material library's, else the component's own material
+  const MeshHandle& handle = meshCompPtr->GetMeshHandle();
+  MeshManager::SubmeshCallback onSubmesh = nullptr;
+  if (m_MeshManager.GetSubmeshCount(handle) > 0u)
+  {
+    onSubmesh = [&](const unsigned submesh)
+    {
+      if (const Material* material = meshCompPtr->GetSubmeshMaterial(submesh))
+        setMaterial(material->GetType() != Material::Type::GLOBAL ? *material : ImGui::LightingGlobalMaterial);
+      else if (const Material* library = m_MeshManager.GetSubmeshMaterial(handle, submesh))
+        setMaterial(*library);
+      else
+        setMaterial(mat);
+    };
+  }
+
+  // Full detail is drawn cluster by cluster, skipping what can't be seen
+  if (lod == 0u)
+  {
+    m_MeshManager.RenderMeshlets(handle, gameObject.GetMatrix(), activeCamera.GetVPMatrix(),
+      activeCamera.GetPosition(), BackFaceCullIsEnabled(), onSubmesh);
+  }
+  else
+  {
+    m_MeshManager.RenderMesh(handle, lod, onSubmesh);
+  }
 }
 
 #pragma region ImGui
@@ -623,6 +685,9 @@ void Renderer::LoadBlinnPhongContext() noexcept
   m_ContextManager.AddNewUniformAttribute(m_hBlinnPhong, "mat_spc");
   m_ContextManager.AddNewUniformAttribute(m_hBlinnPhong, "mat_spc_exp");
 
+  m_ContextManager.AddNewUniformAttribute(m_hBlinnPhong, "position_offset");
+  m_ContextManager.AddNewUniformAttribute(m_hBlinnPhong, "position_scale");
+
   const ContextManager::VertexAttribute vaPosition("position", 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), 0);
   const ContextManager::VertexAttribute vaNormal("normal", 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::VertexData), sizeof(vec3));
   const ContextManager::VertexAttribute vaTexCoords("texcoord", 2, GL_FLOAT, GL_FALSE, sizeof(vec2), sizeof(vec3) * 2);
@@ -714,7 +779,8 @@ void Renderer::LoadSkyboxContext() noexcept
   const ContextManager::VertexAttribute vaPosition("position", 4, GL_FLOAT, GL_FALSE, sizeof(vec3), 0u);
   m_ContextManager.AddNewVertexAttribute(m_hSkyboxContext, vaPosition);
 
-  SkyboxMeshID = m_MeshManager.LoadMesh("cube2.obj");
+  SkyboxMesh = m_MeshManager.LoadMesh("cube2.obj");
+  m_MeshManager.GetRegistry()->AddReference(SkyboxMesh);
 
   Log::Trace("Skybox Context loaded.");
 }
@@ -122,7 +122,8 @@ private:
   /// Helper function to render a single game object
   /// </summary>
   /// <param name="gameObject"></param>
-  void RenderGameObject(GameObject& gameObject);
+  /// <param name="activeCamera">Camera the level of detail and meshlets are picked for</param>
+  void RenderGameObject(GameObject& gameObject, Camera& activeCamera);
 
 #pragma region ImGui
 
@@ -215,7 +216,7 @@ private:
   //TODO: Below for testing only
   unsigned LightingBlockPrintID;
   unsigned LightingBlockID;
-  unsigned SkyboxMeshID;
+  MeshHandle SkyboxMesh;
 
   EnvironmentMap envMap;
 
@@ -94,15 +94,16 @@ void SceneManager::transitionScene() noexcept
     m_CurrentScenePtr->OnUnload();
   }
 
+  // Replacing the scene destroys its objects, releasing their meshes. Nothing is
+  // freed until the end of the next frame, so meshes the new scene shares with
+  // the old one are picked up again instead of being reloaded.
   switch (m_NextScene)
   {
   case SceneManager::Scene::None:
   case SceneManager::Scene::SceneDemo:
-    m_CurrentScenePtr.release();
     m_CurrentScenePtr = make_unique<SceneDemo>();
     break;
   case SceneManager::Scene::SceneSingleObject:
-    m_CurrentScenePtr.release();
     m_CurrentScenePtr = make_unique<SceneSingleObject>();
     break;
   case SceneManager::Scene::SceneCount:
@@ -12,7 +12,6 @@
 #include "ImGUIManager.h"
 #include "Colors.h"
 #include "MeshComponent.h"
-#include "AssetLoader.h"
 
 #define AMBFACTOR 0.05f
 #define DIFFFACTOR 0.9f
@@ -26,8 +25,6 @@ SceneDemo::SceneDemo() noexcept :
   m_MainCamera.SetName("Demo Scene Camera");
   Log::Trace("'Demo' Scene Created.");
   ImGui::Manager->SetOnDemoObjectHandler([this] { OnDemoObjectChangeEvent(); });
-  AssetLoader::LoadFBX(("res/models/susanne.fbx"));
-
 }
 
 void SceneDemo::OnLoad() noexcept
@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+// File:    VertexCacheOptimizer.cpp
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Triangle and vertex reordering for the post-transform vertex cache
+//------------------------------------------------------------------------------
+#include "pch.h"
+#include "VertexCacheOptimizer.h"
+
+float VertexCacheOptimizer::CalculateACMR(const vector<Mesh::Triangle>& triangles, const size_t vertexCount,
+  const unsigned cacheSize) noexcept
+{
+  if (triangles.empty())
+    return 0.f;
+
+  // A FIFO only evicts on a miss, so a vertex is still cached while fewer than
+  // cacheSize misses have happened since it was loaded
+  constexpr size_t NotLoaded = std::numeric_limits<size_t>::max();
+  vector<size_t> loadedAt(vertexCount, NotLoaded);
+  size_t misses = 0u;
+
+  const auto access = [&](const unsigned vertex)
+  {
+    if (loadedAt[vertex] == NotLoaded || misses - loadedAt[vertex] >= cacheSize)
+      loadedAt[vertex] = misses++;
+  };
+
+  for (const Mesh::Triangle& tri : triangles)
+  {
+    access(tri.Index1);
+    access(tri.Index2);
+    access(tri.Index3);
+  }
+
+  return static_cast<float>(misses) / static_cast<float>(triangles.size());
+}
+
+vector<unsigned> VertexCacheOptimizer::OptimizeTriangleOrder(const vector<Mesh::Triangle>& triangles,
+  const Mesh::VertexAdjacency& adjacency, const unsigned cacheSize) noexcept
+{
+  const size_t vertexCount = adjacency.Offsets.empty() ? 0u : adjacency.Offsets.size() - 1u;
+  vector<unsigned> order;
+  order.reserve(triangles.size());
+  if (triangles.empty() || vertexCount == 0u)
+    return order;
+
+  // Triangles not yet emitted around each vertex
+  vector<unsigned> liveCount(vertexCount);
+  for (size_t v = 0u; v < vertexCount; ++v)
+    liveCount[v] = adjacency.Offsets[v + 1u] - adjacency.Offsets[v];
+
+  // Time each vertex last entered the cache, the clock advances on every miss.
+  // Starting it past the cache size makes every vertex begin uncached.
+  vector<unsigned> cacheTime(vertexCount, 0u);
+  unsigned clock = cacheSize + 1u;
+
+  vector<bool> isEmitted(triangles.size(), false);
+  vector<unsigned> deadEnds;    // Recently used vertices, to restart from when a fan runs out
+  vector<unsigned> candidates;  // Vertices of the triangles emitted around the current fan
+  size_t scanCursor = 0u;       // Everything before this has no live triangles left
+
+  // Picks where to continue once every triangle around the fan is out
+  const auto skipDeadEnd = [&]() -> size_t
+  {
+    while (!deadEnds.empty())
+    {
+      const unsigned vertex = deadEnds.back();
+      deadEnds.pop_back();
+      if (liveCount[vertex] > 0u)
+        return vertex;
+    }
+    for (; scanCursor < vertexCount; ++scanCursor)
+    {
+      if (liveCount[scanCursor] > 0u)
+        return scanCursor;
+    }
+    return vertexCount;
+  };
+
+  size_t fan = skipDeadEnd();
+  while (fan < vertexCount)
+  {
+    // Emit every remaining triangle around the fan vertex
+    candidates.clear();
+    for (unsigned k = adjacency.Offsets[fan]; k < adjacency.Offsets[fan + 1u]; ++k)
+    {
+      const unsigned t = adjacency.Triangles[k];
+      if (isEmitted[t])
+        continue;
+
+      isEmitted[t] = true;
+      order.push_back(t);
+
+      const Mesh::Triangle& tri = triangles[t];
+      for (const unsigned vertex : { tri.Index1, tri.Index2, tri.Index3 })
+      {
+        deadEnds.push_back(vertex);
+        candidates.push_back(vertex);
+        --liveCount[vertex];
+        if (clock - cacheTime[vertex] > cacheSize)
+          cacheTime[vertex] = clock++;
+      }
+    }
+
+    // Continue from the candidate that has been in the cache longest, as long
+    // as its remaining triangles would still find it there. Fall back on the
+    // dead end stack when none would.
+    size_t next = vertexCount;
+    int bestPriority = -1;
+    for (const unsigned vertex : candidates)
+    {
+      if (liveCount[vertex] == 0u)
+        continue;
+
+      int priority = 0;
+      const unsigned age = clock - cacheTime[vertex];
+      if (age + 2u * liveCount[vertex] <= cacheSize)
+        priority = static_cast<int>(age);
+      if (priority > bestPriority)
+      {
+        bestPriority = priority;
+        next = vertex;
+      }
+    }
+    fan = next < vertexCount ? next : skipDeadEnd();
+  }
+
+  return order;
+}
+
+vector<unsigned> VertexCacheOptimizer::OptimizeVertexFetch(vector<Mesh::Triangle>& triangles, const size_t vertexCount) noexcept
+{
+  vector<unsigned> remap(vertexCount, Error::INVALID_INDEX);
+  unsigned nextVertex = 0u;
+
+  const auto renumber = [&](unsigned& vertex)
+  {
+    if (remap[vertex] == Error::INVALID_INDEX)
+      remap[vertex] = nextVertex++;
+    vertex = remap[vertex];
+  };
+
+  for (Mesh::Triangle& tri : triangles)
+  {
+    renumber(tri.Index1);
+    renumber(tri.Index2);
+    renumber(tri.Index3);
+  }
+
+  // Vertices no triangle uses keep their relative order at the end
+  for (unsigned& index : remap)
+  {
+    if (index == Error::INVALID_INDEX)
+      index = nextVertex++;
+  }
+
+  return remap;
+}
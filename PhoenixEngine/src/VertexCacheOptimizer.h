@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+// File:    VertexCacheOptimizer.h
+// Author:  Ryan Buehler
+// Created: October 18, 2026
+// Desc:    Triangle and vertex reordering for the post-transform vertex cache
+//------------------------------------------------------------------------------
+#pragma once
+#include "Mesh.h"
+
+namespace VertexCacheOptimizer
+{
+  // Entries in the modelled post-transform cache, a conservative size for current GPUs
+  constexpr unsigned CACHE_SIZE = 16u;
+
+  /// <summary>
+  /// Simulates a FIFO post-transform cache over the triangles in draw order
+  /// </summary>
+  /// <param name="triangles">[Const Ref] Triangles in the order they are drawn</param>
+  /// <param name="vertexCount">Number of vertices the triangles index</param>
+  /// <param name="cacheSize">Entries in the simulated cache</param>
+  /// <returns>The average cache miss ratio, vertex shader runs per triangle (0.5 - 3)</returns>
+  float CalculateACMR(const vector<Mesh::Triangle>& triangles, size_t vertexCount, unsigned cacheSize = CACHE_SIZE) noexcept;
+
+  /// <summary>
+  /// Orders the triangles for the post-transform cache with Tipsify (Sander,
+  /// Nehab and Barczak 2007). Linear in the triangle count, and close to the
+  /// much slower greedy optimizers.
+  /// </summary>
+  /// <param name="triangles">[Const Ref] Triangles in their current order</param>
+  /// <param name="adjacency">[Const Ref] Triangles around each vertex, for these triangles</param>
+  /// <param name="cacheSize">Entries in the cache to optimize for</param>
+  /// <returns>The triangle indices in their new order</returns>
+  vector<unsigned> OptimizeTriangleOrder(const vector<Mesh::Triangle>& triangles,
+    const Mesh::VertexAdjacency& adjacency, unsigned cacheSize = CACHE_SIZE) noexcept;
+
+  /// <summary>
+  /// Renumbers the vertices in the order the triangles first use them, so the
+  /// vertex fetch walks the vertex buffer front to back. Unused vertices go last.
+  /// </summary>
+  /// <param name="triangles">[In/Out] Triangles to renumber in place</param>
+  /// <param name="vertexCount">Number of vertices the triangles index</param>
+  /// <returns>The new index of each old vertex</returns>
+  vector<unsigned> OptimizeVertexFetch(vector<Mesh::Triangle>& triangles, size_t vertexCount) noexcept;
+}